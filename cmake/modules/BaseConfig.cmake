@@ -67,6 +67,8 @@ option(DEBUG_LOG "Enable Debug Log" OFF)
 option(ASAN_ENABLED "Build this target with AddressSanitizer" OFF)
 option(BUILD_STATIC_LIBRARY "Build using static libraries" OFF)
 option(SPEED_UP_BUILD_UNITY "Compile using build unity for speed up build" ON)
+set(PACKET_COMPRESSION_BACKEND "zlib" CACHE STRING "Library used to compress outgoing packets: zlib, zlib-ng or libdeflate")
+set_property(CACHE PACKET_COMPRESSION_BACKEND PROPERTY STRINGS zlib zlib-ng libdeflate)
 
 # === ASAN ===
 if(ASAN_ENABLED)
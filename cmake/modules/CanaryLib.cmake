@@ -110,6 +110,20 @@ else()
     target_link_libraries(${PROJECT_NAME}_lib PUBLIC jsoncpp_static Threads::Threads)
 endif (MSVC)
 
+# === Packet compression ===
+if(PACKET_COMPRESSION_BACKEND STREQUAL "libdeflate")
+    find_package(libdeflate CONFIG REQUIRED)
+    target_link_libraries(${PROJECT_NAME}_lib PUBLIC $<IF:$<TARGET_EXISTS:libdeflate::libdeflate_shared>,libdeflate::libdeflate_shared,libdeflate::libdeflate_static>)
+    target_compile_definitions(${PROJECT_NAME}_lib PUBLIC CANARY_COMPRESSION_LIBDEFLATE)
+elseif(PACKET_COMPRESSION_BACKEND STREQUAL "zlib-ng")
+    find_package(zlib-ng CONFIG REQUIRED)
+    target_link_libraries(${PROJECT_NAME}_lib PUBLIC zlib-ng::zlib)
+    target_compile_definitions(${PROJECT_NAME}_lib PUBLIC CANARY_COMPRESSION_ZLIB_NG)
+elseif(NOT PACKET_COMPRESSION_BACKEND STREQUAL "zlib")
+    log_fatal("Unknown PACKET_COMPRESSION_BACKEND: ${PACKET_COMPRESSION_BACKEND}")
+endif()
+log_info("Packet compression: ${PACKET_COMPRESSION_BACKEND}")
+
 # === OpenMP ===
 if(OPTIONS_ENABLE_OPENMP)
     log_option_enabled("openmp")
@@ -0,0 +1,62 @@
+local taskMetrics = TalkAction("/taskmetrics")
+
+function taskMetrics.onSay(player, words, param)
+	-- create log
+	logCommand(player, words, param)
+
+	if param == "reset" then
+		Game.resetTaskMetrics()
+		Game.resetPerfStats()
+		player:sendTextMessage(MESSAGE_ADMINISTRADOR, "Dispatcher task metrics and perf stats were reset.")
+		return true
+	end
+
+	local limit = tonumber(param) or 20
+	Game.dumpTaskMetrics()
+
+	local text = string.format("Top %d dispatcher contexts by run time (ms)\nwait p50/p99/max | run p50/p99/max | total\n", limit)
+	for _, metric in ipairs(Game.getTaskMetrics(limit)) do
+		text = text .. string.format("\n%s x%d\n  %.2f/%.2f/%.2f | %.2f/%.2f/%.2f | %.1f", metric.context, metric.count, metric.waitP50, metric.waitP99, metric.waitMax, metric.runP50, metric.runP99, metric.runMax, metric.runTotal)
+	end
+
+	local stats = Game.getPerfStats()
+	local cache = stats.spectatorsCache
+	text = text .. string.format("\n\nSpectators cache: %d hits, %d misses, %d evictions, %d entries", cache.hits, cache.misses, cache.evictions, cache.entries)
+
+	local pathfinder = stats.pathfinder
+	text = text .. string.format("\nPathfinder: %d requested, %d coalesced, %d superseded, %d completed, %d discarded, %d in flight, %.1f ms searching", pathfinder.requested, pathfinder.coalesced, pathfinder.superseded, pathfinder.completed, pathfinder.discarded, pathfinder.inFlight, pathfinder.searchTime)
+
+	local pool = stats.outputMessagePool
+	text = text .. string.format("\nOutput messages: %d in use, %d high water, %d hits, %d misses, %d retained", pool.inUse, pool.highWater, pool.hits, pool.misses, pool.retained)
+
+	local writes = stats.connectionWrite
+	text = text .. string.format("\nSocket writes: %d writes, %.1f messages and %.0f bytes per write, %d closed for falling behind", writes.writes, writes.messagesPerWrite, writes.bytesPerWrite, writes.overflows)
+
+	local broadcasts = stats.broadcast
+	text = text .. string.format("\nBroadcasts: %d serialized, %d sent, %.1f viewers per serialization", broadcasts.serialized, broadcasts.sent, broadcasts.sentPerSerialized)
+
+	local tileDescriptions = stats.tileDescriptionCache
+	text = text .. string.format("\nTile descriptions: %d cached, %d hits, %d builds, %d uncacheable", tileDescriptions.descriptions, tileDescriptions.hits, tileDescriptions.builds, tileDescriptions.uncacheable)
+
+	local knownCreatures = stats.knownCreatures
+	text = text .. string.format("\nKnown creatures: %d added, %d evictions (%d forced), %.1f checks per eviction", knownCreatures.added, knownCreatures.evictions, knownCreatures.forcedEvictions, knownCreatures.checksPerEviction)
+
+	local decay = stats.decay
+	text = text .. string.format("\nDecay: %d pending, %d decayed in %d ticks, %.1f per tick, %d last tick, %d max", decay.pending, decay.decayed, decay.ticks, decay.decayedPerTick, decay.lastTickDecayed, decay.maxTickDecayed)
+
+	local think = stats.creatureThink
+	text = text .. string.format("\nCreature think: %d rounds, %d moves, %.2f ms jitter\nbucket creatures | cost | run last/avg/max (ms)", think.rounds, think.moves, think.jitter)
+	for index, bucket in ipairs(think.buckets) do
+		text = text .. string.format("\n  %d: %d | %.2f | %.2f/%.2f/%.2f", index, bucket.creatures, bucket.cost, bucket.lastRunTime, bucket.averageRunTime, bucket.maxRunTime)
+	end
+
+	local sectors = stats.sectorActivity
+	text = text .. string.format("\nSectors: %d awake, %d spawns dormant, %d slept, %d woken", sectors.awakeSectors, sectors.sleepers, sectors.slept, sectors.woken)
+
+	player:showTextDialog(2019, text)
+	return true
+end
+
+taskMetrics:separator(" ")
+taskMetrics:groupType("god")
+taskMetrics:register()
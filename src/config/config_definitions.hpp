@@ -38,6 +38,7 @@ enum booleanConfig_t {
 	HOUSE_OWNED_BY_ACCOUNT,
 	CLEAN_PROTECTION_ZONES,
 	ALLOW_BLOCK_SPAWN,
+	TOGGLE_DORMANT_SPAWNS,
 	HOUSE_PURSHASED_SHOW_PRICE,
 	ONLY_INVITED_CAN_MOVE_HOUSE_ITEMS,
 	WEATHER_RAIN,
@@ -45,6 +46,7 @@ enum booleanConfig_t {
 	TOGGLE_FREE_QUEST,
 	ONLY_PREMIUM_ACCOUNT,
 	TOGGLE_MAP_CUSTOM,
+	TOGGLE_MAP_SNAPSHOT,
 	ALL_CONSOLE_LOG,
 	STAMINA_TRAINER,
 	STAMINA_PZ,
@@ -170,6 +172,7 @@ enum integerConfig_t {
 	EXP_FROM_PLAYERS_LEVEL_RANGE,
 	MAX_PACKETS_PER_SECOND,
 	COMPRESSION_LEVEL,
+	COMPRESSION_THRESHOLD,
 	STORE_COIN_PACKET,
 	DAY_KILLS_TO_RED,
 	WEEK_KILLS_TO_RED,
@@ -258,6 +261,7 @@ enum integerConfig_t {
 
 	REWARD_CHEST_MAX_COLLECT_ITEMS,
 	DISCORD_WEBHOOK_DELAY_MS,
+	PATHFINDING_MAX_NODES,
 
 	LAST_INTEGER_CONFIG
 };
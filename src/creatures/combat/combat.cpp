@@ -20,6 +20,9 @@
 #include "items/weapons/weapons.hpp"
 #include "map/spectators.hpp"
 
+// a stack, in case a combat callback starts another area combat on the same thread
+thread_local std::vector<std::unique_ptr<Combat::CombatTargets>> Combat::targetsPool;
+
 int32_t Combat::getLevelFormula(std::shared_ptr<Player> player, const std::shared_ptr<Spell> wheelSpell, const CombatDamage &damage) const {
 	if (!player) {
 		return 0;
@@ -100,7 +103,7 @@ CombatDamage Combat::getCombatDamage(std::shared_ptr<Creature> creature, std::sh
 	return damage;
 }
 
-void Combat::getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::forward_list<std::shared_ptr<Tile>> &list) {
+void Combat::getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::vector<std::shared_ptr<Tile>> &list) {
 	if (targetPos.z >= MAP_MAX_LAYERS) {
 		return;
 	}
@@ -108,8 +111,25 @@ void Combat::getCombatArea(const Position &centerPos, const Position &targetPos,
 	if (area) {
 		area->getList(centerPos, targetPos, list);
 	} else {
-		list.push_front(g_game().map.getOrCreateTile(targetPos));
+		list.emplace_back(g_game().map.getOrCreateTile(targetPos));
+	}
+}
+
+std::unique_ptr<Combat::CombatTargets> Combat::acquireTargets() {
+	if (targetsPool.empty()) {
+		return std::make_unique<CombatTargets>();
 	}
+
+	auto targets = std::move(targetsPool.back());
+	targetsPool.pop_back();
+	return targets;
+}
+
+void Combat::releaseTargets(std::unique_ptr<CombatTargets> targets) {
+	// cleared right away, the pool must not keep tiles or creatures alive
+	targets->tiles.clear();
+	targets->creatures.clear();
+	targetsPool.emplace_back(std::move(targets));
 }
 
 CombatType_t Combat::ConditionToDamageType(ConditionType_t type) {
@@ -991,41 +1011,35 @@ bool Combat::doCombat(std::shared_ptr<Creature> caster, const Position &position
 }
 
 void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin, const Position &pos, const std::unique_ptr<AreaCombat> &area, const CombatParams &params, CombatFunction func, CombatDamage* data) {
-	std::forward_list<std::shared_ptr<Tile>> tileList;
+	auto targets = acquireTargets();
+	auto &tiles = targets->tiles;
 
 	if (caster) {
-		getCombatArea(caster->getPosition(), pos, area, tileList);
+		getCombatArea(caster->getPosition(), pos, area, tiles);
 	} else {
-		getCombatArea(pos, pos, area, tileList);
+		getCombatArea(pos, pos, area, tiles);
 	}
 
-	uint32_t maxX = 0;
-	uint32_t maxY = 0;
-
-	// calculate the max viewable range
-	for (std::shared_ptr<Tile> tile : tileList) {
-		const Position &tilePos = tile->getPosition();
+	int32_t maxX = 0;
+	int32_t maxY = 0;
+	int affected = 0;
 
-		uint32_t diff = Position::getDistanceX(tilePos, pos);
-		if (diff > maxX) {
-			maxX = diff;
-		}
+	// A single pass finds the max viewable range, keeps the tiles the combat can reach and picks who is hit on them
+	size_t reachable = 0;
+	for (size_t i = 0; i < tiles.size(); ++i) {
+		const Position &tilePos = tiles[i]->getPosition();
+		maxX = std::max<int32_t>(maxX, Position::getDistanceX(tilePos, pos));
+		maxY = std::max<int32_t>(maxY, Position::getDistanceY(tilePos, pos));
 
-		diff = Position::getDistanceY(tilePos, pos);
-		if (diff > maxY) {
-			maxY = diff;
+		if (canDoCombat(caster, tiles[i], params.aggressive) != RETURNVALUE_NOERROR) {
+			continue;
 		}
-	}
 
-	const int32_t rangeX = maxX + MAP_MAX_VIEW_PORT_X;
-	const int32_t rangeY = maxY + MAP_MAX_VIEW_PORT_Y;
-
-	int affected = 0;
-	for (std::shared_ptr<Tile> tile : tileList) {
-		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
-			continue;
+		if (i != reachable) {
+			tiles[reachable] = std::move(tiles[i]);
 		}
 
+		const auto &tile = tiles[reachable];
 		if (CreatureVector* creatures = tile->getCreatures()) {
 			const std::shared_ptr<Creature> topCreature = tile->getTopCreature();
 			for (auto &creature : *creatures) {
@@ -1040,11 +1054,21 @@ void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin
 				}
 
 				if (!params.aggressive || (caster != creature && Combat::canDoCombat(caster, creature, params.aggressive) == RETURNVALUE_NOERROR)) {
+					targets->creatures.emplace_back(reachable, creature);
 					affected++;
+
+					if (params.targetCasterOrTopMost) {
+						break;
+					}
 				}
 			}
 		}
+		++reachable;
 	}
+	tiles.resize(reachable);
+
+	const int32_t rangeX = maxX + MAP_MAX_VIEW_PORT_X;
+	const int32_t rangeY = maxY + MAP_MAX_VIEW_PORT_Y;
 
 	CombatDamage tmpDamage;
 	if (data) {
@@ -1076,42 +1100,28 @@ void Combat::CombatFunc(std::shared_ptr<Creature> caster, const Position &origin
 	uint8_t beamAffectedCurrent = 0;
 
 	tmpDamage.affected = affected;
-	for (std::shared_ptr<Tile> tile : tileList) {
-		if (canDoCombat(caster, tile, params.aggressive) != RETURNVALUE_NOERROR) {
-			continue;
-		}
-
-		if (CreatureVector* creatures = tile->getCreatures()) {
-			const std::shared_ptr<Creature> topCreature = tile->getTopCreature();
-			for (auto &creature : *creatures) {
-				if (params.targetCasterOrTopMost) {
-					if (caster && caster->getTile() == tile) {
-						if (creature != caster) {
-							continue;
-						}
-					} else if (creature != topCreature) {
-						continue;
-					}
-				}
-
-				if (!params.aggressive || (caster != creature && Combat::canDoCombat(caster, creature, params.aggressive) == RETURNVALUE_NOERROR)) {
-					// Wheel of destiny update beam mastery damage
-					if (casterPlayer) {
-						casterPlayer->wheel()->updateBeamMasteryDamage(tmpDamage, beamAffectedTotal, beamAffectedCurrent);
-					}
-					func(caster, creature, params, &tmpDamage);
-					if (params.targetCallback) {
-						params.targetCallback->onTargetCombat(caster, creature);
-					}
+	auto target = targets->creatures.cbegin();
+	for (size_t i = 0; i < tiles.size(); ++i) {
+		const auto &tile = tiles[i];
+		for (; target != targets->creatures.cend() && target->first == i; ++target) {
+			const auto &creature = target->second;
+			// an earlier hit may have killed or moved it
+			if (creature->isRemoved() || creature->getTile() != tile) {
+				continue;
+			}
 
-					if (params.targetCasterOrTopMost) {
-						break;
-					}
-				}
+			// Wheel of destiny update beam mastery damage
+			if (casterPlayer) {
+				casterPlayer->wheel()->updateBeamMasteryDamage(tmpDamage, beamAffectedTotal, beamAffectedCurrent);
+			}
+			func(caster, creature, params, &tmpDamage);
+			if (params.targetCallback) {
+				params.targetCallback->onTargetCombat(caster, creature);
 			}
 		}
 		combatTileEffects(spectators.data(), caster, tile, params);
 	}
+	releaseTargets(std::move(targets));
 
 	// Wheel of destiny update beam mastery damage
 	if (casterPlayer) {
@@ -1699,10 +1709,13 @@ bool ChainPickerCallback::onChainCombat(std::shared_ptr<Creature> creature, std:
 
 void AreaCombat::clear() {
 	std::ranges::fill(areas, nullptr);
+	for (auto &directionOffsets : offsets) {
+		directionOffsets.clear();
+	}
 }
 
-AreaCombat::AreaCombat(const AreaCombat &rhs) {
-	hasExtArea = rhs.hasExtArea;
+AreaCombat::AreaCombat(const AreaCombat &rhs) :
+	offsets(rhs.offsets), hasExtArea(rhs.hasExtArea) {
 	for (uint_fast8_t i = 0; i <= Direction::DIRECTION_LAST; ++i) {
 		if (const auto &area = rhs.areas[i]) {
 			areas[i] = area->clone();
@@ -1710,26 +1723,38 @@ AreaCombat::AreaCombat(const AreaCombat &rhs) {
 	}
 }
 
-void AreaCombat::getList(const Position &centerPos, const Position &targetPos, std::forward_list<std::shared_ptr<Tile>> &list) const {
-	const std::unique_ptr<MatrixArea> &area = getArea(centerPos, targetPos);
-	if (!area) {
-		return;
+void AreaCombat::getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list) const {
+	for (const Offset &offset : getOffsets(centerPos, targetPos)) {
+		Position tmpPos(targetPos.x + offset.x, targetPos.y + offset.y, targetPos.z);
+		if (g_game().isSightClear(targetPos, tmpPos, true)) {
+			list.emplace_back(g_game().map.getOrCreateTile(tmpPos));
+		}
 	}
+}
 
-	uint32_t centerY, centerX;
-	area->getCenter(centerY, centerX);
-
-	Position tmpPos(targetPos.x - centerX, targetPos.y - centerY, targetPos.z);
-	uint32_t cols = area->getCols();
-	for (uint32_t y = 0, rows = area->getRows(); y < rows; ++y) {
-		for (uint32_t x = 0; x < cols; ++x) {
-			if (area->getValue(y, x) != 0 && g_game().isSightClear(targetPos, tmpPos, true)) {
-				list.push_front(g_game().map.getOrCreateTile(tmpPos));
+void AreaCombat::compileOffsets() {
+	for (uint_fast8_t i = 0; i <= Direction::DIRECTION_LAST; ++i) {
+		auto &directionOffsets = offsets[i];
+		directionOffsets.clear();
+
+		const auto &area = areas[i];
+		if (!area) {
+			continue;
+		}
+
+		uint32_t centerY, centerX;
+		area->getCenter(centerY, centerX);
+
+		// last cell first, the order the tiles of an area have always been hit in
+		for (uint32_t y = area->getRows(); y-- > 0;) {
+			const bool* row = (*area)[y];
+			for (uint32_t x = area->getCols(); x-- > 0;) {
+				if (row[x]) {
+					directionOffsets.push_back({ static_cast<int16_t>(static_cast<int32_t>(x) - static_cast<int32_t>(centerX)), static_cast<int16_t>(static_cast<int32_t>(y) - static_cast<int32_t>(centerY)) });
+				}
 			}
-			tmpPos.x++;
 		}
-		tmpPos.x -= cols;
-		tmpPos.y++;
+		directionOffsets.shrink_to_fit();
 	}
 }
 
@@ -1864,6 +1889,7 @@ void AreaCombat::setupArea(const std::list<uint32_t> &list, uint32_t rows) {
 	areas[DIRECTION_SOUTH] = std::move(southArea);
 	areas[DIRECTION_EAST] = std::move(eastArea);
 	areas[DIRECTION_WEST] = std::move(westArea);
+	compileOffsets();
 }
 
 void AreaCombat::setupArea(int32_t length, int32_t spread) {
@@ -1962,6 +1988,7 @@ void AreaCombat::setupExtArea(const std::list<uint32_t> &list, uint32_t rows) {
 	areas[DIRECTION_SOUTHWEST] = std::move(swArea);
 	areas[DIRECTION_NORTHEAST] = std::move(neArea);
 	areas[DIRECTION_SOUTHEAST] = std::move(seArea);
+	compileOffsets();
 }
 
 //**********************************************************//
@@ -99,44 +99,18 @@ struct CombatParams {
 
 using CombatFunction = std::function<void(std::shared_ptr<Creature>, std::shared_ptr<Creature>, const CombatParams &, CombatDamage*)>;
 
+/**
+ * A rows x cols grid of cells, stored in a single block so a row is a slice of it.
+ * Only used while an area is built, combats read the offsets AreaCombat compiles from it.
+ */
 class MatrixArea {
 public:
 	MatrixArea(uint32_t initRows, uint32_t initCols) :
-		centerX(0), centerY(0), rows(initRows), cols(initCols) {
-		data_ = new bool*[rows];
-
-		for (uint32_t row = 0; row < rows; ++row) {
-			data_[row] = new bool[cols];
-
-			for (uint32_t col = 0; col < cols; ++col) {
-				data_[row][col] = 0;
-			}
-		}
-	}
-
-	MatrixArea(const MatrixArea &rhs) {
-		centerX = rhs.centerX;
-		centerY = rhs.centerY;
-		rows = rhs.rows;
-		cols = rhs.cols;
-
-		data_ = new bool*[rows];
+		centerX(0), centerY(0), rows(initRows), cols(initCols), data_(std::make_unique<bool[]>(static_cast<size_t>(initRows) * initCols)) { }
 
-		for (uint32_t row = 0; row < rows; ++row) {
-			data_[row] = new bool[cols];
-
-			for (uint32_t col = 0; col < cols; ++col) {
-				data_[row][col] = rhs.data_[row][col];
-			}
-		}
-	}
-
-	~MatrixArea() {
-		for (uint32_t row = 0; row < rows; ++row) {
-			delete[] data_[row];
-		}
-
-		delete[] data_;
+	MatrixArea(const MatrixArea &rhs) :
+		centerX(rhs.centerX), centerY(rhs.centerY), rows(rhs.rows), cols(rhs.cols), data_(std::make_unique<bool[]>(static_cast<size_t>(rhs.rows) * rhs.cols)) {
+		std::copy_n(rhs.data_.get(), static_cast<size_t>(rows) * cols, data_.get());
 	}
 
 	std::unique_ptr<MatrixArea> clone() const {
@@ -148,14 +122,14 @@ public:
 
 	void setValue(uint32_t row, uint32_t col, bool value) {
 		if (row < rows && col < cols) {
-			data_[row][col] = value;
+			data_[static_cast<size_t>(row) * cols + col] = value;
 		} else {
 			g_logger().error("[{}] Access exceeds the upper limit of memory block");
 			throw std::out_of_range("Access exceeds the upper limit of memory block");
 		}
 	}
 	bool getValue(uint32_t row, uint32_t col) const {
-		return data_[row][col];
+		return data_[static_cast<size_t>(row) * cols + col];
 	}
 
 	void setCenter(uint32_t y, uint32_t x) {
@@ -175,10 +149,10 @@ public:
 	}
 
 	const bool* operator[](uint32_t i) const {
-		return data_[i];
+		return data_.get() + static_cast<size_t>(i) * cols;
 	}
 	bool* operator[](uint32_t i) {
-		return data_[i];
+		return data_.get() + static_cast<size_t>(i) * cols;
 	}
 
 private:
@@ -187,7 +161,7 @@ private:
 
 	uint32_t rows;
 	uint32_t cols;
-	bool** data_;
+	std::unique_ptr<bool[]> data_;
 };
 
 class AreaCombat {
@@ -202,7 +176,20 @@ public:
 	// non-assignable
 	AreaCombat &operator=(const AreaCombat &) = delete;
 
-	void getList(const Position &centerPos, const Position &targetPos, std::forward_list<std::shared_ptr<Tile>> &list) const;
+	// Offset from the target of every tile the area covers
+	struct Offset {
+		int16_t x;
+		int16_t y;
+	};
+
+	/**
+	 * Appends the tiles the area covers around targetPos, for a cast from centerPos, that
+	 * the target can see. They are taken from the offsets compiled when the area was set up.
+	 */
+	void getList(const Position &centerPos, const Position &targetPos, std::vector<std::shared_ptr<Tile>> &list) const;
+	const std::vector<Offset> &getOffsets(const Position &centerPos, const Position &targetPos) const {
+		return offsets[getDirection(centerPos, targetPos)];
+	}
 
 	void setupArea(const std::list<uint32_t> &list, uint32_t rows);
 	void setupArea(int32_t length, int32_t spread);
@@ -217,8 +204,10 @@ public:
 private:
 	std::unique_ptr<MatrixArea> createArea(const std::list<uint32_t> &list, uint32_t rows);
 	void copyArea(const std::unique_ptr<MatrixArea> &input, const std::unique_ptr<MatrixArea> &output, MatrixOperation_t op) const;
+	// Rebuilds the offsets of every direction from the areas
+	void compileOffsets();
 
-	const std::unique_ptr<MatrixArea> &getArea(const Position &centerPos, const Position &targetPos) const {
+	Direction getDirection(const Position &centerPos, const Position &targetPos) const {
 		int32_t dx = Position::getOffsetX(targetPos, centerPos);
 		int32_t dy = Position::getOffsetY(targetPos, centerPos);
 
@@ -245,10 +234,11 @@ private:
 			}
 		}
 
-		return areas[dir];
+		return dir;
 	}
 
 	std::array<std::unique_ptr<MatrixArea>, Direction::DIRECTION_LAST + 1> areas {};
+	std::array<std::vector<Offset>, Direction::DIRECTION_LAST + 1> offsets {};
 	bool hasExtArea = false;
 };
 
@@ -274,7 +264,7 @@ public:
 	static void doCombatDispel(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> target, const CombatParams &params);
 	static void doCombatDispel(std::shared_ptr<Creature> caster, const Position &position, const std::unique_ptr<AreaCombat> &area, const CombatParams &params);
 
-	static void getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::forward_list<std::shared_ptr<Tile>> &list);
+	static void getCombatArea(const Position &centerPos, const Position &targetPos, const std::unique_ptr<AreaCombat> &area, std::vector<std::shared_ptr<Tile>> &list);
 
 	static bool isInPvpZone(std::shared_ptr<Creature> attacker, std::shared_ptr<Creature> target);
 	static bool isProtected(std::shared_ptr<Player> attacker, std::shared_ptr<Player> target);
@@ -329,6 +319,18 @@ public:
 	void setRuneSpellName(const std::string &value);
 
 private:
+	// What an area combat hits, borrowed from a per-thread pool so a combat does not allocate
+	struct CombatTargets {
+		std::vector<std::shared_ptr<Tile>> tiles;
+		// index in tiles of the tile each creature is hit on, in the order they are hit
+		std::vector<std::pair<size_t, std::shared_ptr<Creature>>> creatures;
+	};
+
+	static thread_local std::vector<std::unique_ptr<CombatTargets>> targetsPool;
+
+	static std::unique_ptr<CombatTargets> acquireTargets();
+	static void releaseTargets(std::unique_ptr<CombatTargets> targets);
+
 	static void doChainEffect(const Position &origin, const Position &pos, uint8_t effect);
 	static std::vector<std::pair<Position, std::vector<uint32_t>>> pickChainTargets(std::shared_ptr<Creature> caster, const CombatParams &params, uint8_t chainDistance, uint8_t maxTargets, bool aggressive, bool backtracking, std::shared_ptr<Creature> initialTarget = nullptr);
 	static bool isValidChainTarget(std::shared_ptr<Creature> caster, std::shared_ptr<Creature> currentTarget, std::shared_ptr<Creature> potentialTarget, const CombatParams &params, bool aggressive);
@@ -16,6 +16,7 @@
 #include "creatures/monsters/monster.hpp"
 #include "game/zones/zone.hpp"
 #include "map/spectators.hpp"
+#include "map/utils/pathfinder.hpp"
 
 double Creature::speedA = 857.36;
 double Creature::speedB = 261.29;
@@ -962,6 +963,12 @@ void Creature::getPathSearchParams(const std::shared_ptr<Creature> &, FindPathPa
 }
 
 void Creature::goToFollowCreature_async(std::function<void()> &&onComplete) {
+	if (useCacheMap()) {
+		// only the walkability snapshot is taken here, the search runs on the pathfinder service
+		updateFollowPath(std::move(onComplete));
+		return;
+	}
+
 	if (pathfinderRunning.load()) {
 		return;
 	}
@@ -978,8 +985,19 @@ void Creature::goToFollowCreature_async(std::function<void()> &&onComplete) {
 }
 
 void Creature::goToFollowCreature() {
+	updateFollowPath(nullptr);
+}
+
+void Creature::updateFollowPath(std::function<void()> &&onComplete) {
+	const auto complete = [&onComplete] {
+		if (onComplete) {
+			g_dispatcher().context().addEvent(std::move(onComplete));
+		}
+	};
+
 	const auto &followCreature = getFollowCreature();
 	if (!followCreature) {
+		complete();
 		return;
 	}
 
@@ -987,6 +1005,7 @@ void Creature::goToFollowCreature() {
 
 	if (isSummon() && !monster->isFamiliar() && !canFollowMaster()) {
 		listWalkDir.clear();
+		complete();
 		return;
 	}
 
@@ -1011,6 +1030,11 @@ void Creature::goToFollowCreature() {
 	}
 
 	if (listDir.empty()) {
+		if (useCacheMap() && fpp.maxSearchDist != 0) {
+			g_pathfinder().requestFollowPath(getCreature(), followCreature, fpp, executeOnFollow, std::move(onComplete));
+			return;
+		}
+
 		hasFollowPath = getPathTo(getFollowCreature()->getPosition(), listDir, fpp);
 	}
 
@@ -1019,6 +1043,22 @@ void Creature::goToFollowCreature() {
 	if (executeOnFollow) {
 		onFollowCreatureComplete(getFollowCreature());
 	}
+	complete();
+}
+
+bool Creature::onFollowPathFound(uint32_t targetId, const Position &targetPos, bool found, stdext::arraylist<Direction> &listDir, bool executeOnFollow) {
+	const auto &followCreature = getFollowCreature();
+	if (!followCreature || followCreature->getID() != targetId || followCreature->getPosition() != targetPos) {
+		return false;
+	}
+
+	hasFollowPath = found;
+	startAutoWalk(listDir.data());
+
+	if (executeOnFollow) {
+		onFollowCreatureComplete(followCreature);
+	}
+	return true;
 }
 
 bool Creature::canFollowMaster() {
@@ -1251,6 +1291,18 @@ bool Creature::setMaster(std::shared_ptr<Creature> newMaster, bool reloadCreatur
 	if (oldMaster) {
 		oldMaster->m_summons.erase(self);
 	}
+
+	// who it fights and who it sides with follow the master, a summon not placed yet finds them when it appears
+	if (const auto &monster = getMonster(); monster && !isRemoved() && getTile()) {
+		monster->rebuildTargetList();
+
+		// the monsters around sorted it when it came into view, and will not look at it again while it stays there
+		for (const auto &spectator : Spectators().find<Creature>(position, true).filter<Monster>()) {
+			if (spectator != self) {
+				spectator->getMonster()->onCreatureChangedSides(self);
+			}
+		}
+	}
 	return true;
 }
 
@@ -1622,6 +1674,10 @@ bool FrozenPathingConditionCall::operator()(const Position &startPos, const Posi
 		return false;
 	}
 
+	return isBestMatch(testPos, fpp, bestMatchDist);
+}
+
+bool FrozenPathingConditionCall::isBestMatch(const Position &testPos, const FindPathParams &fpp, int32_t &bestMatchDist) const {
 	int32_t testDist = std::max<int32_t>(Position::getDistanceX(targetPos, testPos), Position::getDistanceY(targetPos, testPos));
 	if (fpp.maxTargetDist == 1) {
 		if (testDist < fpp.minTargetDist || testDist > fpp.maxTargetDist) {
@@ -41,7 +41,22 @@ public:
 
 	bool operator()(const Position &startPos, const Position &testPos, const FindPathParams &fpp, int32_t &bestMatchDist) const;
 
+	// Same as above, with the line of sight answered by isSightClear(fromPos, toPos) instead of the live map
+	template <typename SightCheck>
+	bool operator()(const Position &startPos, const Position &testPos, const FindPathParams &fpp, int32_t &bestMatchDist, const SightCheck &isSightClear) const {
+		if (!isInRange(startPos, testPos, fpp)) {
+			return false;
+		}
+
+		if (fpp.clearSight && !isSightClear(testPos, targetPos)) {
+			return false;
+		}
+
+		return isBestMatch(testPos, fpp, bestMatchDist);
+	}
+
 	bool isInRange(const Position &startPos, const Position &testPos, const FindPathParams &fpp) const;
+	bool isBestMatch(const Position &testPos, const FindPathParams &fpp, int32_t &bestMatchDist) const;
 
 	Position getTargetPos() const {
 		return targetPos;
@@ -274,8 +289,14 @@ public:
 	void addEventWalk(bool firstStep = false);
 	void stopEventWalk();
 
+	// onComplete runs once the path is applied, for a search on the pathfinder service that is when its result is back
 	void goToFollowCreature_async(std::function<void()> &&onComplete = nullptr);
 	virtual void goToFollowCreature();
+	/**
+	 * Result of a follow path searched by the pathfinder service for the target targetId at targetPos.
+	 * It is not applied, and false is returned, when the creature follows someone else or the target moved meanwhile.
+	 */
+	bool onFollowPathFound(uint32_t targetId, const Position &targetPos, bool found, stdext::arraylist<Direction> &listDir, bool executeOnFollow);
 
 	// walk events
 	virtual void onWalk(Direction &dir);
@@ -696,6 +717,8 @@ protected:
 	uint32_t blockCount = 0;
 	uint32_t blockTicks = 0;
 	uint32_t lastStepCost = 1;
+	// in the think scheduler of the game while creatureCheck is set
+	uint32_t thinkHandle = std::numeric_limits<uint32_t>::max();
 	uint16_t baseSpeed = 110;
 	uint32_t mana = 0;
 	int32_t varSpeed = 0;
@@ -727,7 +750,6 @@ protected:
 	bool isMapLoaded = false;
 	bool isUpdatingPath = false;
 	bool creatureCheck = false;
-	bool inCheckCreaturesVector = false;
 	bool skillLoss = true;
 	bool lootDrop = true;
 	bool cancelNextWalk = false;
@@ -781,5 +803,7 @@ private:
 	bool canFollowMaster();
 	bool isLostSummon();
 	void handleLostSummon(bool teleportSummons);
+	// What goToFollowCreature does, handing onComplete to the pathfinder service when the search runs there
+	void updateFollowPath(std::function<void()> &&onComplete);
 	void executeAsyncPathTo(bool executeOnFollow, FindPathParams &fpp, std::function<void()> &&onComplete);
 };
@@ -1460,6 +1460,8 @@ struct FindPathParams {
 	int32_t maxSearchDist = 0;
 	int32_t minTargetDist = -1;
 	int32_t maxTargetDist = -1;
+
+	bool operator==(const FindPathParams &) const = default;
 };
 
 struct RecentDeathEntry {
@@ -212,7 +212,7 @@ void Monster::onCreatureMove(const std::shared_ptr<Creature> &creature, const st
 	}
 
 	if (creature.get() == this) {
-		updateTargetList();
+		updateTargetList(oldPos);
 		updateIdleStatus();
 	} else {
 		bool canSeeNewPos = canSee(newPos);
@@ -331,6 +331,65 @@ void Monster::removeTarget(std::shared_ptr<Creature> creature) {
 }
 
 void Monster::updateTargetList() {
+	pruneTargetList();
+
+	for (const auto &spectator : Spectators().find<Creature>(position, true)) {
+		if (spectator.get() != this && canSee(spectator->getPosition())) {
+			onCreatureFound(spectator);
+		}
+	}
+}
+
+void Monster::updateTargetList(const Position &oldPos) {
+	const int32_t offsetX = position.x - oldPos.x;
+	const int32_t offsetY = position.y - oldPos.y;
+	if (oldPos.z != position.z || std::abs(offsetX) > 1 || std::abs(offsetY) > 1) {
+		updateTargetList();
+		return;
+	}
+
+	pruneTargetList();
+
+	// What was in view before was already found, or announced itself when it came into view,
+	// so only the row and column of tiles the step uncovered can hold new creatures
+	Spectators uncovered;
+	if (offsetX != 0) {
+		const int32_t edgeX = offsetX * MAP_MAX_VIEW_PORT_X;
+		uncovered.findArea<Creature>(position, true, edgeX, edgeX, -MAP_MAX_VIEW_PORT_Y, MAP_MAX_VIEW_PORT_Y);
+	}
+	if (offsetY != 0) {
+		const int32_t edgeY = offsetY * MAP_MAX_VIEW_PORT_Y;
+		uncovered.findArea<Creature>(position, true, -MAP_MAX_VIEW_PORT_X, MAP_MAX_VIEW_PORT_X, edgeY, edgeY);
+	}
+
+	for (const auto &spectator : uncovered) {
+		if (spectator.get() != this && canSee(spectator->getPosition())) {
+			onCreatureFound(spectator);
+		}
+	}
+}
+
+void Monster::rebuildTargetList() {
+	clearTargetList();
+	clearFriendList();
+	totalPlayersOnScreen = 0;
+
+	// not through onCreatureFound, the idle status is not updated for every creature while it changes
+	for (const auto &spectator : Spectators().find<Creature>(position, true)) {
+		if (spectator.get() == this || !canSee(spectator->getPosition())) {
+			continue;
+		}
+
+		if (isFriend(spectator)) {
+			addFriend(spectator);
+		}
+		if (isOpponent(spectator)) {
+			addTarget(spectator);
+		}
+	}
+}
+
+void Monster::pruneTargetList() {
 	auto friendIterator = friendList.begin();
 	while (friendIterator != friendList.end()) {
 		auto creature = (*friendIterator).second.lock();
@@ -360,12 +419,6 @@ void Monster::updateTargetList() {
 			targetIterator = targetIDList.erase(targetIterator);
 		}
 	}
-
-	for (const auto &spectator : Spectators().find<Creature>(position, true)) {
-		if (spectator.get() != this && canSee(spectator->getPosition())) {
-			onCreatureFound(spectator);
-		}
-	}
 }
 
 void Monster::clearTargetList() {
@@ -389,6 +442,15 @@ void Monster::onCreatureFound(std::shared_ptr<Creature> creature, bool pushFront
 	updateIdleStatus();
 }
 
+void Monster::onCreatureChangedSides(const std::shared_ptr<Creature> &creature) {
+	removeFriend(creature);
+	removeTarget(creature);
+
+	if (canSee(creature->getPosition())) {
+		onCreatureFound(creature);
+	}
+}
+
 void Monster::onCreatureEnter(std::shared_ptr<Creature> creature) {
 	onCreatureFound(creature, true);
 }
@@ -686,15 +748,20 @@ void Monster::setIdle(bool idle) {
 		return;
 	}
 
+	const bool wasIdle = isIdle;
 	isIdle = idle;
 
 	if (!isIdle) {
+		// the lists were cleared when it went idle, and what stayed in view will not come into view again
+		if (wasIdle) {
+			rebuildTargetList();
+		}
 		g_game().addCreatureCheck(static_self_cast<Monster>());
 	} else {
 		onIdleStatus();
 		clearTargetList();
 		clearFriendList();
-		Game::removeCreatureCheck(static_self_cast<Monster>());
+		g_game().removeCreatureCheck(static_self_cast<Monster>());
 	}
 }
 
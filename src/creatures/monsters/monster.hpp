@@ -273,6 +273,12 @@ public:
 	// Hazard end
 
 	void updateTargetList();
+	// Same as updateTargetList after a step from oldPos, only searching what the step brought into view
+	void updateTargetList(const Position &oldPos);
+	// Forgets both lists and finds everything in view again, for when who it fights or sides with may have changed
+	void rebuildTargetList();
+	// Sorts a creature in view into the friends and targets again, for when its master changed
+	void onCreatureChangedSides(const std::shared_ptr<Creature> &creature);
 	void clearTargetList();
 	void clearFriendList();
 
@@ -387,6 +393,8 @@ private:
 	void onCreatureEnter(std::shared_ptr<Creature> creature);
 	void onCreatureLeave(std::shared_ptr<Creature> creature);
 	void onCreatureFound(std::shared_ptr<Creature> creature, bool pushFront = false);
+	// Drops the friends and targets that are gone or out of view
+	void pruneTargetList();
 
 	void updateLookDirection();
 
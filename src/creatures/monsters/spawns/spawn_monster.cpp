@@ -144,7 +144,8 @@ bool SpawnsMonster::isInZone(const Position &centerPos, int32_t radius, const Po
 }
 
 void SpawnMonster::startSpawnMonsterCheck() {
-	if (checkSpawnMonsterEvent == 0) {
+	// a dormant spawn is checked once a player comes close
+	if (checkSpawnMonsterEvent == 0 && !dormant) {
 		checkSpawnMonsterEvent = g_dispatcher().scheduleEvent(getInterval(), std::bind(&SpawnMonster::checkSpawnMonster, this), "SpawnMonster::checkSpawnMonster");
 	}
 }
@@ -205,8 +206,20 @@ void SpawnMonster::startup() {
 void SpawnMonster::checkSpawnMonster() {
 	checkSpawnMonsterEvent = 0;
 
+	// the dead are counted before it can go dormant, so their interval runs while it sleeps and not from the wake up
 	cleanup();
 
+	// Nobody is around to see any of its spawn points, so it sleeps until a player comes close to one and then
+	// catches up at once. A spawn without a radius can place its monsters anywhere and never sleeps.
+	if (g_configManager().getBoolean(TOGGLE_DORMANT_SPAWNS) && radius >= 0 && g_game().map.sectorActivity.isDormant(centerPos, radius)) {
+		dormant = true;
+		g_game().map.sectorActivity.sleep(centerPos, radius, this, [this] {
+			dormant = false;
+			checkSpawnMonsterEvent = g_dispatcher().scheduleEvent(SCHEDULER_MINTICKS, std::bind(&SpawnMonster::checkSpawnMonster, this), "SpawnMonster::checkSpawnMonster");
+		});
+		return;
+	}
+
 	uint32_t spawnMonsterCount = 0;
 
 	for (auto &it : spawnMonsterMap) {
@@ -317,4 +330,9 @@ void SpawnMonster::stopEvent() {
 		g_dispatcher().stopEvent(checkSpawnMonsterEvent);
 		checkSpawnMonsterEvent = 0;
 	}
+
+	if (dormant) {
+		g_game().map.sectorActivity.cancel(this);
+		dormant = false;
+	}
 }
@@ -67,6 +67,8 @@ private:
 
 	uint32_t interval = 30000;
 	uint32_t checkSpawnMonsterEvent = 0;
+	// sleeping in the map sector activity instead of checking
+	bool dormant = false;
 
 	static bool findPlayer(const Position &pos);
 	bool spawnMonster(uint32_t spawnMonsterId, const std::shared_ptr<MonsterType> monsterType, const Position &pos, Direction dir, bool startup = false);
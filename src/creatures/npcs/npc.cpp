@@ -141,7 +141,7 @@ void Npc::onCreatureMove(const std::shared_ptr<Creature> &creature, const std::s
 
 void Npc::manageIdle() {
 	if (creatureCheck && playerSpectators.empty()) {
-		Game::removeCreatureCheck(static_self_cast<Npc>());
+		g_game().removeCreatureCheck(static_self_cast<Npc>());
 	} else if (!creatureCheck) {
 		g_game().addCreatureCheck(static_self_cast<Npc>());
 	}
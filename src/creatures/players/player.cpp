@@ -2819,7 +2819,7 @@ void Player::despawn() {
 	g_game().playerFollowCreature(static_self_cast<Player>()->getID(), 0);
 
 	// remove check
-	Game::removeCreatureCheck(static_self_cast<Player>());
+	g_game().removeCreatureCheck(static_self_cast<Player>());
 
 	// remove from map
 	std::shared_ptr<Tile> tile = getTile();
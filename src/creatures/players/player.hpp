@@ -36,6 +36,7 @@
 
 class House;
 class NetworkMessage;
+class BroadcastMessage;
 class Weapon;
 class ProtocolGame;
 class Party;
@@ -1351,6 +1352,12 @@ public:
 			client->removeMagicEffect(pos, type);
 		}
 	}
+	// the viewer-independent packets, see BroadcastMessage
+	void sendBroadcast(BroadcastMessage &message) const {
+		if (client) {
+			client->sendBroadcast(message);
+		}
+	}
 	void sendPing();
 	void sendPingBack() const {
 		if (client) {
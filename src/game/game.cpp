@@ -39,6 +39,7 @@
 #include "protobuf/appearances.pb.h"
 #include "server/network/protocol/protocollogin.hpp"
 #include "server/network/protocol/protocolstatus.hpp"
+#include "server/network/message/broadcastmessage.hpp"
 #include "map/spectators.hpp"
 
 #include "kv/kv.hpp"
@@ -185,8 +186,7 @@ Game::~Game() = default;
 
 void Game::resetMonsters() const {
 	for (const auto &[monsterId, monster] : getMonsters()) {
-		monster->clearTargetList();
-		monster->clearFriendList();
+		monster->rebuildTargetList();
 	}
 }
 
@@ -5727,10 +5727,13 @@ bool Game::internalCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses
 	}
 
 	// Send to client
+	BroadcastMessage message([&creature, type, &text, pos](NetworkMessage &msg, bool oldProtocol) {
+		ProtocolGame::AddCreatureSay(msg, creature, type, text, pos, oldProtocol);
+	});
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
 			if (!ghostMode || tmpPlayer->canSeeCreature(creature)) {
-				tmpPlayer->sendCreatureSay(creature, type, text, pos);
+				tmpPlayer->sendBroadcast(message);
 			}
 		}
 	}
@@ -5769,51 +5772,39 @@ void Game::checkCreatureAttack(uint32_t creatureId) {
 }
 
 void Game::addCreatureCheck(const std::shared_ptr<Creature> &creature) {
-	creature->creatureCheck = true;
-
-	if (creature->inCheckCreaturesVector) {
-		// already in a vector
+	if (creature->creatureCheck) {
 		return;
 	}
 
-	creature->inCheckCreaturesVector = true;
-	checkCreatureLists[uniform_random(0, EVENT_CREATURECOUNT - 1)].emplace_back(creature);
+	creature->creatureCheck = true;
+	creature->thinkHandle = creatureThinkScheduler.add(creature);
 }
 
 void Game::removeCreatureCheck(const std::shared_ptr<Creature> &creature) {
-	if (creature->inCheckCreaturesVector) {
-		creature->creatureCheck = false;
+	if (!creature->creatureCheck) {
+		return;
 	}
+
+	// idle creatures leave the scheduler right away, they are not visited until they are added again
+	creature->creatureCheck = false;
+	creatureThinkScheduler.remove(creature->thinkHandle);
+	creature->thinkHandle = std::numeric_limits<uint32_t>::max();
 }
 
 void Game::checkCreatures() {
-	static size_t index = 0;
-
-	auto &checkCreatureList = checkCreatureLists[index];
-	size_t it = 0, end = checkCreatureList.size();
-	while (it < end) {
-		const auto &creature = checkCreatureList[it];
-		if (creature && creature->creatureCheck) {
-			if (creature->getHealth() > 0) {
-				creature->onThink(EVENT_CREATURE_THINK_INTERVAL);
-				creature->onAttacking(EVENT_CREATURE_THINK_INTERVAL);
-				creature->executeConditions(EVENT_CREATURE_THINK_INTERVAL);
-			} else {
-				afterCreatureZoneChange(creature, creature->getZones(), {});
-				creature->onDeath();
-			}
-			++it;
+	creatureThinkScheduler.runNext([this](const std::shared_ptr<Creature> &creature, uint32_t checks) {
+		if (creature->getHealth() > 0) {
+			// a whole round unless the scheduler moved it to another bucket since its last think
+			const int32_t interval = static_cast<int32_t>(checks) * EVENT_CHECK_CREATURE_INTERVAL;
+			creature->onThink(interval);
+			creature->onAttacking(interval);
+			creature->executeConditions(interval);
 		} else {
-			creature->inCheckCreaturesVector = false;
-
-			checkCreatureList[it] = checkCreatureList.back();
-			checkCreatureList.pop_back();
-			--end;
+			afterCreatureZoneChange(creature, creature->getZones(), {});
+			creature->onDeath();
 		}
-	}
+	});
 	cleanup();
-
-	index = (index + 1) % EVENT_CREATURECOUNT;
 }
 
 void Game::changeSpeed(std::shared_ptr<Creature> creature, int32_t varSpeedDelta) {
@@ -7257,9 +7248,16 @@ void Game::addCreatureHealth(const CreatureVector &spectators, std::shared_ptr<C
 			}
 		}
 	}
+	if (target->isHealthHidden()) {
+		return;
+	}
+
+	BroadcastMessage message([&target](NetworkMessage &msg, bool) {
+		ProtocolGame::AddCreatureHealth(msg, target);
+	});
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendCreatureHealth(target);
+			tmpPlayer->sendBroadcast(message);
 		}
 	}
 }
@@ -7287,9 +7285,12 @@ void Game::addMagicEffect(const Position &pos, uint16_t effect) {
 }
 
 void Game::addMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect) {
+	BroadcastMessage message([&pos, effect](NetworkMessage &msg, bool oldProtocol) {
+		ProtocolGame::AddMagicEffect(msg, pos, effect, oldProtocol);
+	});
 	for (const auto &spectator : spectators) {
-		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendMagicEffect(pos, effect);
+		if (const auto &tmpPlayer = spectator->getPlayer(); tmpPlayer && tmpPlayer->canSee(pos)) {
+			tmpPlayer->sendBroadcast(message);
 		}
 	}
 }
@@ -7300,9 +7301,12 @@ void Game::removeMagicEffect(const Position &pos, uint16_t effect) {
 }
 
 void Game::removeMagicEffect(const CreatureVector &spectators, const Position &pos, uint16_t effect) {
+	BroadcastMessage message([&pos, effect](NetworkMessage &msg, bool oldProtocol) {
+		ProtocolGame::RemoveMagicEffect(msg, pos, effect, oldProtocol);
+	});
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->removeMagicEffect(pos, effect);
+			tmpPlayer->sendBroadcast(message);
 		}
 	}
 }
@@ -7313,9 +7317,12 @@ void Game::addDistanceEffect(const Position &fromPos, const Position &toPos, uin
 }
 
 void Game::addDistanceEffect(const CreatureVector &spectators, const Position &fromPos, const Position &toPos, uint16_t effect) {
+	BroadcastMessage message([&fromPos, &toPos, effect](NetworkMessage &msg, bool oldProtocol) {
+		ProtocolGame::AddDistanceShoot(msg, fromPos, toPos, effect, oldProtocol);
+	});
 	for (const auto &spectator : spectators) {
 		if (const auto &tmpPlayer = spectator->getPlayer()) {
-			tmpPlayer->sendDistanceShoot(fromPos, toPos, effect);
+			tmpPlayer->sendBroadcast(message);
 		}
 	}
 }
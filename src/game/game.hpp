@@ -22,6 +22,7 @@
 #include "lua/creature/raids.hpp"
 #include "creatures/players/grouping/team_finder.hpp"
 #include "utils/wildcardtree.hpp"
+#include "game/scheduling/think_scheduler.hpp"
 #include "items/items_classification.hpp"
 #include "protobuf/appearances.pb.h"
 
@@ -169,7 +170,15 @@ public:
 	void executeDeath(uint32_t creatureId);
 
 	void addCreatureCheck(const std::shared_ptr<Creature> &creature);
-	static void removeCreatureCheck(const std::shared_ptr<Creature> &creature);
+	void removeCreatureCheck(const std::shared_ptr<Creature> &creature);
+
+	using CreatureThinkStats = ThinkScheduler<std::shared_ptr<Creature>>::Stats;
+	CreatureThinkStats getCreatureThinkStats() const {
+		return creatureThinkScheduler.getStats();
+	}
+	void resetCreatureThinkStats() {
+		creatureThinkScheduler.resetStats();
+	}
 
 	size_t getPlayersOnline() const {
 		return players.size();
@@ -798,7 +807,7 @@ private:
 	std::string boostedCreature = "";
 
 	std::vector<std::shared_ptr<Charm>> CharmList;
-	std::vector<std::shared_ptr<Creature>> checkCreatureLists[EVENT_CREATURECOUNT];
+	ThinkScheduler<std::shared_ptr<Creature>> creatureThinkScheduler { EVENT_CREATURECOUNT };
 
 	std::vector<uint16_t> registeredMagicEffects;
 	std::vector<uint16_t> registeredDistanceEffects;
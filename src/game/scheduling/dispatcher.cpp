@@ -16,6 +16,17 @@
 
 thread_local DispatcherContext Dispatcher::dispacherContext;
 
+namespace {
+	// Round the task time up, so a task is never executed before its time
+	int64_t toWheelTime(const std::chrono::system_clock::time_point &time) {
+		return std::chrono::ceil<std::chrono::milliseconds>(time.time_since_epoch()).count();
+	}
+
+	int64_t nowWheelTime() {
+		return std::chrono::floor<std::chrono::milliseconds>(Task::TIME_NOW.time_since_epoch()).count();
+	}
+}
+
 Dispatcher &Dispatcher::getInstance() {
 	return inject<Dispatcher>();
 }
@@ -25,6 +36,8 @@ void Dispatcher::init() {
 
 	threadPool.addLoad([this] {
 		std::unique_lock asyncLock(dummyMutex);
+		dispatcherThreadId = ThreadPool::getThreadId();
+		scheduledTasks.start(nowWheelTime());
 
 		while (!threadPool.getIoContext().stopped()) {
 			updateClock();
@@ -56,28 +69,18 @@ void Dispatcher::executeSerialEvents(std::vector<Task> &tasks) {
 }
 
 void Dispatcher::executeParallelEvents(std::vector<Task> &tasks, const uint8_t groupId) {
-	std::atomic_uint_fast64_t totalTaskSize = tasks.size();
-	std::atomic_bool isTasksCompleted = false;
+	threadPool.parallelFor(tasks.size(), [groupId, &tasks](size_t begin, size_t end) {
+		dispacherContext.type = DispatcherType::AsyncEvent;
+		dispacherContext.group = static_cast<TaskGroup>(groupId);
 
-	for (const auto &task : tasks) {
-		threadPool.addLoad([groupId, &task, &isTasksCompleted, &totalTaskSize] {
-			dispacherContext.type = DispatcherType::AsyncEvent;
-			dispacherContext.group = static_cast<TaskGroup>(groupId);
+		for (auto i = begin; i < end; ++i) {
+			const auto &task = tasks[i];
 			dispacherContext.taskName = task.getContext();
-
 			task.execute();
+		}
 
-			dispacherContext.reset();
-
-			totalTaskSize.fetch_sub(1);
-			if (totalTaskSize.load() == 0) {
-				isTasksCompleted.store(true);
-				isTasksCompleted.notify_one();
-			}
-		});
-	}
-
-	isTasksCompleted.wait(false);
+		dispacherContext.reset();
+	});
 
 	tasks.clear();
 }
@@ -101,30 +104,23 @@ void Dispatcher::executeEvents(const TaskGroup startGroup) {
 void Dispatcher::executeScheduledEvents() {
 	auto &threadScheduledTasks = getThreadTask()->scheduledTasks;
 
-	auto it = scheduledTasks.begin();
-	while (it != scheduledTasks.end()) {
-		const auto &task = *it;
-		if (task->getTime() > Task::TIME_NOW) {
-			break;
+	scheduledTasks.advance(nowWheelTime(), [this, &threadScheduledTasks](Task &task) {
+		// stopped outside of the dispatcher thread, the wheel slot could not be released right away
+		if (!scheduledTasksRef.contains(task.getId())) {
+			return;
 		}
 
-		dispacherContext.type = task->isCycle() ? DispatcherType::CycleEvent : DispatcherType::ScheduledEvent;
+		dispacherContext.type = task.isCycle() ? DispatcherType::CycleEvent : DispatcherType::ScheduledEvent;
 		dispacherContext.group = TaskGroup::Serial;
-		dispacherContext.taskName = task->getContext();
+		dispacherContext.taskName = task.getContext();
 
-		if (task->execute() && task->isCycle()) {
-			task->updateTime();
-			threadScheduledTasks.emplace_back(task);
+		if (task.execute() && task.isCycle()) {
+			task.updateTime();
+			threadScheduledTasks.emplace(std::move(task));
 		} else {
-			scheduledTasksRef.erase(task->getId());
+			scheduledTasksRef.erase(task.getId());
 		}
-
-		++it;
-	}
-
-	if (it != scheduledTasks.begin()) {
-		scheduledTasks.erase(scheduledTasks.begin(), it);
-	}
+	});
 
 	dispacherContext.reset();
 
@@ -138,12 +134,10 @@ void Dispatcher::mergeAsyncEvents() {
 	constexpr uint8_t end = static_cast<uint8_t>(TaskGroup::Last);
 
 	for (const auto &thread : threads) {
-		std::scoped_lock lock(thread->mutex);
 		for (uint_fast8_t i = start; i < end; ++i) {
-			if (!thread->tasks[i].empty()) {
-				m_tasks[i].insert(m_tasks[i].end(), make_move_iterator(thread->tasks[i].begin()), make_move_iterator(thread->tasks[i].end()));
-				thread->tasks[i].clear();
-			}
+			thread->tasks[i].consume([&tasks = m_tasks[i]](Task &&task) {
+				tasks.emplace_back(std::move(task));
+			});
 		}
 	}
 }
@@ -153,16 +147,17 @@ void Dispatcher::mergeEvents() {
 	constexpr uint8_t serial = static_cast<uint8_t>(TaskGroup::Serial);
 
 	for (const auto &thread : threads) {
-		std::scoped_lock lock(thread->mutex);
-		if (!thread->tasks[serial].empty()) {
-			m_tasks[serial].insert(m_tasks[serial].end(), make_move_iterator(thread->tasks[serial].begin()), make_move_iterator(thread->tasks[serial].end()));
-			thread->tasks[serial].clear();
-		}
+		thread->tasks[serial].consume([&tasks = m_tasks[serial]](Task &&task) {
+			tasks.emplace_back(std::move(task));
+		});
 
-		if (!thread->scheduledTasks.empty()) {
-			scheduledTasks.insert(make_move_iterator(thread->scheduledTasks.begin()), make_move_iterator(thread->scheduledTasks.end()));
-			thread->scheduledTasks.clear();
-		}
+		thread->scheduledTasks.consume([this](Task &&task) {
+			const auto expiration = toWheelTime(task.getTime());
+			// tasks stopped before reaching the wheel are no longer referenced and are dropped here
+			scheduledTasksRef.modify_if(task.getId(), [&](auto &it) {
+				it.second = scheduledTasks.schedule(std::move(task), expiration);
+			});
+		});
 	}
 
 	checkPendingTasks();
@@ -176,25 +171,27 @@ std::chrono::nanoseconds Dispatcher::timeUntilNextScheduledTask() const {
 		return CHRONO_MILI_MAX;
 	}
 
-	const auto &task = *scheduledTasks.begin();
-	const auto timeRemaining = task->getTime() - Task::TIME_NOW;
+	const auto nextTime = std::chrono::system_clock::time_point(std::chrono::milliseconds(scheduledTasks.nextExpiration()));
+	const auto timeRemaining = nextTime - Task::TIME_NOW;
 	return std::max<std::chrono::nanoseconds>(timeRemaining, CHRONO_NANO_0);
 }
 
 void Dispatcher::addEvent(std::function<void(void)> &&f, std::string_view context, uint32_t expiresAfterMs) {
 	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(TaskGroup::Serial)].emplace_back(expiresAfterMs, std::move(f), context);
+	thread->tasks[static_cast<uint8_t>(TaskGroup::Serial)].emplace(expiresAfterMs, std::move(f), context);
 	notify();
 }
 
 uint64_t Dispatcher::scheduleEvent(const std::shared_ptr<Task> &task) {
+	return scheduleEvent(Task(*task));
+}
+
+uint64_t Dispatcher::scheduleEvent(Task &&task) {
 	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
 
-	auto eventId = scheduledTasksRef
-					   .emplace(task->getId(), thread->scheduledTasks.emplace_back(task))
-					   .first->first;
+	const auto eventId = task.getId();
+	scheduledTasksRef.emplace(eventId, stdext::timing_wheel<Task>::INVALID_HANDLE);
+	thread->scheduledTasks.emplace(std::move(task));
 
 	notify();
 	return eventId;
@@ -202,16 +199,20 @@ uint64_t Dispatcher::scheduleEvent(const std::shared_ptr<Task> &task) {
 
 void Dispatcher::asyncEvent(std::function<void(void)> &&f, TaskGroup group) {
 	const auto &thread = getThreadTask();
-	std::scoped_lock lock(thread->mutex);
-	thread->tasks[static_cast<uint8_t>(group)].emplace_back(0, std::move(f), dispacherContext.taskName);
+	thread->tasks[static_cast<uint8_t>(group)].emplace(0, std::move(f), dispacherContext.taskName);
 	notify();
 }
 
 void Dispatcher::stopEvent(uint64_t eventId) {
-	const auto &it = scheduledTasksRef.find(eventId);
-	if (it != scheduledTasksRef.end()) {
-		it->second->cancel();
-		scheduledTasksRef.erase(it);
+	auto handle = stdext::timing_wheel<Task>::INVALID_HANDLE;
+	const bool erased = scheduledTasksRef.erase_if(eventId, [&handle](const auto &it) {
+		handle = it.second;
+		return true;
+	});
+
+	// Only the dispatcher thread can release the wheel slot, otherwise it is skipped when it expires
+	if (erased && ThreadPool::getThreadId() == dispatcherThreadId) {
+		scheduledTasks.cancel(handle);
 	}
 }
 
@@ -11,6 +11,8 @@
 
 #include "task.hpp"
 #include "lib/thread/thread_pool.hpp"
+#include "lib/thread/segmented_queue.hpp"
+#include "utils/timing_wheel.hpp"
 
 static constexpr uint16_t DISPATCHER_TASK_EXPIRATION = 2000;
 static constexpr uint16_t SCHEDULER_MINTICKS = 50;
@@ -144,9 +146,11 @@ private:
 	}
 
 	uint64_t scheduleEvent(uint32_t delay, std::function<void(void)> &&f, std::string_view context, bool cycle, bool log = true) {
-		return scheduleEvent(std::make_shared<Task>(std::move(f), context, delay, cycle, log));
+		return scheduleEvent(Task(std::move(f), context, delay, cycle, log));
 	}
 
+	uint64_t scheduleEvent(Task &&task);
+
 	void init();
 	void shutdown() {
 		signalSchedule.notify_all();
@@ -179,6 +183,7 @@ private:
 	}
 
 	uint_fast64_t dispatcherCycle = 0;
+	std::atomic_int16_t dispatcherThreadId = -1;
 
 	ThreadPool &threadPool;
 	std::condition_variable signalSchedule;
@@ -186,24 +191,20 @@ private:
 	std::mutex dummyMutex; // This is only used for signaling the condition variable and not as an actual lock.
 
 	// Thread Events
+	// Each thread only writes to its own ThreadTask and the dispatcher is the only reader,
+	// so the queues are single producer/single consumer and need no lock.
 	struct ThreadTask {
-		ThreadTask() {
-			for (auto &task : tasks) {
-				task.reserve(2000);
-			}
-			scheduledTasks.reserve(2000);
-		}
-
-		std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
-		std::vector<std::shared_ptr<Task>> scheduledTasks;
-		std::mutex mutex;
+		std::array<SegmentedQueue<Task>, static_cast<uint8_t>(TaskGroup::Last)> tasks;
+		SegmentedQueue<Task> scheduledTasks;
 	};
 	std::vector<std::unique_ptr<ThreadTask>> threads;
 
 	// Main Events
 	std::array<std::vector<Task>, static_cast<uint8_t>(TaskGroup::Last)> m_tasks;
-	phmap::btree_multiset<std::shared_ptr<Task>, Task::Compare> scheduledTasks;
-	phmap::parallel_flat_hash_map_m<uint64_t, std::shared_ptr<Task>> scheduledTasksRef;
+	// Scheduled tasks live in pooled wheel slots, the ref map goes from event id to the wheel handle
+	// and is the source of truth for stopEvent, the wheel itself is only touched by the dispatcher thread.
+	stdext::timing_wheel<Task> scheduledTasks { SCHEDULER_MINTICKS };
+	phmap::parallel_flat_hash_map_m<uint64_t, stdext::timing_wheel<Task>::handle_t> scheduledTasksRef;
 
 	friend class CanaryServer;
 };
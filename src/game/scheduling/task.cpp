@@ -9,6 +9,7 @@
 
 #include "pch.hpp"
 #include "task.hpp"
+#include "game/scheduling/task_metrics.hpp"
 #include "lib/logging/log_with_spd_log.hpp"
 
 std::chrono::system_clock::time_point Task::TIME_NOW = SYSTEM_TIME_ZERO;
@@ -32,7 +33,15 @@ bool Task::execute() const {
 		}
 	}
 
+	const auto startTime = std::chrono::system_clock::now();
 	func();
+	const auto endTime = std::chrono::system_clock::now();
+
+	g_taskMetrics().record(
+		getContext(),
+		std::chrono::duration_cast<std::chrono::microseconds>(startTime - utime),
+		std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime)
+	);
 
 	return true;
 }
@@ -27,8 +27,6 @@ public:
 		assert(!this->context.empty() && "Context cannot be empty!");
 	}
 
-	~Task() = default;
-
 	uint64_t getId() {
 		if (id == 0) {
 			if (++LAST_EVENT_ID == 0) {
@@ -108,12 +106,6 @@ private:
 		return tasksContext.contains(context);
 	}
 
-	struct Compare {
-		bool operator()(const std::shared_ptr<Task> &a, const std::shared_ptr<Task> &b) const {
-			return a->utime < b->utime;
-		}
-	};
-
 	std::function<void(void)> func = nullptr;
 	std::string_view context;
 
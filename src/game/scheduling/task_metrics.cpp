@@ -0,0 +1,131 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "game/scheduling/task_metrics.hpp"
+#include "lib/di/container.hpp"
+#include "lib/logging/log_with_spd_log.hpp"
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const {
+	const auto total = getCount();
+	if (total == 0) {
+		return 0;
+	}
+
+	const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(static_cast<double>(total) * percentile)));
+
+	uint64_t accumulated = 0;
+	for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+		accumulated += buckets[bucket].load(std::memory_order_relaxed);
+		if (accumulated >= target) {
+			return std::min(getBucketUpperBound(bucket), getMax());
+		}
+	}
+
+	return getMax();
+}
+
+void LatencyHistogram::reset() {
+	for (auto &bucket : buckets) {
+		bucket.store(0, std::memory_order_relaxed);
+	}
+	count.store(0, std::memory_order_relaxed);
+	sum.store(0, std::memory_order_relaxed);
+	max.store(0, std::memory_order_relaxed);
+}
+
+TaskMetrics &TaskMetrics::getInstance() {
+	return inject<TaskMetrics>();
+}
+
+TaskMetrics::Entry &TaskMetrics::getEntry(std::string_view context) {
+	// the contexts are a small, stable set, so each thread resolves them only once
+	thread_local phmap::flat_hash_map<std::string_view, Entry*> cache;
+	if (const auto it = cache.find(context); it != cache.end()) {
+		return *it->second;
+	}
+
+	std::scoped_lock lock(mutex);
+	auto it = entries.find(context);
+	if (it == entries.end()) {
+		auto entry = std::make_unique<Entry>(context);
+		const std::string_view key = entry->context;
+		it = entries.emplace(key, std::move(entry)).first;
+	}
+
+	// keyed by the entry own copy of the context, it may outlive the task one
+	cache.emplace(it->first, it->second.get());
+	return *it->second;
+}
+
+void TaskMetrics::record(std::string_view context, std::chrono::microseconds wait, std::chrono::microseconds run) {
+	auto &entry = getEntry(context);
+	entry.wait.record(static_cast<uint64_t>(std::max<int64_t>(wait.count(), 0)));
+	entry.run.record(static_cast<uint64_t>(std::max<int64_t>(run.count(), 0)));
+}
+
+std::vector<TaskMetrics::Summary> TaskMetrics::getSummaries() const {
+	static constexpr auto toMs = [](uint64_t us) {
+		return static_cast<double>(us) / 1000.;
+	};
+
+	std::vector<Summary> summaries;
+	{
+		std::scoped_lock lock(mutex);
+		summaries.reserve(entries.size());
+		for (const auto &[context, entry] : entries) {
+			const auto count = entry->run.getCount();
+			if (count == 0) {
+				continue;
+			}
+
+			summaries.emplace_back(
+				entry->context,
+				count,
+				toMs(entry->wait.getPercentile(.5)),
+				toMs(entry->wait.getPercentile(.99)),
+				toMs(entry->wait.getMax()),
+				toMs(entry->run.getPercentile(.5)),
+				toMs(entry->run.getPercentile(.99)),
+				toMs(entry->run.getMax()),
+				toMs(entry->run.getSum())
+			);
+		}
+	}
+
+	std::ranges::sort(summaries, std::greater {}, &Summary::runTotal);
+	return summaries;
+}
+
+void TaskMetrics::dump(size_t limit /* = 0*/) const {
+	auto summaries = getSummaries();
+	if (limit > 0 && summaries.size() > limit) {
+		summaries.resize(limit);
+	}
+
+	g_logger().info("Dispatcher task metrics ({} contexts, times in ms):", summaries.size());
+	g_logger().info("{:<50} {:>10} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>12}", "context", "count", "wait p50", "wait p99", "wait max", "run p50", "run p99", "run max", "run total");
+	for (const auto &summary : summaries) {
+		g_logger().info(
+			"{:<50} {:>10} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>12.3f}",
+			summary.context, summary.count,
+			summary.waitP50, summary.waitP99, summary.waitMax,
+			summary.runP50, summary.runP99, summary.runMax, summary.runTotal
+		);
+	}
+}
+
+void TaskMetrics::reset() {
+	std::scoped_lock lock(mutex);
+	for (const auto &[context, entry] : entries) {
+		entry->wait.reset();
+		entry->run.reset();
+	}
+}
@@ -0,0 +1,128 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Lock-free log-linear (HDR style) histogram of microseconds.
+ * Every power of two is split in 16 linear buckets, so a percentile is reported
+ * with at most ~6% error, from 1 us up to ~71 minutes.
+ */
+class LatencyHistogram {
+public:
+	void record(uint64_t us) {
+		us = std::min<uint64_t>(us, std::numeric_limits<uint32_t>::max());
+		buckets[getBucket(us)].fetch_add(1, std::memory_order_relaxed);
+		count.fetch_add(1, std::memory_order_relaxed);
+		sum.fetch_add(us, std::memory_order_relaxed);
+
+		auto current = max.load(std::memory_order_relaxed);
+		while (current < us && !max.compare_exchange_weak(current, us, std::memory_order_relaxed)) { }
+	}
+
+	// percentile in [0, 1], returns the upper bound of the bucket it falls in
+	uint64_t getPercentile(double percentile) const;
+
+	uint64_t getCount() const {
+		return count.load(std::memory_order_relaxed);
+	}
+
+	uint64_t getSum() const {
+		return sum.load(std::memory_order_relaxed);
+	}
+
+	uint64_t getMax() const {
+		return max.load(std::memory_order_relaxed);
+	}
+
+	void reset();
+
+private:
+	static constexpr uint8_t SUB_BITS = 4;
+	static constexpr uint8_t SUB_BUCKETS = 1 << SUB_BITS;
+	static constexpr size_t BUCKETS = (32 - SUB_BITS + 1) * SUB_BUCKETS;
+
+	static size_t getBucket(uint64_t us) {
+		if (us < SUB_BUCKETS) {
+			return us;
+		}
+
+		const auto shift = std::bit_width(us) - 1 - SUB_BITS;
+		return (shift + 1) * SUB_BUCKETS + ((us >> shift) & (SUB_BUCKETS - 1));
+	}
+
+	static uint64_t getBucketUpperBound(size_t bucket) {
+		if (bucket < SUB_BUCKETS) {
+			return bucket;
+		}
+
+		const auto shift = bucket / SUB_BUCKETS - 1;
+		const auto sub = bucket % SUB_BUCKETS;
+		return ((SUB_BUCKETS + sub + 1) << shift) - 1;
+	}
+
+	std::array<std::atomic_uint64_t, BUCKETS> buckets {};
+	std::atomic_uint64_t count = 0;
+	std::atomic_uint64_t sum = 0;
+	std::atomic_uint64_t max = 0;
+};
+
+/**
+ * Per task context telemetry of the dispatcher, every executed task records how long it
+ * waited in the queue (from its time to its execution) and how long it ran.
+ */
+class TaskMetrics {
+public:
+	TaskMetrics() = default;
+
+	// Ensures that we don't accidentally copy it
+	TaskMetrics(const TaskMetrics &) = delete;
+	TaskMetrics &operator=(const TaskMetrics &) = delete;
+
+	static TaskMetrics &getInstance();
+
+	struct Summary {
+		std::string context;
+		uint64_t count = 0;
+		// all times in milliseconds
+		double waitP50 = 0;
+		double waitP99 = 0;
+		double waitMax = 0;
+		double runP50 = 0;
+		double runP99 = 0;
+		double runMax = 0;
+		double runTotal = 0;
+	};
+
+	void record(std::string_view context, std::chrono::microseconds wait, std::chrono::microseconds run);
+
+	// Sorted by total run time, the most expensive context first
+	std::vector<Summary> getSummaries() const;
+
+	void dump(size_t limit = 0) const;
+	void reset();
+
+private:
+	struct Entry {
+		explicit Entry(std::string_view context) :
+			context(context) { }
+
+		const std::string context;
+		LatencyHistogram wait;
+		LatencyHistogram run;
+	};
+
+	Entry &getEntry(std::string_view context);
+
+	mutable std::mutex mutex;
+	// entries are never removed, so the thread local caches can keep pointers to them
+	phmap::flat_hash_map<std::string_view, std::unique_ptr<Entry>> entries;
+};
+
+constexpr auto g_taskMetrics = TaskMetrics::getInstance;
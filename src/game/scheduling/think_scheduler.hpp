@@ -0,0 +1,326 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * Spreads the thinking creatures over a fixed number of buckets, one bucket is run per
+ * check so every creature thinks once per round.
+ * How long each entry takes to think is measured on every run, new entries go to the bucket
+ * with the least measured cost and, at the end of every round, entries are moved from the
+ * heaviest bucket to the lightest one, so a raid spawned at once does not end up in one bucket.
+ * A move makes the next think of the entry come sooner or later than a round, so think is told
+ * how many checks passed since the entry last thought.
+ * Entries are removed right away and are never visited again, the handle returned by add is
+ * what identifies them.
+ */
+template <typename T, typename Clock = std::chrono::steady_clock>
+class ThinkScheduler {
+public:
+	static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+	static constexpr uint64_t NEVER = std::numeric_limits<uint64_t>::max();
+	// entries moved per round, each move shifts the think time of the entry once
+	static constexpr size_t MAX_MOVES_PER_ROUND = 32;
+
+	explicit ThinkScheduler(size_t bucketCount) :
+		buckets(std::max<size_t>(bucketCount, 1)) { }
+
+	// Ensures that we don't accidentally copy it
+	ThinkScheduler(const ThinkScheduler &) = delete;
+	ThinkScheduler &operator=(const ThinkScheduler &) = delete;
+
+	uint32_t add(T value) {
+		const uint32_t index = allocate();
+		auto &slot = slots[index];
+		slot.value = std::move(value);
+		slot.removed = false;
+		slot.lastCheck = NEVER;
+		// unknown until it runs, the average keeps the buckets even meanwhile
+		slot.cost = count > 0 ? totalCost / count : 0;
+
+		link(index, lightestBucket());
+		++count;
+		totalCost += slot.cost;
+		return index;
+	}
+
+	// The handle is no longer valid afterwards, the entry is not visited again
+	void remove(uint32_t handle) {
+		if (handle >= slots.size() || slots[handle].removed) {
+			return;
+		}
+
+		auto &slot = slots[handle];
+		slot.removed = true;
+		slot.value = T {};
+		--count;
+		totalCost -= slot.cost;
+		buckets[slot.bucket].cost -= slot.cost;
+
+		// the running bucket is compacted once it is done, its positions must not change meanwhile
+		if (slot.bucket == running) {
+			return;
+		}
+
+		unlink(handle);
+		freeSlots.emplace_back(handle);
+	}
+
+	/**
+	 * Calls think(value, checks) for every entry of the next bucket, in the order they were added to it,
+	 * checks being the runs since the entry last thought, a whole round for its first think.
+	 * Entries added meanwhile are left for the next round, removed ones are skipped.
+	 */
+	template <typename F>
+	void runNext(F &&think) {
+		const auto bucketStart = Clock::now();
+		running = static_cast<uint32_t>(next);
+		auto &bucket = buckets[running];
+
+		const size_t end = bucket.entries.size();
+		for (size_t i = 0; i < end; ++i) {
+			const uint32_t index = bucket.entries[i];
+			if (slots[index].removed) {
+				continue;
+			}
+
+			const uint64_t lastCheck = slots[index].lastCheck;
+			const auto elapsed = static_cast<uint32_t>(lastCheck == NEVER ? buckets.size() : checks - lastCheck);
+			slots[index].lastCheck = checks;
+
+			// thinking may add entries and move the slots
+			const T value = slots[index].value;
+			const auto start = Clock::now();
+			think(value, elapsed);
+			const auto sample = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+
+			auto &slot = slots[index];
+			if (!slot.removed) {
+				// moving average, one slow think does not move the entry alone
+				const uint64_t cost = (slot.cost * 7 + sample) / 8;
+				bucket.cost += cost - slot.cost;
+				totalCost += cost - slot.cost;
+				slot.cost = cost;
+			}
+		}
+
+		compact(running);
+		running = NONE;
+
+		const auto runTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - bucketStart).count());
+		bucket.lastRunTime = runTime;
+		bucket.maxRunTime = std::max(bucket.maxRunTime, runTime);
+		bucket.totalRunTime += runTime;
+		++bucket.runs;
+		++checks;
+
+		if (++next == buckets.size()) {
+			next = 0;
+			++rounds;
+			rebalance();
+		}
+	}
+
+	bool contains(uint32_t handle) const {
+		return handle < slots.size() && !slots[handle].removed;
+	}
+
+	size_t size() const {
+		return count;
+	}
+
+	size_t bucketCount() const {
+		return buckets.size();
+	}
+
+	struct BucketStats {
+		size_t entries = 0;
+		// summed measured think time of its entries
+		uint64_t cost = 0;
+		// wall time of its runs, in microseconds
+		uint64_t lastRunTime = 0;
+		uint64_t maxRunTime = 0;
+		uint64_t totalRunTime = 0;
+		uint64_t runs = 0;
+	};
+
+	struct Stats {
+		uint64_t rounds = 0;
+		uint64_t moves = 0;
+		std::vector<BucketStats> buckets;
+	};
+
+	Stats getStats() const {
+		Stats stats { rounds, moves, {} };
+		stats.buckets.reserve(buckets.size());
+		for (const auto &bucket : buckets) {
+			stats.buckets.push_back({ bucket.entries.size(), bucket.cost, bucket.lastRunTime, bucket.maxRunTime, bucket.totalRunTime, bucket.runs });
+		}
+		return stats;
+	}
+
+	// The measured costs are kept, they are what balances the buckets
+	void resetStats() {
+		rounds = 0;
+		moves = 0;
+		for (auto &bucket : buckets) {
+			bucket.lastRunTime = 0;
+			bucket.maxRunTime = 0;
+			bucket.totalRunTime = 0;
+			bucket.runs = 0;
+		}
+	}
+
+private:
+	struct Slot {
+		T value {};
+		// measured think time, in nanoseconds
+		uint64_t cost = 0;
+		uint32_t bucket = NONE;
+		// in the entries of the bucket
+		uint32_t position = 0;
+		// run it last thought in
+		uint64_t lastCheck = NEVER;
+		bool removed = true;
+	};
+
+	struct Bucket {
+		std::vector<uint32_t> entries;
+		uint64_t cost = 0;
+		uint64_t lastRunTime = 0;
+		uint64_t maxRunTime = 0;
+		uint64_t totalRunTime = 0;
+		uint64_t runs = 0;
+	};
+
+	uint32_t allocate() {
+		if (!freeSlots.empty()) {
+			const uint32_t index = freeSlots.back();
+			freeSlots.pop_back();
+			return index;
+		}
+
+		slots.emplace_back();
+		return static_cast<uint32_t>(slots.size() - 1);
+	}
+
+	size_t lightestBucket() const {
+		size_t lightest = 0;
+		for (size_t i = 1; i < buckets.size(); ++i) {
+			const auto &bucket = buckets[i];
+			const auto &current = buckets[lightest];
+			if (bucket.cost < current.cost || (bucket.cost == current.cost && bucket.entries.size() < current.entries.size())) {
+				lightest = i;
+			}
+		}
+		return lightest;
+	}
+
+	size_t heaviestBucket() const {
+		size_t heaviest = 0;
+		for (size_t i = 1; i < buckets.size(); ++i) {
+			if (buckets[i].cost > buckets[heaviest].cost) {
+				heaviest = i;
+			}
+		}
+		return heaviest;
+	}
+
+	void link(uint32_t index, size_t bucketIndex) {
+		auto &slot = slots[index];
+		auto &bucket = buckets[bucketIndex];
+		slot.bucket = static_cast<uint32_t>(bucketIndex);
+		slot.position = static_cast<uint32_t>(bucket.entries.size());
+		bucket.entries.emplace_back(index);
+		bucket.cost += slot.cost;
+	}
+
+	// Swaps the last entry of the bucket into its place, the bucket cost is up to the caller
+	void unlink(uint32_t index) {
+		auto &slot = slots[index];
+		auto &entries = buckets[slot.bucket].entries;
+		const uint32_t last = entries.back();
+		entries[slot.position] = last;
+		slots[last].position = slot.position;
+		entries.pop_back();
+		slot.bucket = NONE;
+	}
+
+	void compact(size_t bucketIndex) {
+		auto &entries = buckets[bucketIndex].entries;
+		size_t kept = 0;
+		for (const uint32_t index : entries) {
+			auto &slot = slots[index];
+			if (slot.removed) {
+				slot.bucket = NONE;
+				freeSlots.emplace_back(index);
+				continue;
+			}
+
+			slot.position = static_cast<uint32_t>(kept);
+			entries[kept++] = index;
+		}
+		entries.resize(kept);
+	}
+
+	/**
+	 * Moves entries from the heaviest bucket to the lightest one while they differ by more than
+	 * an eighth of the average bucket, each time the one whose cost is closest to half the difference.
+	 * An entry only moves when it makes the difference smaller, so entries do not bounce between buckets.
+	 */
+	void rebalance() {
+		const uint64_t tolerance = totalCost / buckets.size() / 8;
+		for (size_t moved = 0; moved < MAX_MOVES_PER_ROUND; ++moved) {
+			const size_t heaviest = heaviestBucket();
+			const size_t lightest = lightestBucket();
+			const uint64_t difference = buckets[heaviest].cost - buckets[lightest].cost;
+			if (heaviest == lightest || difference <= tolerance) {
+				return;
+			}
+
+			uint32_t candidate = NONE;
+			uint64_t candidateDifference = difference;
+			for (const uint32_t index : buckets[heaviest].entries) {
+				const uint64_t cost = slots[index].cost;
+				if (cost == 0 || cost >= difference) {
+					continue;
+				}
+
+				// what the difference would be after moving it
+				const uint64_t after = cost * 2 > difference ? cost * 2 - difference : difference - cost * 2;
+				if (after < candidateDifference) {
+					candidate = index;
+					candidateDifference = after;
+				}
+			}
+
+			if (candidate == NONE) {
+				return;
+			}
+
+			buckets[heaviest].cost -= slots[candidate].cost;
+			unlink(candidate);
+			link(candidate, lightest);
+			++moves;
+		}
+	}
+
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
+	std::vector<Bucket> buckets;
+	size_t next = 0;
+	// runs so far, never reset
+	uint64_t checks = 0;
+	// bucket being run, NONE between runs
+	uint32_t running = NONE;
+	size_t count = 0;
+	uint64_t totalCost = 0;
+	uint64_t rounds = 0;
+	uint64_t moves = 0;
+};
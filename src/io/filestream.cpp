@@ -13,12 +13,33 @@
 
 #include "io/fileloader.hpp"
 
+#ifndef _WIN32
+	#include <sys/mman.h>
+#endif
+
+FileStream::FileStream(mio::mmap_source source, size_t offset) :
+	m_source(std::move(source)) {
+	if (offset > m_source.size()) {
+		throw std::ios_base::failure("File is too small");
+	}
+
+	m_data = reinterpret_cast<const uint8_t*>(m_source.data()) + offset;
+	m_size = m_source.size() - offset;
+
+#ifndef _WIN32
+	// more read ahead and pages behind the read position can be dropped first
+	if (m_source.mapped_length() > 0) {
+		madvise(const_cast<char*>(m_source.data()) - (m_source.mapped_length() - m_source.length()), m_source.mapped_length(), MADV_SEQUENTIAL);
+	}
+#endif
+}
+
 uint32_t FileStream::tell() const {
 	return m_pos;
 }
 
 void FileStream::seek(uint32_t pos) {
-	if (pos > m_data.size()) {
+	if (pos > m_size) {
 		throw std::ios_base::failure("Seek failed");
 	}
 	m_pos = pos;
@@ -29,7 +50,7 @@ void FileStream::skip(uint32_t len) {
 }
 
 uint32_t FileStream::size() const {
-	std::size_t size = m_data.size();
+	std::size_t size = m_size;
 	if (size > std::numeric_limits<uint32_t>::max()) {
 		throw std::overflow_error("File size exceeds uint32_t range");
 	}
@@ -41,16 +62,20 @@ template <typename T>
 bool FileStream::read(T &ret, bool escape) {
 	const auto size = sizeof(T);
 
-	if (m_pos + size > m_data.size()) {
+	if (m_pos + size > m_size) {
 		throw std::ios_base::failure("Read failed");
 	}
 
-	std::array<uint8_t, sizeof(T)> array;
-	if (escape) {
+	// escaped values are rare, most reads are a plain copy from the mapped pages
+	if (escape && std::find(m_data + m_pos, m_data + m_pos + size, OTB::Node::ESCAPE) != m_data + m_pos + size) {
+		std::array<uint8_t, sizeof(T)> array;
 		for (int_fast8_t i = -1; ++i < size;) {
 			if (m_data[m_pos] == OTB::Node::ESCAPE) {
 				++m_pos;
 			}
+			if (m_pos >= m_size) {
+				throw std::ios_base::failure("Read failed");
+			}
 			array[i] = m_data[m_pos];
 			++m_pos;
 		}
@@ -66,13 +91,13 @@ bool FileStream::read(T &ret, bool escape) {
 uint8_t FileStream::getU8() {
 	uint8_t v = 0;
 
-	if (m_pos + 1 > m_data.size()) {
+	if (m_pos + 1 > m_size) {
 		throw std::ios_base::failure("Failed to getU8");
 	}
 
 	// Fast Escape Val
-	if (m_nodes > 0 && m_data[m_pos] == OTB::Node::ESCAPE) {
-		++m_pos;
+	if (m_nodes > 0 && m_data[m_pos] == OTB::Node::ESCAPE && ++m_pos >= m_size) {
+		throw std::ios_base::failure("Failed to getU8");
 	}
 
 	v = m_data[m_pos];
@@ -102,7 +127,7 @@ uint64_t FileStream::getU64() {
 std::string FileStream::getString() {
 	std::string str;
 	if (const uint16_t len = getU16(); len > 0 && len < 8192) {
-		if (m_pos + len > m_data.size()) {
+		if (m_pos + len > m_size) {
 			throw std::ios_base::failure("[FileStream::getString] - Read failed");
 		}
 
@@ -153,3 +178,39 @@ bool FileStream::endNode() {
 	back();
 	return false;
 }
+
+void FileStream::skipNode() {
+	uint32_t depth = 1;
+	while (m_pos < m_size) {
+		switch (m_data[m_pos++]) {
+			case OTB::Node::ESCAPE:
+				++m_pos;
+				break;
+			case OTB::Node::START:
+				// the type may be any byte
+				++m_pos;
+				++depth;
+				break;
+			case OTB::Node::END:
+				if (--depth == 0) {
+					--m_nodes;
+					return;
+				}
+				break;
+			default:
+				break;
+		}
+	}
+
+	throw std::ios_base::failure("Failed to skip node");
+}
+
+FileStream FileStream::subStream(uint32_t begin, uint32_t end) const {
+	if (begin > end || end > m_size) {
+		throw std::ios_base::failure("Invalid sub stream");
+	}
+
+	FileStream stream { reinterpret_cast<const char*>(m_data + begin), reinterpret_cast<const char*>(m_data + end) };
+	stream.m_nodes = m_nodes;
+	return stream;
+}
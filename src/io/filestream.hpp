@@ -9,15 +9,18 @@
 
 #pragma once
 
+/**
+ * Reader of OTB node streams, escaped bytes are resolved while reading so the data is never copied.
+ * It either reads memory owned by the caller or the pages of a mapped file it keeps.
+ */
 class FileStream {
 public:
-	FileStream(const char* begin, const char* end) {
-		m_data.insert(m_data.end(), begin, end);
-	}
+	// The data must outlive the stream
+	FileStream(const char* begin, const char* end) :
+		m_data(reinterpret_cast<const uint8_t*>(begin)), m_size(static_cast<size_t>(end - begin)) { }
 
-	explicit FileStream(mio::mmap_source source) {
-		m_data.insert(m_data.end(), source.begin(), source.end());
-	}
+	// Reads the mapped file from offset on, hinting the kernel that it is read sequentially
+	explicit FileStream(mio::mmap_source source, size_t offset = 0);
 
 	void back(uint32_t pos = 1);
 	void seek(uint32_t pos);
@@ -27,8 +30,13 @@ public:
 
 	bool startNode(uint8_t type = 0);
 	bool endNode();
+	// Moves past the rest of a started node, children included, without decoding it
+	void skipNode();
 	bool isProp(uint8_t prop, bool toNext = true);
 
+	// A stream over [begin, end) of this one, with the same node depth, the data must outlive it
+	FileStream subStream(uint32_t begin, uint32_t end) const;
+
 	uint8_t getU8();
 	uint16_t getU16();
 	uint32_t getU32();
@@ -41,5 +49,7 @@ private:
 	uint32_t m_nodes { 0 };
 	uint32_t m_pos { 0 };
 
-	std::vector<uint8_t> m_data;
+	mio::mmap_source m_source;
+	const uint8_t* m_data { nullptr };
+	size_t m_size { 0 };
 };
@@ -12,6 +12,13 @@
 #include "game/movement/teleport.hpp"
 #include "game/game.hpp"
 #include "io/filestream.hpp"
+#include "lib/di/container.hpp"
+#include "lib/thread/thread_pool.hpp"
+
+namespace {
+	// bytes of tile areas decoded as one piece of work
+	constexpr size_t TILE_AREA_CHUNK_SIZE = 512 * 1024;
+}
 
 /*
 	OTBM_ROOTV1
@@ -39,12 +46,41 @@
 
 void IOMap::loadMap(Map* map, const Position &pos) {
 	Benchmark bm_mapLoad;
+	// how much the load raised the peak, the maps loaded before are already part of it
+	const auto peakBefore = getPeakMemoryUsage();
+	const auto logPeakMemory = [peakBefore] {
+		const auto peak = getPeakMemoryUsage();
+		g_logger().info("Peak memory usage {} MB, {} MB more than before loading the map", peak / (1024 * 1024), (peak - std::min(peak, peakBefore)) / (1024 * 1024));
+	};
+
+	// of all the maps loaded so far
+	const auto logMapCacheMemory = [map] {
+		const auto report = map->getMemoryReport();
+		g_logger().info("Map cache holds {} tiles, {} items and {} texts in {} MB ({} MB as shared tile and item objects)", report.tiles, report.items, report.texts, report.bytes / (1024 * 1024), report.sharedObjectBytes / (1024 * 1024));
+	};
+
+	mio::mmap_source source(map->path.string());
+
+	// a snapshot compiled from the same map skips parsing it
+	const bool useSnapshot = g_configManager().getBoolean(TOGGLE_MAP_SNAPSHOT);
+	const auto snapshotPath = IOMapSnapshot::getPath(map->path);
+	IOMapSnapshot::Key snapshotKey;
+	IOMapSnapshot::Contents snapshot;
+	if (useSnapshot) {
+		snapshotKey = IOMapSnapshot::makeKey(reinterpret_cast<const uint8_t*>(source.data()), source.size(), pos);
+		if (IOMapSnapshot::load(snapshotPath, snapshotKey, *map, snapshot)) {
+			applySnapshot(*map, snapshot);
+			map->flush();
+
+			g_logger().info("Map Loaded {} ({}x{}) from its snapshot in {} milliseconds", map->path.filename().string(), map->width, map->height, bm_mapLoad.duration());
+			logPeakMemory();
+			logMapCacheMemory();
+			return;
+		}
+	}
 
-	const auto &fileByte = mio::mmap_source(map->path.string());
-
-	const auto begin = fileByte.begin() + sizeof(OTB::Identifier { { 'O', 'T', 'B', 'M' } });
-
-	FileStream stream { begin, fileByte.end() };
+	// parsed straight from the mapped file, past the identifier
+	FileStream stream { std::move(source), sizeof(OTB::Identifier) };
 
 	if (!stream.startNode()) {
 		throw IOMapException("Could not read map node.");
@@ -66,21 +102,83 @@ void IOMap::loadMap(Map* map, const Position &pos) {
 		throw IOMapException("This map need to be upgraded by using the latest map editor version to be able to load correctly.");
 	}
 
+	auto* record = useSnapshot ? &snapshot : nullptr;
 	if (stream.startNode(OTBM_MAP_DATA)) {
-		parseMapDataAttributes(stream, map);
-		parseTileArea(stream, *map, pos);
+		parseMapDataAttributes(stream, map, record);
+		parseTileArea(stream, *map, pos, record);
 		stream.endNode();
 	}
 
-	parseTowns(stream, *map);
-	parseWaypoints(stream, *map);
+	parseTowns(stream, *map, record);
+	parseWaypoints(stream, *map, record);
+
+	if (useSnapshot) {
+		Benchmark bm_snapshot;
+		snapshot.width = static_cast<uint16_t>(map->width);
+		snapshot.height = static_cast<uint16_t>(map->height);
+		if (IOMapSnapshot::save(snapshotPath, snapshotKey, *map, snapshot)) {
+			g_logger().info("Map snapshot {} written in {} milliseconds", snapshotPath.filename().string(), bm_snapshot.duration());
+		}
+	}
 
 	map->flush();
 
 	g_logger().info("Map Loaded {} ({}x{}) in {} milliseconds", map->path.filename().string(), map->width, map->height, bm_mapLoad.duration());
+	logPeakMemory();
+	logMapCacheMemory();
 }
 
-void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
+void IOMap::applySnapshot(Map &map, IOMapSnapshot::Contents &snapshot) {
+	map.width = snapshot.width;
+	map.height = snapshot.height;
+
+	const auto folder = map.path.string().substr(0, map.path.string().rfind('/') + 1);
+	const auto setFile = [&folder](std::string &file, const std::string &name) {
+		if (!name.empty()) {
+			file = folder + name;
+		}
+	};
+	setFile(map.monsterfile, snapshot.monsterFile);
+	setFile(map.npcfile, snapshot.npcFile);
+	setFile(map.housefile, snapshot.houseFile);
+	setFile(map.zonesfile, snapshot.zonesFile);
+
+	for (const auto &[position, cachedTileIndex] : snapshot.tiles) {
+		const CachedTile &cachedTile = map.getCachedTile(cachedTileIndex);
+		if (cachedTile.isHouse() && !map.houses.addHouse(cachedTile.houseId)) {
+			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", position.x, position.y, position.z, cachedTile.houseId));
+		}
+
+		if (!cachedTile.isEmpty()) {
+			map.setCachedTile(position.x, position.y, position.z, cachedTileIndex);
+		}
+	}
+
+	for (const auto &[position, zoneId] : snapshot.zones) {
+		Zone::getZone(zoneId)->addPosition(position);
+	}
+
+	for (const auto &[id, name, templePosition] : snapshot.towns) {
+		auto town = map.towns.getOrCreateTown(id);
+		town->setName(name);
+		town->setTemplePos(templePosition);
+	}
+
+	for (const auto &[name, position] : snapshot.waypoints) {
+		map.waypoints[name] = position;
+	}
+}
+
+void IOMap::parseMapDataAttributes(FileStream &stream, Map* map, IOMapSnapshot::Contents* snapshot) {
+	const auto folder = map->path.string().substr(0, map->path.string().rfind('/') + 1);
+	const auto readFile = [&](std::string &file, std::string IOMapSnapshot::Contents::*snapshotFile) {
+		const auto name = stream.getString();
+		file = folder + name;
+		if (snapshot) {
+			snapshot->*snapshotFile = name;
+		}
+	};
+
 	bool end = false;
 	while (!end) {
 		const uint8_t attr = stream.getU8();
@@ -90,22 +188,18 @@ void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
 			} break;
 
 			case OTBM_ATTR_EXT_SPAWN_MONSTER_FILE: {
-				map->monsterfile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
-				map->monsterfile += stream.getString();
+				readFile(map->monsterfile, &IOMapSnapshot::Contents::monsterFile);
 			} break;
 
 			case OTBM_ATTR_EXT_SPAWN_NPC_FILE: {
-				map->npcfile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
-				map->npcfile += stream.getString();
+				readFile(map->npcfile, &IOMapSnapshot::Contents::npcFile);
 			} break;
 			case OTBM_ATTR_EXT_HOUSE_FILE: {
-				map->housefile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
-				map->housefile += stream.getString();
+				readFile(map->housefile, &IOMapSnapshot::Contents::houseFile);
 			} break;
 
 			case OTBM_ATTR_EXT_ZONE_FILE: {
-				map->zonesfile = map->path.string().substr(0, map->path.string().rfind('/') + 1);
-				map->zonesfile += stream.getString();
+				readFile(map->zonesfile, &IOMapSnapshot::Contents::zonesFile);
 			} break;
 
 			default:
@@ -116,14 +210,58 @@ void IOMap::parseMapDataAttributes(FileStream &stream, Map* map) {
 	}
 }
 
-void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
+void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos, IOMapSnapshot::Contents* snapshot) {
+	auto chunks = splitTileAreas(stream, TILE_AREA_CHUNK_SIZE);
+
+	// a few runs per thread at a time, so only a small part of the map is decoded and not applied yet
+	auto &threadPool = inject<ThreadPool>();
+	const size_t batchSize = static_cast<size_t>(threadPool.getNumberOfThreads()) * 4;
+	for (size_t first = 0; first < chunks.size(); first += batchSize) {
+		const size_t last = std::min(first + batchSize, chunks.size());
+		threadPool.parallelFor(
+			last - first,
+			[&](size_t begin, size_t end) {
+				for (size_t i = first + begin; i < first + end; ++i) {
+					try {
+						decodeTileAreas(stream, pos, chunks[i]);
+					} catch (...) {
+						chunks[i].error = std::current_exception();
+					}
+				}
+			},
+			1
+		);
+
+		for (size_t i = first; i < last; ++i) {
+			applyTileAreas(map, chunks[i], snapshot);
+			chunks[i] = {};
+		}
+	}
+}
+
+std::vector<IOMap::TileAreaChunk> IOMap::splitTileAreas(FileStream &stream, size_t chunkSize) {
+	std::vector<TileAreaChunk> chunks;
 	while (stream.startNode(OTBM_TILE_AREA)) {
+		// start and type bytes
+		const uint32_t begin = stream.tell() - 2;
+		stream.skipNode();
+
+		if (chunks.empty() || chunks.back().end - chunks.back().begin >= chunkSize) {
+			auto &chunk = chunks.emplace_back();
+			chunk.begin = begin;
+		}
+		chunks.back().end = stream.tell();
+	}
+	return chunks;
+}
+
+void IOMap::decodeTileAreas(const FileStream &mapStream, const Position &pos, TileAreaChunk &chunk) {
+	auto stream = mapStream.subStream(chunk.begin, chunk.end);
+	while (stream.tell() < stream.size() && stream.startNode(OTBM_TILE_AREA)) {
 		const uint16_t base_x = stream.getU16();
 		const uint16_t base_y = stream.getU16();
 		const uint8_t base_z = stream.getU8();
 
-		bool tileIsStatic = false;
-
 		while (stream.startNode()) {
 			const uint8_t tileType = stream.getU8();
 			if (tileType != OTBM_HOUSETILE && tileType != OTBM_TILE) {
@@ -141,9 +279,6 @@ void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
 
 			if (tileType == OTBM_HOUSETILE) {
 				tile->houseId = stream.getU32();
-				if (!map.houses.addHouse(tile->houseId)) {
-					throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", x, y, z, tile->houseId));
-				}
 			}
 
 			if (stream.isProp(OTBM_ATTR_TILE_FLAGS)) {
@@ -166,10 +301,6 @@ void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
 				const auto &iType = Item::items[id];
 
 				if (!tile->isHouse() || !iType.isBed()) {
-					if (iType.blockSolid) {
-						tileIsStatic = true;
-					}
-
 					const auto item = std::make_shared<BasicItem>();
 					item->id = id;
 
@@ -179,9 +310,9 @@ void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
 										"at position: x {}, y {}, z {}",
 										id, tile->houseId, x, y, z);
 					} else if (iType.isGroundTile()) {
-						tile->ground = map.tryReplaceItemFromCache(item);
+						tile->ground = item;
 					} else {
-						tile->items.emplace_back(map.tryReplaceItemFromCache(item));
+						tile->items.emplace_back(item);
 					}
 				}
 			}
@@ -194,10 +325,6 @@ void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
 
 						const auto &iType = Item::items[id];
 
-						if (iType.blockSolid) {
-							tileIsStatic = true;
-						}
-
 						const auto item = std::make_shared<BasicItem>();
 						item->id = id;
 
@@ -213,9 +340,9 @@ void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
 											"at position: x {}, y {}, z {}",
 											id, tile->houseId, x, y, z);
 						} else if (iType.isGroundTile()) {
-							tile->ground = map.tryReplaceItemFromCache(item);
+							tile->ground = item;
 						} else {
-							tile->items.emplace_back(map.tryReplaceItemFromCache(item));
+							tile->items.emplace_back(item);
 						}
 					} break;
 					case OTBM_TILE_ZONE: {
@@ -225,8 +352,7 @@ void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
 							if (!zoneId) {
 								throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Invalid zone id.", x, y, z));
 							}
-							auto zone = Zone::getZone(zoneId);
-							zone->addPosition(Position(x, y, z));
+							chunk.zones.emplace_back(Position(x, y, z), zoneId);
 						}
 					} break;
 					default:
@@ -242,11 +368,12 @@ void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
 				throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
 			}
 
-			if (tile->isEmpty(true)) {
+			// empty house tiles are kept for the house to be created
+			if (tile->isEmpty(true) && !tile->isHouse()) {
 				continue;
 			}
 
-			map.setBasicTile(x, y, z, tile);
+			chunk.tiles.emplace_back(Position(x, y, z), tile);
 		}
 
 		if (!stream.endNode()) {
@@ -255,7 +382,38 @@ void IOMap::parseTileArea(FileStream &stream, Map &map, const Position &pos) {
 	}
 }
 
-void IOMap::parseTowns(FileStream &stream, Map &map) {
+void IOMap::applyTileAreas(Map &map, TileAreaChunk &chunk, IOMapSnapshot::Contents* snapshot) {
+	if (chunk.error) {
+		std::rethrow_exception(chunk.error);
+	}
+
+	for (const auto &[position, tile] : chunk.tiles) {
+		if (tile->isHouse() && !map.houses.addHouse(tile->houseId)) {
+			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not create house id: {}", position.x, position.y, position.z, tile->houseId));
+		}
+
+		uint32_t cachedTile = 0;
+		if (!tile->isEmpty(true)) {
+			cachedTile = map.setBasicTile(position.x, position.y, position.z, tile);
+		} else if (snapshot) {
+			// only kept for the house to be created
+			cachedTile = map.cacheBasicTile(tile);
+		}
+
+		if (snapshot && cachedTile != 0) {
+			snapshot->tiles.emplace_back(position, cachedTile);
+		}
+	}
+
+	for (const auto &[position, zoneId] : chunk.zones) {
+		Zone::getZone(zoneId)->addPosition(position);
+	}
+	if (snapshot) {
+		snapshot->zones.insert(snapshot->zones.end(), chunk.zones.begin(), chunk.zones.end());
+	}
+}
+
+void IOMap::parseTowns(FileStream &stream, Map &map, IOMapSnapshot::Contents* snapshot) {
 	if (!stream.startNode(OTBM_TOWNS)) {
 		throw IOMapException("Could not read towns node.");
 	}
@@ -270,6 +428,9 @@ void IOMap::parseTowns(FileStream &stream, Map &map) {
 		auto town = map.towns.getOrCreateTown(townId);
 		town->setName(townName);
 		town->setTemplePos(Position(x, y, z));
+		if (snapshot) {
+			snapshot->towns.push_back({ townId, townName, Position(x, y, z) });
+		}
 
 		if (!stream.endNode()) {
 			throw IOMapException("Could not end node.");
@@ -281,7 +442,7 @@ void IOMap::parseTowns(FileStream &stream, Map &map) {
 	}
 }
 
-void IOMap::parseWaypoints(FileStream &stream, Map &map) {
+void IOMap::parseWaypoints(FileStream &stream, Map &map, IOMapSnapshot::Contents* snapshot) {
 	if (!stream.startNode(OTBM_WAYPOINTS)) {
 		throw IOMapException("Could not read waypoints node.");
 	}
@@ -293,6 +454,9 @@ void IOMap::parseWaypoints(FileStream &stream, Map &map) {
 		const uint8_t z = stream.getU8();
 
 		map.waypoints[name] = Position(x, y, z);
+		if (snapshot) {
+			snapshot->waypoints.emplace_back(name, Position(x, y, z));
+		}
 
 		if (!stream.endNode()) {
 			throw IOMapException("Could not end node.");
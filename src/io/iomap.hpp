@@ -18,6 +18,7 @@
 #include "creatures/monsters/spawns/spawn_monster.hpp"
 #include "creatures/npcs/spawns/spawn_npc.hpp"
 #include "game/zones/zone.hpp"
+#include "io/iomapsnapshot.hpp"
 
 class IOMap {
 public:
@@ -148,11 +149,35 @@ public:
 		return map->housesCustomMaps[customMapIndex].loadHousesXML(map->housefile);
 	}
 
+	/**
+	 * Tiles of a run of consecutive tile areas. They are decoded without touching the map, so the
+	 * runs can be decoded in parallel, and then applied to it one run at a time in file order.
+	 */
+	struct TileAreaChunk {
+		// where the run is in the map stream
+		uint32_t begin = 0;
+		uint32_t end = 0;
+
+		std::vector<std::pair<Position, std::shared_ptr<BasicTile>>> tiles;
+		std::vector<std::pair<Position, uint16_t>> zones;
+		std::exception_ptr error;
+	};
+
+	// Splits the tile areas at the stream position in runs of about chunkSize bytes and moves past them
+	static std::vector<TileAreaChunk> splitTileAreas(FileStream &stream, size_t chunkSize);
+	// Thread safe, the items are not deduplicated yet
+	static void decodeTileAreas(const FileStream &stream, const Position &pos, TileAreaChunk &chunk);
+	// The cached tiles are also recorded in snapshot when it is not null
+	static void applyTileAreas(Map &map, TileAreaChunk &chunk, IOMapSnapshot::Contents* snapshot = nullptr);
+
 private:
-	static void parseMapDataAttributes(FileStream &stream, Map* map);
-	static void parseWaypoints(FileStream &stream, Map &map);
-	static void parseTowns(FileStream &stream, Map &map);
-	static void parseTileArea(FileStream &stream, Map &map, const Position &pos);
+	// Everything parsed is also recorded in snapshot when it is not null
+	static void parseMapDataAttributes(FileStream &stream, Map* map, IOMapSnapshot::Contents* snapshot);
+	static void parseWaypoints(FileStream &stream, Map &map, IOMapSnapshot::Contents* snapshot);
+	static void parseTowns(FileStream &stream, Map &map, IOMapSnapshot::Contents* snapshot);
+	static void parseTileArea(FileStream &stream, Map &map, const Position &pos, IOMapSnapshot::Contents* snapshot);
+
+	static void applySnapshot(Map &map, IOMapSnapshot::Contents &snapshot);
 };
 
 class IOMapException : public std::exception {
@@ -0,0 +1,527 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include <bit>
+#include <span>
+
+#include "io/iomapsnapshot.hpp"
+#include "items/item.hpp"
+#include "map/mapcache.hpp"
+
+/*
+	Header
+	PackedItem[items]           children before the items holding them
+	uint32_t[children]          item indexes
+	PackedTile[tiles]           unique tiles
+	uint32_t[tileItems]         item indexes
+	PackedPlacement[placements] which tile goes where, in file order
+	PackedZone[zones]
+	PackedTown[towns]
+	PackedWaypoint[waypoints]
+	char[strings]
+
+	Every section starts at a multiple of 8 bytes, numbers are stored in the host byte order.
+*/
+
+namespace {
+	constexpr std::array<char, 4> MAGIC = { 'C', 'M', 'A', 'P' };
+	constexpr size_t SECTION_ALIGNMENT = 8;
+	constexpr uint32_t NO_ITEM = std::numeric_limits<uint32_t>::max();
+
+	struct StringRef {
+		uint32_t offset = 0;
+		uint32_t size = 0;
+	};
+
+	struct PackedPosition {
+		uint16_t x = 0;
+		uint16_t y = 0;
+		uint8_t z = 0;
+		uint8_t padding[3] = {};
+	};
+
+	struct Header {
+		std::array<char, 4> magic = MAGIC;
+		uint32_t version = IOMapSnapshot::FORMAT_VERSION;
+		uint64_t mapSize = 0;
+		uint64_t mapHash = 0;
+		uint64_t itemsHash = 0;
+		PackedPosition offset;
+		uint16_t width = 0;
+		uint16_t height = 0;
+		StringRef monsterFile;
+		StringRef npcFile;
+		StringRef houseFile;
+		StringRef zonesFile;
+		uint32_t items = 0;
+		uint32_t children = 0;
+		uint32_t tiles = 0;
+		uint32_t tileItems = 0;
+		uint32_t placements = 0;
+		uint32_t zones = 0;
+		uint32_t towns = 0;
+		uint32_t waypoints = 0;
+		uint64_t strings = 0;
+	};
+
+	struct PackedItem {
+		StringRef text;
+		uint32_t firstChild = 0;
+		uint32_t childCount = 0;
+		uint16_t id = 0;
+		uint16_t charges = 0;
+		uint16_t actionId = 0;
+		uint16_t uniqueId = 0;
+		uint16_t destX = 0;
+		uint16_t destY = 0;
+		uint16_t doorOrDepotId = 0;
+		uint8_t destZ = 0;
+		uint8_t padding = 0;
+	};
+
+	struct PackedTile {
+		uint32_t flags = 0;
+		uint32_t houseId = 0;
+		uint32_t ground = NO_ITEM;
+		uint32_t firstItem = 0;
+		uint32_t itemCount = 0;
+		uint8_t type = 0;
+		uint8_t isStatic = 0;
+		uint8_t padding[2] = {};
+	};
+
+	struct PackedPlacement {
+		PackedPosition position;
+		uint32_t tile = 0;
+	};
+
+	struct PackedZone {
+		PackedPosition position;
+		uint16_t zoneId = 0;
+		uint8_t padding[2] = {};
+	};
+
+	struct PackedTown {
+		uint32_t id = 0;
+		StringRef name;
+		PackedPosition templePosition;
+	};
+
+	struct PackedWaypoint {
+		StringRef name;
+		PackedPosition position;
+	};
+
+	PackedPosition pack(const Position &position) {
+		return { position.x, position.y, position.z };
+	}
+
+	Position unpack(const PackedPosition &position) {
+		return { position.x, position.y, position.z };
+	}
+
+	size_t align(size_t size) {
+		return (size + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+	}
+
+	uint64_t mix(uint64_t hash, uint64_t value) {
+		return std::rotl(hash ^ (value * 0x9E3779B97F4A7C15ULL), 31) * 0xC2B2AE3D27D4EB4FULL;
+	}
+
+	class Writer {
+	public:
+		explicit Writer(const MapCache &cache) :
+			cache(cache) { }
+
+		uint32_t addItem(uint32_t cachedItem) {
+			if (const auto it = itemIndexes.find(cachedItem); it != itemIndexes.end()) {
+				return it->second;
+			}
+
+			const CachedItem &item = cache.getCachedItem(cachedItem);
+			std::vector<uint32_t> itemChildren;
+			itemChildren.reserve(item.childCount);
+			for (const uint32_t child : cache.getCachedItemList(item.firstChild, item.childCount)) {
+				itemChildren.emplace_back(addItem(child));
+			}
+
+			auto &packed = items.emplace_back();
+			packed.text = addText(item.text);
+			packed.firstChild = static_cast<uint32_t>(children.size());
+			packed.childCount = static_cast<uint32_t>(itemChildren.size());
+			packed.id = item.id;
+			packed.charges = item.charges;
+			packed.actionId = item.actionId;
+			packed.uniqueId = item.uniqueId;
+			packed.destX = item.destX;
+			packed.destY = item.destY;
+			packed.doorOrDepotId = item.doorOrDepotId;
+			packed.destZ = item.destZ;
+			children.insert(children.end(), itemChildren.begin(), itemChildren.end());
+
+			const auto index = static_cast<uint32_t>(items.size() - 1);
+			itemIndexes.emplace(cachedItem, index);
+			return index;
+		}
+
+		uint32_t addTile(uint32_t cachedTile) {
+			if (const auto it = tileIndexes.find(cachedTile); it != tileIndexes.end()) {
+				return it->second;
+			}
+
+			const CachedTile &tile = cache.getCachedTile(cachedTile);
+			PackedTile packed;
+			packed.flags = tile.flags;
+			packed.houseId = tile.houseId;
+			packed.ground = tile.ground != 0 ? addItem(tile.ground) : NO_ITEM;
+			packed.firstItem = static_cast<uint32_t>(tileItems.size());
+			packed.itemCount = tile.itemCount;
+			packed.type = tile.type;
+			packed.isStatic = tile.isStatic ? 1 : 0;
+			for (const uint32_t item : cache.getCachedItemList(tile.firstItem, tile.itemCount)) {
+				// in its own variable, adding the item can grow tileItems
+				const uint32_t index = addItem(item);
+				tileItems.emplace_back(index);
+			}
+			tiles.emplace_back(packed);
+
+			const auto index = static_cast<uint32_t>(tiles.size() - 1);
+			tileIndexes.emplace(cachedTile, index);
+			return index;
+		}
+
+		StringRef addText(uint32_t cachedText) {
+			if (const auto it = textRefs.find(cachedText); it != textRefs.end()) {
+				return it->second;
+			}
+			const auto ref = addString(cache.getCachedText(cachedText));
+			textRefs.emplace(cachedText, ref);
+			return ref;
+		}
+
+		StringRef addString(const std::string &value) {
+			const StringRef ref { static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(value.size()) };
+			strings.insert(strings.end(), value.begin(), value.end());
+			return ref;
+		}
+
+		const MapCache &cache;
+
+		// by index in the cache
+		phmap::flat_hash_map<uint32_t, uint32_t> itemIndexes;
+		phmap::flat_hash_map<uint32_t, uint32_t> tileIndexes;
+		phmap::flat_hash_map<uint32_t, StringRef> textRefs;
+
+		std::vector<PackedItem> items;
+		std::vector<uint32_t> children;
+		std::vector<PackedTile> tiles;
+		std::vector<uint32_t> tileItems;
+		std::vector<PackedPlacement> placements;
+		std::vector<PackedZone> zones;
+		std::vector<PackedTown> towns;
+		std::vector<PackedWaypoint> waypoints;
+		std::vector<char> strings;
+	};
+
+	template <typename T>
+	void writeSection(std::ofstream &file, const std::vector<T> &section) {
+		static constexpr std::array<char, SECTION_ALIGNMENT> padding {};
+		const size_t size = section.size() * sizeof(T);
+		file.write(reinterpret_cast<const char*>(section.data()), static_cast<std::streamsize>(size));
+		file.write(padding.data(), static_cast<std::streamsize>(align(size) - size));
+	}
+
+	class Reader {
+	public:
+		Reader(const char* data, size_t size) :
+			data(data), size(size) { }
+
+		template <typename T>
+		std::span<const T> section(uint64_t count) {
+			const uint64_t bytes = count * sizeof(T);
+			if (count > size / sizeof(T) || bytes > size - position) {
+				throw std::out_of_range("snapshot section out of the file");
+			}
+
+			const auto* begin = reinterpret_cast<const T*>(data + position);
+			position += std::min<uint64_t>(align(bytes), size - position);
+			return { begin, static_cast<size_t>(count) };
+		}
+
+		bool atEnd() const {
+			return position == size;
+		}
+
+	private:
+		const char* data;
+		size_t size;
+		size_t position = 0;
+	};
+
+	void check(bool condition, const char* what) {
+		if (!condition) {
+			throw std::out_of_range(what);
+		}
+	}
+}
+
+IOMapSnapshot::Key IOMapSnapshot::makeKey(const uint8_t* mapData, size_t mapSize, const Position &offset) {
+	Key key;
+	key.mapSize = mapSize;
+	key.offset = offset;
+
+	// word at a time, the whole map is hashed on every boot so it has to run at memory speed
+	uint64_t hash = mapSize;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= mapSize; i += sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, mapData + i, sizeof(word));
+		hash = mix(hash, word);
+	}
+	for (; i < mapSize; ++i) {
+		hash = mix(hash, mapData[i]);
+	}
+	key.mapHash = hash;
+
+	// the parser drops beds and moveable items of houses and tells grounds apart by their type
+	uint64_t itemsHash = Item::items.size();
+	for (size_t id = 0; id < Item::items.size(); ++id) {
+		const ItemType &it = Item::items[id];
+		itemsHash = mix(itemsHash, (it.isGroundTile() ? 1 : 0) | (it.moveable ? 2 : 0) | (it.isBed() ? 4 : 0));
+	}
+	key.itemsHash = itemsHash;
+	return key;
+}
+
+bool IOMapSnapshot::save(const std::filesystem::path &path, const Key &key, const MapCache &cache, const Contents &contents) {
+	Writer writer(cache);
+	Header header;
+	header.mapSize = key.mapSize;
+	header.mapHash = key.mapHash;
+	header.itemsHash = key.itemsHash;
+	header.offset = pack(key.offset);
+	header.width = contents.width;
+	header.height = contents.height;
+	header.monsterFile = writer.addString(contents.monsterFile);
+	header.npcFile = writer.addString(contents.npcFile);
+	header.houseFile = writer.addString(contents.houseFile);
+	header.zonesFile = writer.addString(contents.zonesFile);
+
+	writer.placements.reserve(contents.tiles.size());
+	for (const auto &[position, cachedTile] : contents.tiles) {
+		writer.placements.push_back({ pack(position), writer.addTile(cachedTile) });
+	}
+	for (const auto &[position, zoneId] : contents.zones) {
+		writer.zones.push_back({ pack(position), zoneId });
+	}
+	for (const auto &town : contents.towns) {
+		writer.towns.push_back({ town.id, writer.addString(town.name), pack(town.templePosition) });
+	}
+	for (const auto &[name, position] : contents.waypoints) {
+		writer.waypoints.push_back({ writer.addString(name), pack(position) });
+	}
+
+	header.items = static_cast<uint32_t>(writer.items.size());
+	header.children = static_cast<uint32_t>(writer.children.size());
+	header.tiles = static_cast<uint32_t>(writer.tiles.size());
+	header.tileItems = static_cast<uint32_t>(writer.tileItems.size());
+	header.placements = static_cast<uint32_t>(writer.placements.size());
+	header.zones = static_cast<uint32_t>(writer.zones.size());
+	header.towns = static_cast<uint32_t>(writer.towns.size());
+	header.waypoints = static_cast<uint32_t>(writer.waypoints.size());
+	header.strings = writer.strings.size();
+
+	auto temporaryPath = path;
+	temporaryPath += ".tmp";
+	{
+		std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			g_logger().warn("[IOMapSnapshot::save] - Could not create {}", temporaryPath.string());
+			return false;
+		}
+
+		writeSection(file, std::vector<Header> { header });
+		writeSection(file, writer.items);
+		writeSection(file, writer.children);
+		writeSection(file, writer.tiles);
+		writeSection(file, writer.tileItems);
+		writeSection(file, writer.placements);
+		writeSection(file, writer.zones);
+		writeSection(file, writer.towns);
+		writeSection(file, writer.waypoints);
+		writeSection(file, writer.strings);
+
+		if (!file.flush()) {
+			g_logger().warn("[IOMapSnapshot::save] - Could not write {}", temporaryPath.string());
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error) {
+		g_logger().warn("[IOMapSnapshot::save] - Could not replace {}: {}", path.string(), error.message());
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+bool IOMapSnapshot::load(const std::filesystem::path &path, const Key &key, MapCache &cache, Contents &contents) {
+	std::error_code error;
+	if (!std::filesystem::exists(path, error)) {
+		return false;
+	}
+
+	mio::mmap_source source;
+	source.map(path.string(), error);
+	if (error) {
+		g_logger().warn("[IOMapSnapshot::load] - Could not map {}: {}", path.string(), error.message());
+		return false;
+	}
+
+	try {
+		Reader reader(source.data(), source.size());
+		const Header &header = reader.section<Header>(1)[0];
+		if (header.magic != MAGIC || header.version != FORMAT_VERSION) {
+			return false;
+		}
+		if (header.mapSize != key.mapSize || header.mapHash != key.mapHash || header.itemsHash != key.itemsHash || unpack(header.offset) != key.offset) {
+			return false;
+		}
+
+		const auto items = reader.section<PackedItem>(header.items);
+		const auto children = reader.section<uint32_t>(header.children);
+		const auto tiles = reader.section<PackedTile>(header.tiles);
+		const auto tileItems = reader.section<uint32_t>(header.tileItems);
+		const auto placements = reader.section<PackedPlacement>(header.placements);
+		const auto zones = reader.section<PackedZone>(header.zones);
+		const auto towns = reader.section<PackedTown>(header.towns);
+		const auto waypoints = reader.section<PackedWaypoint>(header.waypoints);
+		const auto strings = reader.section<char>(header.strings);
+		check(reader.atEnd(), "snapshot has trailing bytes");
+
+		// everything is checked before the cache is touched, so a corrupted image adds nothing to it
+		const auto checkString = [&strings](const StringRef &ref) {
+			check(ref.offset <= strings.size() && ref.size <= strings.size() - ref.offset, "snapshot string out of range");
+		};
+		const auto checkList = [](uint32_t first, uint32_t count, size_t size, const char* what) {
+			check(first <= size && count <= size - first, what);
+		};
+
+		checkString(header.monsterFile);
+		checkString(header.npcFile);
+		checkString(header.houseFile);
+		checkString(header.zonesFile);
+		for (size_t i = 0; i < items.size(); ++i) {
+			checkString(items[i].text);
+			checkList(items[i].firstChild, items[i].childCount, children.size(), "snapshot item children out of range");
+			// children come first, so every item only refers to items added before it
+			for (const uint32_t child : children.subspan(items[i].firstChild, items[i].childCount)) {
+				check(child < i, "snapshot item child out of order");
+			}
+		}
+		for (const auto &tile : tiles) {
+			check(tile.ground == NO_ITEM || tile.ground < items.size(), "snapshot ground out of range");
+			checkList(tile.firstItem, tile.itemCount, tileItems.size(), "snapshot tile items out of range");
+			for (const uint32_t item : tileItems.subspan(tile.firstItem, tile.itemCount)) {
+				check(item < items.size(), "snapshot tile item out of range");
+			}
+		}
+		for (const auto &placement : placements) {
+			check(placement.tile < tiles.size(), "snapshot placement out of range");
+		}
+		for (const auto &town : towns) {
+			checkString(town.name);
+		}
+		for (const auto &waypoint : waypoints) {
+			checkString(waypoint.name);
+		}
+
+		const auto getString = [&strings](const StringRef &ref) {
+			return std::string(strings.data() + ref.offset, ref.size);
+		};
+
+		// cache index of each item and tile of the image
+		std::vector<uint32_t> cachedItems;
+		cachedItems.reserve(items.size());
+		std::vector<uint32_t> list;
+		for (const auto &packed : items) {
+			CachedItem item;
+			item.text = cache.addCachedText(getString(packed.text));
+			item.id = packed.id;
+			item.charges = packed.charges;
+			item.actionId = packed.actionId;
+			item.uniqueId = packed.uniqueId;
+			item.destX = packed.destX;
+			item.destY = packed.destY;
+			item.doorOrDepotId = packed.doorOrDepotId;
+			item.destZ = packed.destZ;
+
+			list.clear();
+			for (const uint32_t child : children.subspan(packed.firstChild, packed.childCount)) {
+				list.emplace_back(cachedItems[child]);
+			}
+			cachedItems.emplace_back(cache.addCachedItem(item, list));
+		}
+
+		std::vector<uint32_t> cachedTiles;
+		cachedTiles.reserve(tiles.size());
+		for (const auto &packed : tiles) {
+			CachedTile tile;
+			tile.flags = packed.flags;
+			tile.houseId = packed.houseId;
+			tile.ground = packed.ground != NO_ITEM ? cachedItems[packed.ground] : 0;
+			tile.type = packed.type;
+			tile.isStatic = packed.isStatic != 0;
+
+			list.clear();
+			for (const uint32_t item : tileItems.subspan(packed.firstItem, packed.itemCount)) {
+				list.emplace_back(cachedItems[item]);
+			}
+			cachedTiles.emplace_back(cache.addCachedTile(tile, list));
+		}
+
+		Contents loaded;
+		loaded.width = header.width;
+		loaded.height = header.height;
+		loaded.monsterFile = getString(header.monsterFile);
+		loaded.npcFile = getString(header.npcFile);
+		loaded.houseFile = getString(header.houseFile);
+		loaded.zonesFile = getString(header.zonesFile);
+
+		loaded.tiles.reserve(placements.size());
+		for (const auto &placement : placements) {
+			loaded.tiles.emplace_back(unpack(placement.position), cachedTiles[placement.tile]);
+		}
+
+		loaded.zones.reserve(zones.size());
+		for (const auto &zone : zones) {
+			loaded.zones.emplace_back(unpack(zone.position), zone.zoneId);
+		}
+
+		loaded.towns.reserve(towns.size());
+		for (const auto &town : towns) {
+			loaded.towns.push_back({ town.id, getString(town.name), unpack(town.templePosition) });
+		}
+
+		loaded.waypoints.reserve(waypoints.size());
+		for (const auto &waypoint : waypoints) {
+			loaded.waypoints.emplace_back(getString(waypoint.name), unpack(waypoint.position));
+		}
+
+		contents = std::move(loaded);
+		return true;
+	} catch (const std::out_of_range &e) {
+		g_logger().warn("[IOMapSnapshot::load] - Ignoring corrupted snapshot {}: {}", path.string(), e.what());
+		return false;
+	}
+}
@@ -0,0 +1,74 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "game/movement/position.hpp"
+
+class MapCache;
+
+/**
+ * Compiled image of what IOMap reads from an OTBM file: the tiles with their deduplicated items,
+ * the house and zone tiles, the towns, the waypoints and the names of the external files.
+ * It is written next to the map after it was parsed and mapped on the next boots instead of
+ * parsing it again, as long as the map file and the item types it was compiled with are the same.
+ * The image is made of flat arrays of fixed size records that index each other, the same records
+ * the map cache keeps, so reading it only appends them to the cache arenas.
+ */
+class IOMapSnapshot {
+public:
+	// bumped whenever the layout of the image changes, older images are ignored
+	static constexpr uint32_t FORMAT_VERSION = 1;
+
+	// What an image was compiled from
+	struct Key {
+		uint64_t mapSize = 0;
+		uint64_t mapHash = 0;
+		// of the item type properties the map parser depends on
+		uint64_t itemsHash = 0;
+		Position offset;
+
+		bool operator==(const Key &) const = default;
+	};
+
+	struct Town {
+		uint32_t id = 0;
+		std::string name;
+		Position templePosition;
+	};
+
+	struct Contents {
+		uint16_t width = 0;
+		uint16_t height = 0;
+		// relative to the map folder, empty when the map does not name them
+		std::string monsterFile;
+		std::string npcFile;
+		std::string houseFile;
+		std::string zonesFile;
+
+		// tiles of the map cache in file order, the empty house tiles too
+		std::vector<std::pair<Position, uint32_t>> tiles;
+		std::vector<std::pair<Position, uint16_t>> zones;
+		std::vector<Town> towns;
+		std::vector<std::pair<std::string, Position>> waypoints;
+	};
+
+	static Key makeKey(const uint8_t* mapData, size_t mapSize, const Position &offset);
+
+	static std::filesystem::path getPath(const std::filesystem::path &mapPath) {
+		auto path = mapPath;
+		path += ".snapshot";
+		return path;
+	}
+
+	// Writes to a temporary file first, so a crash never leaves a partial image behind
+	static bool save(const std::filesystem::path &path, const Key &key, const MapCache &cache, const Contents &contents);
+	// Adds the tiles to the cache, false when there is no image, it is from another map or version or it is corrupted
+	static bool load(const std::filesystem::path &path, const Key &key, MapCache &cache, Contents &contents);
+};
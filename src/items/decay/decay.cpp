@@ -13,6 +13,9 @@
 #include "game/game.hpp"
 #include "game/scheduling/dispatcher.hpp"
 
+Decay::Decay() :
+	wheel(EVENT_DECAYINTERVAL) { }
+
 void Decay::startDecay(std::shared_ptr<Item> item) {
 	if (!item) {
 		return;
@@ -39,89 +42,57 @@ void Decay::startDecay(std::shared_ptr<Item> item) {
 			stopDecay(item);
 		}
 
-		int64_t timestamp = OTSYS_TIME() + duration;
-		if (decayMap.empty()) {
-			eventId = g_dispatcher().scheduleEvent(std::max<int32_t>(SCHEDULER_MINTICKS, duration), std::bind(&Decay::checkDecay, this), "Decay::checkDecay");
-		} else {
-			if (timestamp < decayMap.begin()->first) {
-				g_dispatcher().stopEvent(eventId);
-				eventId = g_dispatcher().scheduleEvent(std::max<int32_t>(SCHEDULER_MINTICKS, duration), std::bind(&Decay::checkDecay, this), "Decay::checkDecay");
-			}
+		if (eventId == 0) {
+			wheel.start(OTSYS_TIME());
+			eventId = g_dispatcher().cycleEvent(EVENT_DECAYINTERVAL, std::bind(&Decay::checkDecay, this), "Decay::checkDecay");
 		}
 
+		int64_t timestamp = OTSYS_TIME() + duration;
 		item->setDecaying(DECAYING_TRUE);
 		item->setAttribute(ItemAttribute_t::DURATION_TIMESTAMP, timestamp);
-		decayMap[timestamp].push_back(item);
+		item->decayHandle = wheel.schedule(std::shared_ptr<Item>(item), timestamp);
 	}
 }
 
 void Decay::stopDecay(std::shared_ptr<Item> item) {
-	if (item->hasAttribute(ItemAttribute_t::DECAYSTATE)) {
-		auto timestamp = item->getAttribute<int64_t>(ItemAttribute_t::DURATION_TIMESTAMP);
-		if (item->hasAttribute(ItemAttribute_t::DURATION_TIMESTAMP)) {
-			auto it = decayMap.find(timestamp);
-			if (it != decayMap.end()) {
-				auto &decayItems = it->second;
-
-				size_t i = 0, end = decayItems.size();
-				auto decayItem = decayItems[i];
-				if (end == 1) {
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayMap.erase(it);
-					}
-					return;
-				}
-				while (i < end) {
-					decayItem = decayItems[i];
-					if (item == decayItem) {
-						if (item->hasAttribute(ItemAttribute_t::DURATION)) {
-							// Incase we removed duration attribute don't assign new duration
-							item->setDuration(item->getDuration());
-						}
-						item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-
-						decayItems[i] = decayItems.back();
-						decayItems.pop_back();
-						return;
-					}
-					++i;
-				}
-			}
-			item->removeAttribute(ItemAttribute_t::DURATION_TIMESTAMP);
-		} else {
-			item->removeAttribute(ItemAttribute_t::DECAYSTATE);
-		}
+	if (!item->hasAttribute(ItemAttribute_t::DECAYSTATE)) {
+		return;
 	}
-}
-
-void Decay::checkDecay() {
-	int64_t timestamp = OTSYS_TIME();
-
-	std::vector<std::shared_ptr<Item>> tempItems;
-	tempItems.reserve(32); // Small preallocation
 
-	auto it = decayMap.begin(), end = decayMap.end();
-	while (it != end) {
-		if (it->first > timestamp) {
-			break;
-		}
+	if (!item->hasAttribute(ItemAttribute_t::DURATION_TIMESTAMP)) {
+		item->removeAttribute(ItemAttribute_t::DECAYSTATE);
+		return;
+	}
 
-		// Iterating here is unsafe so let's copy our items into temporary vector
-		auto &decayItems = it->second;
-		tempItems.reserve(tempItems.size() + decayItems.size());
-		for (auto &decayItem : decayItems) {
-			tempItems.push_back(decayItem);
+	// the handle is only trusted while its slot still holds this item
+	const auto scheduled = wheel.get(item->decayHandle);
+	if (scheduled && *scheduled == item) {
+		wheel.cancel(item->decayHandle);
+		item->decayHandle = 0;
+		if (item->hasAttribute(ItemAttribute_t::DURATION)) {
+			// Incase we removed duration attribute don't assign new duration
+			item->setDuration(item->getDuration());
 		}
-		it = decayMap.erase(it);
+		item->removeAttribute(ItemAttribute_t::DECAYSTATE);
+		return;
 	}
 
-	for (const auto &item : tempItems) {
+	item->removeAttribute(ItemAttribute_t::DURATION_TIMESTAMP);
+}
+
+void Decay::checkDecay() {
+	// Decaying changes the wheel, so the expired items are taken out of it first
+	wheel.advance(OTSYS_TIME(), [this](std::shared_ptr<Item> &item) {
+		item->decayHandle = 0;
+		expired.emplace_back(std::move(item));
+	});
+
+	++ticks;
+	lastTickDecayed = expired.size();
+	decayed += lastTickDecayed;
+	maxTickDecayed = std::max(maxTickDecayed, lastTickDecayed);
+
+	for (const auto &item : expired) {
 		if (!item->canDecay()) {
 			item->setDuration(item->getDuration());
 			item->setDecaying(DECAYING_FALSE);
@@ -130,10 +101,24 @@ void Decay::checkDecay() {
 			internalDecayItem(item);
 		}
 	}
+	expired.clear();
+}
 
-	if (it != end) {
-		eventId = g_dispatcher().scheduleEvent(std::max<int32_t>(SCHEDULER_MINTICKS, static_cast<int32_t>(it->first - timestamp)), std::bind(&Decay::checkDecay, this), "Decay::checkDecay");
-	}
+Decay::Stats Decay::getStats() const {
+	return {
+		ticks,
+		decayed,
+		lastTickDecayed,
+		maxTickDecayed,
+		wheel.size(),
+	};
+}
+
+void Decay::resetStats() {
+	ticks = 0;
+	decayed = 0;
+	lastTickDecayed = 0;
+	maxTickDecayed = 0;
 }
 
 void Decay::internalDecayItem(std::shared_ptr<Item> item) {
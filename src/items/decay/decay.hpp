@@ -10,10 +10,17 @@
 #pragma once
 
 #include "items/item.hpp"
+#include "utils/timing_wheel.hpp"
 
+/**
+ * Items counting down to their decay, dispatcher only.
+ * They wait in a timing wheel with buckets as long as the decay tick and each item keeps the
+ * handle of its slot, so stopping a decay is O(1). A single dispatcher event runs every tick and
+ * decays the items of the buckets that expired in bulk, so an item decays at most a tick late.
+ */
 class Decay {
 public:
-	Decay() = default;
+	Decay();
 
 	Decay(const Decay &) = delete;
 	void operator=(const Decay &) = delete;
@@ -25,13 +32,31 @@ public:
 	void startDecay(std::shared_ptr<Item> item);
 	void stopDecay(std::shared_ptr<Item> item);
 
+	struct Stats {
+		uint64_t ticks = 0;
+		uint64_t decayed = 0;
+		uint64_t lastTickDecayed = 0;
+		uint64_t maxTickDecayed = 0;
+		// items waiting in the wheel buckets
+		size_t pending = 0;
+	};
+
+	Stats getStats() const;
+	void resetStats();
+
 private:
 	void checkDecay();
 	void internalDecayItem(std::shared_ptr<Item> item);
 
-	uint32_t eventId { 0 };
-	// order is important, so we use an std::map
-	std::map<int64_t, std::vector<std::shared_ptr<Item>>> decayMap;
+	uint64_t eventId { 0 };
+	stdext::timing_wheel<std::shared_ptr<Item>> wheel;
+	// the items of a tick, reused by the next ones
+	std::vector<std::shared_ptr<Item>> expired;
+
+	uint64_t ticks = 0;
+	uint64_t decayed = 0;
+	uint64_t lastTickDecayed = 0;
+	uint64_t maxTickDecayed = 0;
 };
 
 constexpr auto g_decay = Decay::getInstance;
@@ -372,6 +372,11 @@ void Item::setSubType(uint16_t n) {
 	} else {
 		setItemCount(n);
 	}
+
+	// the count and the fluid are part of what the clients see of the tile
+	if (const auto &tile = getTile()) {
+		tile->onItemsChanged();
+	}
 }
 
 Attr_ReadValue Item::readAttr(AttrTypes_t attr, PropStream &propStream) {
@@ -688,6 +688,8 @@ protected:
 	bool loadedFromMap = false;
 	bool isLootTrackeable = false;
 	bool decayDisabled = false;
+	// slot of the item in the Decay wheel while it decays
+	uint64_t decayHandle = 0;
 
 private:
 	void setImbuement(uint8_t slot, uint16_t imbuementId, uint32_t duration);
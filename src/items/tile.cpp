@@ -25,6 +25,11 @@
 auto real_nullptr_tile = std::make_shared<StaticTile>(0xFFFF, 0xFFFF, 0xFF);
 const std::shared_ptr<Tile> &Tile::nullptr_tile = real_nullptr_tile;
 
+namespace {
+	// Map loading may add items outside of the dispatcher
+	std::atomic_uint32_t lastItemsVersion = 0;
+}
+
 bool Tile::hasProperty(ItemProperty prop) const {
 	switch (prop) {
 		case CONST_PROP_BLOCKSOLID:
@@ -353,6 +358,8 @@ std::shared_ptr<Thing> Tile::getTopVisibleThing(std::shared_ptr<Creature> creatu
 }
 
 void Tile::onAddTileItem(std::shared_ptr<Item> item) {
+	onItemsChanged();
+
 	if ((item->hasProperty(CONST_PROP_MOVEABLE) || item->getContainer()) || (item->isWrapable() && !item->hasProperty(CONST_PROP_MOVEABLE) && !item->hasProperty(CONST_PROP_BLOCKPATH))) {
 		auto it = g_game().browseFields.find(static_self_cast<Tile>());
 		if (it != g_game().browseFields.end()) {
@@ -426,6 +433,8 @@ void Tile::onAddTileItem(std::shared_ptr<Item> item) {
 }
 
 void Tile::onUpdateTileItem(std::shared_ptr<Item> oldItem, const ItemType &oldType, std::shared_ptr<Item> newItem, const ItemType &newType) {
+	onItemsChanged();
+
 	if ((newItem->hasProperty(CONST_PROP_MOVEABLE) || newItem->getContainer()) || (newItem->isWrapable() && newItem->hasProperty(CONST_PROP_MOVEABLE) && !oldItem->hasProperty(CONST_PROP_BLOCKPATH))) {
 		auto it = g_game().browseFields.find(getTile());
 		if (it != g_game().browseFields.end()) {
@@ -468,6 +477,8 @@ void Tile::onUpdateTileItem(std::shared_ptr<Item> oldItem, const ItemType &oldTy
 }
 
 void Tile::onRemoveTileItem(const CreatureVector &spectators, const std::vector<int32_t> &oldStackPosVector, std::shared_ptr<Item> item) {
+	onItemsChanged();
+
 	if ((item->hasProperty(CONST_PROP_MOVEABLE) || item->getContainer()) || (item->isWrapable() && !item->hasProperty(CONST_PROP_MOVEABLE) && !item->hasProperty(CONST_PROP_BLOCKPATH))) {
 		auto it = g_game().browseFields.find(getTile());
 		if (it != g_game().browseFields.end()) {
@@ -550,7 +561,13 @@ void Tile::onRemoveTileItem(const CreatureVector &spectators, const std::vector<
 	}
 }
 
+void Tile::onItemsChanged() {
+	itemsVersion = lastItemsVersion.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
 void Tile::onUpdateTile(const CreatureVector &spectators) {
+	onItemsChanged();
+
 	const Position &cylinderMapPos = getPosition();
 
 	// send to clients
@@ -957,7 +974,7 @@ void Tile::addThing(int32_t, std::shared_ptr<Thing> thing) {
 
 	std::shared_ptr<Creature> creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
+		Spectators::clearCache(tilePos);
 		creature->setParent(static_self_cast<Tile>());
 
 		CreatureVector* creatures = makeCreatures();
@@ -1156,7 +1173,7 @@ void Tile::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 		if (creatures) {
 			auto it = std::find(creatures->begin(), creatures->end(), thing);
 			if (it != creatures->end()) {
-				Spectators::clearCache();
+				Spectators::clearCache(tilePos);
 				creatures->erase(it);
 			}
 		}
@@ -1236,6 +1253,9 @@ void Tile::removeThing(std::shared_ptr<Thing> thing, uint32_t count) {
 
 void Tile::removeCreature(std::shared_ptr<Creature> creature) {
 	g_game().map.getQTNode(tilePos.x, tilePos.y)->removeCreature(creature);
+	if (creature->getPlayer()) {
+		g_game().map.sectorActivity.removePlayer(creature.get());
+	}
 	removeThing(creature, 0);
 }
 
@@ -1546,7 +1566,7 @@ void Tile::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 
 	std::shared_ptr<Creature> creature = thing->getCreature();
 	if (creature) {
-		Spectators::clearCache();
+		Spectators::clearCache(tilePos);
 
 		CreatureVector* creatures = makeCreatures();
 		creatures->insert(creatures->begin(), creature);
@@ -1561,6 +1581,7 @@ void Tile::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 			if (ground == nullptr) {
 				ground = item;
 				setTileFlags(item);
+				onItemsChanged();
 			}
 			return;
 		}
@@ -1589,12 +1610,15 @@ void Tile::internalAddThing(uint32_t, std::shared_ptr<Thing> thing) {
 		}
 
 		setTileFlags(item);
+		onItemsChanged();
 	}
 }
 
 void Tile::updateTileFlags(const std::shared_ptr<Item> &item) {
 	resetTileFlags(item);
 	setTileFlags(item);
+	// whatever attribute changed may be one the clients see
+	onItemsChanged();
 }
 
 void Tile::setTileFlags(const std::shared_ptr<Item> &item) {
@@ -253,8 +253,16 @@ public:
 		if (ground = item) {
 			setTileFlags(item);
 		}
+		onItemsChanged();
 	}
 
+	// Changes whenever an item of the tile is added, updated or removed, unique among all tiles
+	uint32_t getItemsVersion() const {
+		return itemsVersion;
+	}
+	// Also for items changed without going through the tile, e.g. the count or fluid of one set directly
+	void onItemsChanged();
+
 private:
 	void onAddTileItem(std::shared_ptr<Item> item);
 	void onUpdateTileItem(std::shared_ptr<Item> oldItem, const ItemType &oldType, std::shared_ptr<Item> newItem, const ItemType &newType);
@@ -270,6 +278,7 @@ protected:
 	std::shared_ptr<Item> ground = nullptr;
 	Position tilePos;
 	uint32_t flags = 0;
+	uint32_t itemsVersion = 0;
 	phmap::flat_hash_set<std::shared_ptr<Zone>> zones;
 };
 
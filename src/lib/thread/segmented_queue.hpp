@@ -0,0 +1,120 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+/**
+ * Unbounded wait-free queue for one producer thread and one consumer thread.
+ * Items are stored in fixed-size segments, a segment is published item by item and,
+ * once the consumer is done with it, handed back to the producer to be reused,
+ * so in steady state pushing does not allocate.
+ * Items are consumed in the same order they were pushed.
+ */
+template <typename T, size_t SegmentSize = 256>
+class SegmentedQueue {
+public:
+	SegmentedQueue() :
+		head(new Segment()), tail(head) { }
+
+	~SegmentedQueue() {
+		while (head) {
+			delete std::exchange(head, head->next.load(std::memory_order_relaxed));
+		}
+		delete spare.load(std::memory_order_relaxed);
+	}
+
+	// Ensures that we don't accidentally copy it
+	SegmentedQueue(const SegmentedQueue &) = delete;
+	SegmentedQueue &operator=(const SegmentedQueue &) = delete;
+
+	// Producer only.
+	template <typename... Args>
+	void emplace(Args &&... args) {
+		auto index = tailIndex;
+		if (index == SegmentSize) {
+			auto* segment = spare.exchange(nullptr, std::memory_order_acquire);
+			if (!segment) {
+				segment = new Segment();
+			}
+
+			tail->next.store(segment, std::memory_order_release);
+			tail = segment;
+			index = 0;
+		}
+
+		tail->items[index].emplace(std::forward<Args>(args)...);
+		tailIndex = index + 1;
+		tail->written.store(tailIndex, std::memory_order_release);
+	}
+
+	// Consumer only, hands every published item to fn(T &&) and returns how many there were.
+	template <typename F>
+	size_t consume(F &&fn) {
+		size_t consumed = 0;
+		while (true) {
+			const auto written = head->written.load(std::memory_order_acquire);
+			for (; headIndex < written; ++headIndex) {
+				auto &item = head->items[headIndex];
+				fn(std::move(*item));
+				item.reset();
+				++consumed;
+			}
+
+			if (headIndex < SegmentSize) {
+				return consumed;
+			}
+
+			auto* next = head->next.load(std::memory_order_acquire);
+			if (!next) {
+				return consumed;
+			}
+
+			recycle(std::exchange(head, next));
+			headIndex = 0;
+		}
+	}
+
+	// Consumer only, may miss items that are being published at the same time.
+	bool empty() const {
+		if (headIndex < head->written.load(std::memory_order_acquire)) {
+			return false;
+		}
+
+		return headIndex < SegmentSize || !head->next.load(std::memory_order_acquire);
+	}
+
+private:
+	struct Segment {
+		std::array<std::optional<T>, SegmentSize> items;
+		std::atomic<Segment*> next = nullptr;
+		std::atomic_size_t written = 0;
+	};
+
+	void recycle(Segment* segment) {
+		segment->next.store(nullptr, std::memory_order_relaxed);
+		segment->written.store(0, std::memory_order_relaxed);
+		// keep a single spare segment, the rest is released
+		delete spare.exchange(segment, std::memory_order_release);
+	}
+
+	// consumer side
+	alignas(64) Segment* head;
+	size_t headIndex = 0;
+
+	// producer side
+	alignas(64) Segment* tail;
+	size_t tailIndex = 0;
+
+	std::atomic<Segment*> spare = nullptr;
+};
@@ -31,6 +31,11 @@ void ThreadPool::start() {
 	 */
 	nThreads = std::max<uint16_t>(static_cast<int>(getNumberOfCores()), DEFAULT_NUMBER_OF_THREADS);
 
+	// one deque per thread id, the extra one is for the thread that owns the pool (same as the dispatcher)
+	for (std::size_t i = 0; i <= nThreads; ++i) {
+		workers.emplace_back(std::make_unique<Worker>());
+	}
+
 	for (std::size_t i = 0; i < nThreads; ++i) {
 		threads.emplace_back([this] { ioService.run(); });
 	}
@@ -45,6 +50,11 @@ void ThreadPool::shutdown() {
 
 	logger.info("Shutting down thread pool...");
 
+	const auto stats = getWorkerStats();
+	for (std::size_t i = 0; i < stats.size(); ++i) {
+		logger.debug("Worker {}: executed {} chunks, {} stolen, {} failed steals.", i, stats[i].executed, stats[i].stolen, stats[i].failedSteals);
+	}
+
 	ioService.stop();
 
 	for (std::size_t i = 0; i < threads.size(); i++) {
@@ -70,3 +80,130 @@ void ThreadPool::addLoad(const std::function<void(void)> &load) {
 		load();
 	});
 }
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t begin, size_t end)> &fn, size_t chunkSize) {
+	if (count == 0) {
+		return;
+	}
+
+	if (chunkSize == 0) {
+		chunkSize = std::max<size_t>(1, count / (static_cast<size_t>(nThreads) * 4));
+	}
+
+	auto* self = getWorker();
+	if (!self || count <= chunkSize || ioService.stopped()) {
+		fn(0, count);
+		return;
+	}
+
+	ParallelBatch batch { fn };
+	batch.jobs.reserve((count + chunkSize - 1) / chunkSize);
+	for (size_t begin = 0; begin < count; begin += chunkSize) {
+		batch.jobs.emplace_back(&batch, begin, std::min(begin + chunkSize, count));
+	}
+	batch.pending.store(batch.jobs.size(), std::memory_order_relaxed);
+
+	// chunks that do not fit in the deque are executed by the caller
+	size_t pushed = 0;
+	while (pushed < batch.jobs.size() && self->deque.push(&batch.jobs[pushed])) {
+		++pushed;
+	}
+
+	// one asio handler per helper instead of one per task, helpers leave as soon as there is nothing to steal
+	const auto helpers = std::min<size_t>(nThreads, pushed);
+	for (size_t i = 0; i < helpers; ++i) {
+		asio::post(ioService, [this] { helpParallel(); });
+	}
+
+	for (size_t i = pushed; i < batch.jobs.size(); ++i) {
+		runJob(&batch.jobs[i], self);
+	}
+
+	// help until every chunk is done, the batch lives on this stack so nobody can be left touching it
+	while (batch.pending.load(std::memory_order_acquire) != 0) {
+		if (auto* job = findJob(self)) {
+			runJob(job, self);
+		} else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+std::vector<ThreadPool::WorkerStats> ThreadPool::getWorkerStats() const {
+	std::vector<WorkerStats> stats;
+	stats.reserve(workers.size());
+	for (const auto &worker : workers) {
+		stats.emplace_back(
+			worker->executed.load(std::memory_order_relaxed),
+			worker->stolen.load(std::memory_order_relaxed),
+			worker->failedSteals.load(std::memory_order_relaxed)
+		);
+	}
+	return stats;
+}
+
+void ThreadPool::resetWorkerStats() {
+	for (const auto &worker : workers) {
+		worker->executed.store(0, std::memory_order_relaxed);
+		worker->stolen.store(0, std::memory_order_relaxed);
+		worker->failedSteals.store(0, std::memory_order_relaxed);
+	}
+}
+
+ThreadPool::Worker* ThreadPool::getWorker() const {
+	const auto id = getThreadId();
+	if (id < 0 || static_cast<size_t>(id) >= workers.size()) {
+		return nullptr;
+	}
+
+	return workers[id].get();
+}
+
+ThreadPool::ParallelJob* ThreadPool::findJob(Worker* self) {
+	if (self) {
+		if (auto* job = self->deque.pop()) {
+			return job;
+		}
+	}
+
+	const auto size = workers.size();
+	const auto start = static_cast<size_t>(std::max<int16_t>(getThreadId(), 0));
+	for (size_t i = 1; i <= size; ++i) {
+		auto* victim = workers[(start + i) % size].get();
+		if (victim == self || victim->deque.empty()) {
+			continue;
+		}
+
+		if (auto* job = victim->deque.steal()) {
+			if (self) {
+				self->stolen.fetch_add(1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+		if (self) {
+			self->failedSteals.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	return nullptr;
+}
+
+void ThreadPool::runJob(ParallelJob* job, Worker* self) const {
+	auto* batch = job->batch;
+	batch->fn(job->begin, job->end);
+
+	if (self) {
+		self->executed.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// last access to the batch, the owner may return right after this
+	batch->pending.fetch_sub(1, std::memory_order_release);
+}
+
+void ThreadPool::helpParallel() {
+	auto* self = getWorker();
+	while (auto* job = findJob(self)) {
+		runJob(job, self);
+	}
+}
@@ -9,6 +9,7 @@
 #pragma once
 
 #include "lib/logging/logger.hpp"
+#include "lib/thread/work_stealing_deque.hpp"
 
 class ThreadPool {
 public:
@@ -23,6 +24,22 @@ public:
 	asio::io_context &getIoContext();
 	void addLoad(const std::function<void(void)> &load);
 
+	/**
+	 * Splits [0, count) in chunks and runs them on the pool through the work-stealing deques.
+	 * The calling thread works on the chunks as well and only returns once all of them are done.
+	 * A chunkSize of 0 picks one that gives every thread a few chunks to balance.
+	 */
+	void parallelFor(size_t count, const std::function<void(size_t begin, size_t end)> &fn, size_t chunkSize = 0);
+
+	struct WorkerStats {
+		uint64_t executed = 0;
+		uint64_t stolen = 0;
+		uint64_t failedSteals = 0;
+	};
+
+	std::vector<WorkerStats> getWorkerStats() const;
+	void resetWorkerStats();
+
 	uint16_t getNumberOfThreads() const {
 		return nThreads;
 	}
@@ -40,10 +57,37 @@ public:
 	};
 
 private:
+	struct ParallelBatch;
+
+	struct ParallelJob {
+		ParallelBatch* batch = nullptr;
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+	struct ParallelBatch {
+		const std::function<void(size_t, size_t)> &fn;
+		std::vector<ParallelJob> jobs;
+		std::atomic_size_t pending = 0;
+	};
+
+	struct Worker {
+		WorkStealingDeque<ParallelJob*> deque;
+		std::atomic_uint64_t executed = 0;
+		std::atomic_uint64_t stolen = 0;
+		std::atomic_uint64_t failedSteals = 0;
+	};
+
+	Worker* getWorker() const;
+	ParallelJob* findJob(Worker* self);
+	void runJob(ParallelJob* job, Worker* self) const;
+	void helpParallel();
+
 	Logger &logger;
 	asio::io_context ioService;
 	std::vector<std::jthread> threads;
 	asio::io_context::work work { ioService };
+	std::vector<std::unique_ptr<Worker>> workers;
 
 	uint16_t nThreads = 0;
 };
@@ -40,6 +40,7 @@ void ConfigFunctions::init(lua_State* L) {
 	registerEnumIn(L, "configKeys", WARN_UNSAFE_SCRIPTS);
 	registerEnumIn(L, "configKeys", CONVERT_UNSAFE_SCRIPTS);
 	registerEnumIn(L, "configKeys", ALLOW_BLOCK_SPAWN);
+	registerEnumIn(L, "configKeys", TOGGLE_DORMANT_SPAWNS);
 	registerEnumIn(L, "configKeys", CLASSIC_ATTACK_SPEED);
 	registerEnumIn(L, "configKeys", REMOVE_WEAPON_AMMO);
 	registerEnumIn(L, "configKeys", REMOVE_WEAPON_CHARGES);
@@ -58,6 +59,7 @@ void ConfigFunctions::init(lua_State* L) {
 	registerEnumIn(L, "configKeys", GLOBAL_SERVER_SAVE_SHUTDOWN);
 	registerEnumIn(L, "configKeys", MAP_NAME);
 	registerEnumIn(L, "configKeys", TOGGLE_MAP_CUSTOM);
+	registerEnumIn(L, "configKeys", TOGGLE_MAP_SNAPSHOT);
 	registerEnumIn(L, "configKeys", MAP_CUSTOM_NAME);
 	registerEnumIn(L, "configKeys", HOUSE_RENT_PERIOD);
 	registerEnumIn(L, "configKeys", SERVER_NAME);
@@ -14,12 +14,14 @@
 #include "game/functions/game_reload.hpp"
 #include "game/game.hpp"
 #include "items/item.hpp"
+#include "items/decay/decay.hpp"
 #include "io/iobestiary.hpp"
 #include "io/io_bosstiary.hpp"
 #include "io/iologindata.hpp"
 #include "lua/functions/core/game/game_functions.hpp"
 #include "lua/functions/events/event_callback_functions.hpp"
 #include "game/scheduling/dispatcher.hpp"
+#include "game/scheduling/task_metrics.hpp"
 #include "lua/creature/talkaction.hpp"
 #include "lua/functions/creatures/npc/npc_type_functions.hpp"
 #include "lua/scripts/lua_environment.hpp"
@@ -27,6 +29,11 @@
 #include "lua/callbacks/event_callback.hpp"
 #include "lua/callbacks/events_callbacks.hpp"
 #include "map/spectators.hpp"
+#include "map/utils/pathfinder.hpp"
+#include "server/network/message/outputmessage.hpp"
+#include "server/network/message/broadcastmessage.hpp"
+#include "server/network/protocol/known_creatures.hpp"
+#include "server/network/protocol/tile_description_cache.hpp"
 
 // Game
 int GameFunctions::luaGameCreateMonsterType(lua_State* L) {
@@ -782,3 +789,247 @@ int GameFunctions::luaGameGetEventCallbacks(lua_State* L) {
 	lua_pop(L, 1);
 	return 1;
 }
+
+int GameFunctions::luaGameGetTaskMetrics(lua_State* L) {
+	// Game.getTaskMetrics([limit = 0])
+	auto summaries = g_taskMetrics().getSummaries();
+	const auto limit = getNumber<size_t>(L, 1, 0);
+	if (limit > 0 && summaries.size() > limit) {
+		summaries.resize(limit);
+	}
+
+	lua_createtable(L, static_cast<int>(summaries.size()), 0);
+
+	int index = 0;
+	for (const auto &summary : summaries) {
+		lua_createtable(L, 0, 9);
+		setField(L, "context", summary.context);
+		setField(L, "count", static_cast<lua_Number>(summary.count));
+		setField(L, "waitP50", summary.waitP50);
+		setField(L, "waitP99", summary.waitP99);
+		setField(L, "waitMax", summary.waitMax);
+		setField(L, "runP50", summary.runP50);
+		setField(L, "runP99", summary.runP99);
+		setField(L, "runMax", summary.runMax);
+		setField(L, "runTotal", summary.runTotal);
+		lua_rawseti(L, -2, ++index);
+	}
+	return 1;
+}
+
+int GameFunctions::luaGameDumpTaskMetrics(lua_State* L) {
+	// Game.dumpTaskMetrics([limit = 0])
+	g_taskMetrics().dump(getNumber<size_t>(L, 1, 0));
+	pushBoolean(L, true);
+	return 1;
+}
+
+int GameFunctions::luaGameResetTaskMetrics(lua_State* L) {
+	// Game.resetTaskMetrics()
+	g_taskMetrics().reset();
+	pushBoolean(L, true);
+	return 1;
+}
+
+const std::vector<GameFunctions::PerfStats> &GameFunctions::getPerfStatsRegistry() {
+	static const std::vector<PerfStats> registry = {
+		{
+			"spectatorsCache",
+			[](lua_State* L) {
+				const auto stats = Spectators::getCacheStats();
+				lua_createtable(L, 0, 4);
+				setField(L, "hits", static_cast<lua_Number>(stats.hits));
+				setField(L, "misses", static_cast<lua_Number>(stats.misses));
+				setField(L, "evictions", static_cast<lua_Number>(stats.evictions));
+				setField(L, "entries", static_cast<lua_Number>(stats.entries));
+			},
+			[] { Spectators::resetCacheStats(); },
+		},
+		{
+			"pathfinder",
+			[](lua_State* L) {
+				const auto stats = g_pathfinder().getStats();
+				lua_createtable(L, 0, 8);
+				setField(L, "requested", static_cast<lua_Number>(stats.requested));
+				setField(L, "coalesced", static_cast<lua_Number>(stats.coalesced));
+				setField(L, "superseded", static_cast<lua_Number>(stats.superseded));
+				setField(L, "completed", static_cast<lua_Number>(stats.completed));
+				setField(L, "discarded", static_cast<lua_Number>(stats.discarded));
+				setField(L, "searchTime", static_cast<lua_Number>(stats.searchTime) / 1000.);
+				setField(L, "captureTime", static_cast<lua_Number>(stats.captureTime) / 1000.);
+				setField(L, "inFlight", static_cast<lua_Number>(stats.inFlight));
+			},
+			[] { g_pathfinder().resetStats(); },
+		},
+		{
+			"outputMessagePool",
+			[](lua_State* L) {
+				const auto stats = OutputMessagePool::getStats();
+				lua_createtable(L, 0, 5);
+				setField(L, "inUse", static_cast<lua_Number>(stats.inUse));
+				setField(L, "highWater", static_cast<lua_Number>(stats.highWater));
+				setField(L, "hits", static_cast<lua_Number>(stats.hits));
+				setField(L, "misses", static_cast<lua_Number>(stats.misses));
+				setField(L, "retained", static_cast<lua_Number>(stats.retained));
+			},
+			[] { OutputMessagePool::resetStats(); },
+		},
+		{
+			"connectionWrite",
+			[](lua_State* L) {
+				const auto stats = Connection::getWriteStats();
+				const auto writes = std::max<uint64_t>(stats.writes, 1);
+				lua_createtable(L, 0, 6);
+				setField(L, "writes", static_cast<lua_Number>(stats.writes));
+				setField(L, "messages", static_cast<lua_Number>(stats.messages));
+				setField(L, "bytes", static_cast<lua_Number>(stats.bytes));
+				setField(L, "bytesPerWrite", static_cast<lua_Number>(stats.bytes) / writes);
+				setField(L, "messagesPerWrite", static_cast<lua_Number>(stats.messages) / writes);
+				setField(L, "overflows", static_cast<lua_Number>(stats.overflows));
+			},
+			[] { Connection::resetWriteStats(); },
+		},
+		{
+			"broadcast",
+			[](lua_State* L) {
+				const auto stats = BroadcastMessage::getStats();
+				lua_createtable(L, 0, 3);
+				setField(L, "serialized", static_cast<lua_Number>(stats.serialized));
+				setField(L, "sent", static_cast<lua_Number>(stats.sent));
+				setField(L, "sentPerSerialized", static_cast<lua_Number>(stats.sent) / std::max<uint64_t>(stats.serialized, 1));
+			},
+			[] { BroadcastMessage::resetStats(); },
+		},
+		{
+			"tileDescriptionCache",
+			[](lua_State* L) {
+				const auto stats = g_tileDescriptionCache().getStats();
+				lua_createtable(L, 0, 4);
+				setField(L, "hits", static_cast<lua_Number>(stats.hits));
+				setField(L, "builds", static_cast<lua_Number>(stats.builds));
+				setField(L, "uncacheable", static_cast<lua_Number>(stats.uncacheable));
+				setField(L, "descriptions", static_cast<lua_Number>(stats.descriptions));
+			},
+			[] { g_tileDescriptionCache().resetStats(); },
+		},
+		{
+			"knownCreatures",
+			[](lua_State* L) {
+				const auto stats = KnownCreatures::getStats();
+				lua_createtable(L, 0, 5);
+				setField(L, "added", static_cast<lua_Number>(stats.added));
+				setField(L, "evictions", static_cast<lua_Number>(stats.evictions));
+				setField(L, "evictionChecks", static_cast<lua_Number>(stats.evictionChecks));
+				setField(L, "forcedEvictions", static_cast<lua_Number>(stats.forcedEvictions));
+				setField(L, "checksPerEviction", static_cast<lua_Number>(stats.evictionChecks) / std::max<uint64_t>(stats.evictions, 1));
+			},
+			[] { KnownCreatures::resetStats(); },
+		},
+		{
+			"decay",
+			[](lua_State* L) {
+				const auto stats = g_decay().getStats();
+				lua_createtable(L, 0, 6);
+				setField(L, "ticks", static_cast<lua_Number>(stats.ticks));
+				setField(L, "decayed", static_cast<lua_Number>(stats.decayed));
+				setField(L, "lastTickDecayed", static_cast<lua_Number>(stats.lastTickDecayed));
+				setField(L, "maxTickDecayed", static_cast<lua_Number>(stats.maxTickDecayed));
+				setField(L, "decayedPerTick", static_cast<lua_Number>(stats.decayed) / std::max<uint64_t>(stats.ticks, 1));
+				setField(L, "pending", static_cast<lua_Number>(stats.pending));
+			},
+			[] { g_decay().resetStats(); },
+		},
+		{
+			"creatureThink",
+			[](lua_State* L) {
+				const auto stats = g_game().getCreatureThinkStats();
+				lua_createtable(L, 0, 4);
+				setField(L, "rounds", static_cast<lua_Number>(stats.rounds));
+				setField(L, "moves", static_cast<lua_Number>(stats.moves));
+
+				// spread of the last run times, what the ticks jitter by
+				uint64_t fastest = std::numeric_limits<uint64_t>::max();
+				uint64_t slowest = 0;
+				lua_createtable(L, static_cast<int>(stats.buckets.size()), 0);
+				int index = 0;
+				for (const auto &bucket : stats.buckets) {
+					fastest = std::min(fastest, bucket.lastRunTime);
+					slowest = std::max(slowest, bucket.lastRunTime);
+
+					lua_createtable(L, 0, 5);
+					setField(L, "creatures", static_cast<lua_Number>(bucket.entries));
+					setField(L, "cost", bucket.cost / 1000000.0);
+					setField(L, "lastRunTime", bucket.lastRunTime / 1000.0);
+					setField(L, "maxRunTime", bucket.maxRunTime / 1000.0);
+					setField(L, "averageRunTime", bucket.totalRunTime / 1000.0 / std::max<uint64_t>(bucket.runs, 1));
+					lua_rawseti(L, -2, ++index);
+				}
+				lua_setfield(L, -2, "buckets");
+
+				setField(L, "jitter", stats.buckets.empty() ? 0.0 : (slowest - fastest) / 1000.0);
+			},
+			[] { g_game().resetCreatureThinkStats(); },
+		},
+		{
+			"sectorActivity",
+			[](lua_State* L) {
+				const auto stats = g_game().map.sectorActivity.getStats();
+				lua_createtable(L, 0, 4);
+				setField(L, "awakeSectors", static_cast<lua_Number>(stats.awakeSectors));
+				setField(L, "sleepers", static_cast<lua_Number>(stats.sleepers));
+				setField(L, "slept", static_cast<lua_Number>(stats.slept));
+				setField(L, "woken", static_cast<lua_Number>(stats.woken));
+			},
+			[] { g_game().map.sectorActivity.resetStats(); },
+		},
+	};
+	return registry;
+}
+
+int GameFunctions::luaGameGetPerfStats(lua_State* L) {
+	// Game.getPerfStats([name])
+	const auto &registry = getPerfStatsRegistry();
+	if (!isString(L, 1)) {
+		lua_createtable(L, 0, static_cast<int>(registry.size()));
+		for (const auto &stats : registry) {
+			stats.push(L);
+			lua_setfield(L, -2, stats.name.data());
+		}
+		return 1;
+	}
+
+	const auto name = getString(L, 1);
+	const auto it = std::ranges::find(registry, name, &PerfStats::name);
+	if (it == registry.end()) {
+		reportErrorFunc(fmt::format("Unknown perf stats {}", name));
+		lua_pushnil(L);
+		return 1;
+	}
+
+	it->push(L);
+	return 1;
+}
+
+int GameFunctions::luaGameResetPerfStats(lua_State* L) {
+	// Game.resetPerfStats([name])
+	const auto &registry = getPerfStatsRegistry();
+	if (!isString(L, 1)) {
+		for (const auto &stats : registry) {
+			stats.reset();
+		}
+		pushBoolean(L, true);
+		return 1;
+	}
+
+	const auto name = getString(L, 1);
+	const auto it = std::ranges::find(registry, name, &PerfStats::name);
+	if (it == registry.end()) {
+		reportErrorFunc(fmt::format("Unknown perf stats {}", name));
+		pushBoolean(L, false);
+		return 1;
+	}
+
+	it->reset();
+	pushBoolean(L, true);
+	return 1;
+}
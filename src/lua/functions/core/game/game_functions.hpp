@@ -81,6 +81,12 @@ public:
 
 		registerMethod(L, "Game", "getTalkActions", GameFunctions::luaGameGetTalkActions);
 		registerMethod(L, "Game", "getEventCallbacks", GameFunctions::luaGameGetEventCallbacks);
+
+		registerMethod(L, "Game", "getTaskMetrics", GameFunctions::luaGameGetTaskMetrics);
+		registerMethod(L, "Game", "dumpTaskMetrics", GameFunctions::luaGameDumpTaskMetrics);
+		registerMethod(L, "Game", "resetTaskMetrics", GameFunctions::luaGameResetTaskMetrics);
+		registerMethod(L, "Game", "getPerfStats", GameFunctions::luaGameGetPerfStats);
+		registerMethod(L, "Game", "resetPerfStats", GameFunctions::luaGameResetPerfStats);
 	}
 
 private:
@@ -150,4 +156,19 @@ private:
 
 	static int luaGameGetTalkActions(lua_State* L);
 	static int luaGameGetEventCallbacks(lua_State* L);
+
+	static int luaGameGetTaskMetrics(lua_State* L);
+	static int luaGameDumpTaskMetrics(lua_State* L);
+	static int luaGameResetTaskMetrics(lua_State* L);
+	static int luaGameGetPerfStats(lua_State* L);
+	static int luaGameResetPerfStats(lua_State* L);
+
+	// The stats of a subsystem, pushed as a table and reset by name from Game.getPerfStats and Game.resetPerfStats
+	struct PerfStats {
+		std::string_view name;
+		void (*push)(lua_State* L);
+		void (*reset)();
+	};
+
+	static const std::vector<PerfStats> &getPerfStatsRegistry();
 };
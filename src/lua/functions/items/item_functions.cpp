@@ -458,6 +458,7 @@ int ItemFunctions::luaItemRemoveAttribute(lua_State* L) {
 		ret = (attribute != ItemAttribute_t::DURATION_TIMESTAMP);
 		if (ret) {
 			item->removeAttribute(attribute);
+			item->updateTileFlags();
 		} else {
 			reportErrorFunc("Attempt to erase protected key \"duration timestamp\"");
 		}
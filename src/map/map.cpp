@@ -11,6 +11,7 @@
 
 #include "map.hpp"
 #include "utils/astarnodes.hpp"
+#include "utils/pathfinder.hpp"
 
 #include "creatures/monsters/monster.hpp"
 #include "game/game.hpp"
@@ -316,6 +317,9 @@ bool Map::placeCreature(const Position &centerPos, std::shared_ptr<Creature> cre
 
 	const Position &dest = toCylinder->getPosition();
 	getQTNode(dest.x, dest.y)->addCreature(creature);
+	if (creature->getPlayer()) {
+		sectorActivity.addPlayer(creature.get(), dest);
+	}
 	return true;
 }
 
@@ -362,6 +366,11 @@ void Map::moveCreature(const std::shared_ptr<Creature> &creature, const std::sha
 
 	// add the creature
 	newTile->addThing(creature);
+	// the leaf keeps a packed copy of the position, now that the tile set it
+	new_leaf->updateCreature(creature);
+	if (creature->getPlayer()) {
+		sectorActivity.movePlayer(creature.get(), newPos);
+	}
 
 	if (!teleport) {
 		if (oldPos.y > newPos.y) {
@@ -514,7 +523,49 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, stdext::arr
 	return getPathMatching(creature, creature->getPosition(), dirList, pathCondition, fpp);
 }
 
+namespace {
+	// Walkability, walk costs and line of sight straight from the live map, dispatcher only
+	class MapPathingArea {
+	public:
+		MapPathingArea(Map &map, const std::shared_ptr<Creature> &creature) :
+			map(map), creature(creature) { }
+
+		bool preferDiagonal() const {
+			return creature == nullptr;
+		}
+
+		bool matches(const FrozenPathingConditionCall &pathCondition, const Position &startPos, const Position &testPos, const FindPathParams &fpp, int32_t &bestMatchDist) const {
+			return pathCondition(startPos, testPos, fpp, bestMatchDist);
+		}
+
+		bool canEnter(const Position &pos, bool known, int_fast32_t &extraCost) const {
+			const bool withoutCreature = creature == nullptr;
+			const auto &tile = known || withoutCreature ? map.getTile(pos.x, pos.y, pos.z) : map.canWalkTo(creature, pos);
+
+			if (!tile || !known && withoutCreature && tile->hasFlag(TILESTATE_BLOCKSOLID)) {
+				return false;
+			}
+
+			extraCost = AStarNodes::getTileWalkCost(creature, tile);
+			return true;
+		}
+
+	private:
+		Map &map;
+		const std::shared_ptr<Creature> &creature;
+	};
+}
+
 bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Position &startPos, stdext::arraylist<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+	return findPathMatching(MapPathingArea(*this, creature), startPos, dirList, pathCondition, fpp);
+}
+
+bool Map::getPathMatching(const PathfindingGrid &grid, const Position &startPos, stdext::arraylist<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
+	return findPathMatching(grid, startPos, dirList, pathCondition, fpp);
+}
+
+template <typename Area>
+bool Map::findPathMatching(const Area &area, const Position &startPos, stdext::arraylist<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp) {
 	static int_fast32_t allNeighbors[8][2] = {
 		{ -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 }
 	};
@@ -533,7 +584,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 	Position pos = startPos;
 	Position endPos;
 
-	AStarNodes nodes(pos.x, pos.y);
+	AStarNodes nodes(pos.x, pos.y, g_configManager().getNumber(PATHFINDING_MAX_NODES));
 
 	int32_t bestMatch = 0;
 
@@ -551,7 +602,7 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 		const int_fast32_t y = n->y;
 		pos.x = x;
 		pos.y = y;
-		if (pathCondition(startPos, pos, fpp, bestMatch)) {
+		if (area.matches(pathCondition, startPos, pos, fpp, bestMatch)) {
 			found = n;
 			endPos = pos;
 			if (bestMatch == 0) {
@@ -608,16 +659,13 @@ bool Map::getPathMatching(const std::shared_ptr<Creature> &creature, const Posit
 
 			AStarNode* neighborNode = nodes.getNodeByPosition(pos.x, pos.y);
 
-			const bool withoutCreature = creature == nullptr;
-			const auto &tile = neighborNode || withoutCreature ? getTile(pos.x, pos.y, pos.z) : canWalkTo(creature, pos);
-
-			if (!tile || !neighborNode && withoutCreature && tile->hasFlag(TILESTATE_BLOCKSOLID)) {
+			int_fast32_t extraCost = 0;
+			if (!area.canEnter(pos, neighborNode != nullptr, extraCost)) {
 				continue;
 			}
 
 			// The cost (g) for this neighbor
-			const int_fast32_t cost = AStarNodes::getMapWalkCost(n, pos, withoutCreature);
-			const int_fast32_t extraCost = AStarNodes::getTileWalkCost(creature, tile);
+			const int_fast32_t cost = AStarNodes::getMapWalkCost(n, pos, area.preferDiagonal());
 			const int_fast32_t newf = f + cost + extraCost;
 
 			if (neighborNode) {
@@ -10,6 +10,7 @@
 #pragma once
 
 #include "mapcache.hpp"
+#include "map/utils/sector_activity.hpp"
 #include "map/town.hpp"
 #include "map/house/house.hpp"
 #include "creatures/monsters/spawns/spawn_monster.hpp"
@@ -24,6 +25,7 @@ class Map;
 struct FindPathParams;
 
 class FrozenPathingConditionCall;
+class PathfindingGrid;
 
 /**
  * Map class.
@@ -129,12 +131,20 @@ public:
 		return getPathMatching(nullptr, startPos, dirList, pathCondition, fpp);
 	}
 
+	// Same search against a walkability snapshot instead of the live map, safe outside of the dispatcher
+	static bool getPathMatching(const PathfindingGrid &grid, const Position &startPos, stdext::arraylist<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
+
 	std::map<std::string, Position> waypoints;
 
 	QTreeLeafNode* getQTNode(uint16_t x, uint16_t y) {
 		return QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, x, y);
 	}
 
+	// What is kept of the tiles not created yet, read only
+	const MapCache &getCache() const {
+		return *this;
+	}
+
 	// Storage made by "loadFromXML" of houses, monsters and npcs for main map
 	SpawnsMonster spawnsMonster;
 	SpawnsNpc spawnsNpc;
@@ -146,9 +156,15 @@ public:
 	SpawnsNpc spawnsNpcCustomMaps[50];
 	Houses housesCustomMaps[50];
 
+	// Sectors with players around, kept by placeCreature, moveCreature and Tile::removeCreature
+	SectorActivity sectorActivity;
+
 private:
 	bool getPathMatching(const std::shared_ptr<Creature> &creature, const Position &startPos, stdext::arraylist<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
 
+	template <typename Area>
+	static bool findPathMatching(const Area &area, const Position &startPos, stdext::arraylist<Direction> &dirList, const FrozenPathingConditionCall &pathCondition, const FindPathParams &fpp);
+
 	/**
 	 * Set a single tile.
 	 */
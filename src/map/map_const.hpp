@@ -21,3 +21,6 @@ static constexpr int8_t MAP_LAYER_VIEW_LIMIT = 2;
 static constexpr int32_t FLOOR_BITS = 3;
 static constexpr int32_t FLOOR_SIZE = (1 << FLOOR_BITS);
 static constexpr int32_t FLOOR_MASK = (FLOOR_SIZE - 1);
+
+// nodes an A* search may create, the default of pathfindingMaxNodes
+static constexpr int32_t MAP_PATHFINDING_DEFAULT_MAX_NODES = 512;
@@ -23,67 +23,71 @@
 
 #include "io/iomap.hpp"
 
-static phmap::flat_hash_map<size_t, std::shared_ptr<BasicItem>> items;
-static phmap::flat_hash_map<size_t, std::shared_ptr<BasicTile>> tiles;
-
-std::shared_ptr<BasicItem> static_tryGetItemFromCache(const std::shared_ptr<BasicItem> &ref) {
-	return ref ? items.try_emplace(ref->hash(), ref).first->second : nullptr;
+namespace {
+	// a make_shared allocation holds the reference counts next to the object
+	constexpr size_t SHARED_CONTROL_BLOCK_SIZE = 16;
+	// longer texts do not fit in the std::string itself
+	constexpr size_t SHORT_STRING_SIZE = 15;
 }
 
-std::shared_ptr<BasicTile> static_tryGetTileFromCache(const std::shared_ptr<BasicTile> &ref) {
-	return ref ? tiles.try_emplace(ref->hash(), ref).first->second : nullptr;
+MapCache::MapCache() {
+	// index 0 stands for none
+	cachedItems.allocate();
+	cachedTiles.allocate();
+	cachedTexts.emplace_back();
+	textIndexes.emplace(std::string(), 0);
 }
 
 void MapCache::flush() {
-	items.clear();
-	tiles.clear();
+	itemIndexes.clear();
+	tileIndexes.clear();
+	textIndexes.clear();
+	textIndexes.emplace(std::string(), 0);
 }
 
-void MapCache::parseItemAttr(const std::shared_ptr<BasicItem> &BasicItem, std::shared_ptr<Item> item) {
-	if (BasicItem->charges > 0) {
-		item->setSubType(BasicItem->charges);
+void MapCache::parseItemAttr(const CachedItem &cachedItem, const std::shared_ptr<Item> &item) {
+	if (cachedItem.charges > 0) {
+		item->setSubType(cachedItem.charges);
 	}
 
-	if (BasicItem->actionId > 0) {
-		item->setAttribute(ItemAttribute_t::ACTIONID, BasicItem->actionId);
+	if (cachedItem.actionId > 0) {
+		item->setAttribute(ItemAttribute_t::ACTIONID, cachedItem.actionId);
 	}
 
-	if (BasicItem->uniqueId > 0) {
-		item->addUniqueId(BasicItem->uniqueId);
+	if (cachedItem.uniqueId > 0) {
+		item->addUniqueId(cachedItem.uniqueId);
 	}
 
-	if (item->getTeleport() && (BasicItem->destX != 0 || BasicItem->destY != 0 || BasicItem->destZ != 0)) {
-		auto dest = Position(BasicItem->destX, BasicItem->destY, BasicItem->destZ);
+	if (item->getTeleport() && (cachedItem.destX != 0 || cachedItem.destY != 0 || cachedItem.destZ != 0)) {
+		auto dest = Position(cachedItem.destX, cachedItem.destY, cachedItem.destZ);
 		item->getTeleport()->setDestPos(dest);
 	}
 
-	if (item->getDoor() && BasicItem->doorOrDepotId != 0) {
-		item->getDoor()->setDoorId(BasicItem->doorOrDepotId);
+	if (item->getDoor() && cachedItem.doorOrDepotId != 0) {
+		item->getDoor()->setDoorId(cachedItem.doorOrDepotId);
 	}
 
-	if (item->getContainer() && item->getContainer()->getDepotLocker() && BasicItem->doorOrDepotId != 0) {
-		item->getContainer()->getDepotLocker()->setDepotId(BasicItem->doorOrDepotId);
+	if (item->getContainer() && item->getContainer()->getDepotLocker() && cachedItem.doorOrDepotId != 0) {
+		item->getContainer()->getDepotLocker()->setDepotId(cachedItem.doorOrDepotId);
 	}
 
-	if (!BasicItem->text.empty()) {
-		item->setAttribute(ItemAttribute_t::TEXT, BasicItem->text);
+	if (cachedItem.text != 0) {
+		item->setAttribute(ItemAttribute_t::TEXT, getCachedText(cachedItem.text));
 	}
-
-	/* if (BasicItem.description != 0)
-		item->setAttribute(ItemAttribute_t::DESCRIPTION, STRING_CACHE[BasicItem.description]);*/
 }
 
-std::shared_ptr<Item> MapCache::createItem(const std::shared_ptr<BasicItem> &BasicItem, Position position) {
-	auto item = Item::CreateItem(BasicItem->id, position);
+std::shared_ptr<Item> MapCache::createItem(uint32_t cachedItemIndex, Position position) {
+	const CachedItem &cachedItem = getCachedItem(cachedItemIndex);
+	auto item = Item::CreateItem(cachedItem.id, position);
 	if (!item) {
 		return nullptr;
 	}
 
-	parseItemAttr(BasicItem, item);
+	parseItemAttr(cachedItem, item);
 
-	if (item->getContainer() && !BasicItem->items.empty()) {
-		for (const auto &BasicItemInside : BasicItem->items) {
-			if (auto itemInsede = createItem(BasicItemInside, position)) {
+	if (item->getContainer() && cachedItem.childCount != 0) {
+		for (const uint32_t child : getCachedItemList(cachedItem.firstChild, cachedItem.childCount)) {
+			if (auto itemInsede = createItem(child, position)) {
 				item->getContainer()->addItem(itemInsede);
 				item->getContainer()->updateItemWeight(itemInsede->getWeight());
 			}
@@ -102,21 +106,22 @@ std::shared_ptr<Item> MapCache::createItem(const std::shared_ptr<BasicItem> &Bas
 }
 
 std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::unique_ptr<Floor> &floor, uint16_t x, uint16_t y) {
-	const auto cachedTile = floor->getTileCache(x, y);
-	if (!cachedTile) {
+	const uint32_t cachedTileIndex = floor->getTileCache(x, y);
+	if (cachedTileIndex == 0) {
 		return floor->getTile(x, y);
 	}
 
+	const CachedTile &cachedTile = getCachedTile(cachedTileIndex);
 	const uint8_t z = floor->getZ();
 
 	auto map = static_cast<Map*>(this);
 
 	std::shared_ptr<Tile> tile = nullptr;
-	if (cachedTile->isHouse()) {
-		const auto house = map->houses.getHouse(cachedTile->houseId);
+	if (cachedTile.isHouse()) {
+		const auto house = map->houses.getHouse(cachedTile.houseId);
 		tile = std::make_shared<HouseTile>(x, y, z, house);
 		house->addTile(std::static_pointer_cast<HouseTile>(tile));
-	} else if (cachedTile->isStatic) {
+	} else if (cachedTile.isStatic) {
 		tile = std::make_shared<StaticTile>(x, y, z);
 	} else {
 		tile = std::make_shared<DynamicTile>(x, y, z);
@@ -124,15 +129,15 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::unique_ptr<F
 
 	auto pos = Position(x, y, z);
 
-	if (cachedTile->ground != nullptr) {
-		tile->internalAddThing(createItem(cachedTile->ground, pos));
+	if (cachedTile.ground != 0) {
+		tile->internalAddThing(createItem(cachedTile.ground, pos));
 	}
 
-	for (const auto &BasicItemd : cachedTile->items) {
-		tile->internalAddThing(createItem(BasicItemd, pos));
+	for (const uint32_t cachedItem : getCachedItemList(cachedTile.firstItem, cachedTile.itemCount)) {
+		tile->internalAddThing(createItem(cachedItem, pos));
 	}
 
-	tile->setFlag(static_cast<TileFlags_t>(cachedTile->flags));
+	tile->setFlag(static_cast<TileFlags_t>(cachedTile.flags));
 	for (const auto &zone : Zone::getZones(pos)) {
 		tile->addZone(zone);
 	}
@@ -140,27 +145,147 @@ std::shared_ptr<Tile> MapCache::getOrCreateTileFromCache(const std::unique_ptr<F
 	floor->setTile(x, y, tile);
 
 	// Remove Tile from cache
-	floor->setTileCache(x, y, nullptr);
+	floor->setTileCache(x, y, 0);
 
 	return tile;
 }
 
-void MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &newTile) {
+uint32_t MapCache::setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &newTile) {
+	if (z >= MAP_MAX_LAYERS) {
+		g_logger().error("Attempt to set tile on invalid coordinate: {}", Position(x, y, z).toString());
+		return 0;
+	}
+
+	const uint32_t cachedTile = cacheBasicTile(newTile);
+	setCachedTile(x, y, z, cachedTile);
+	return cachedTile;
+}
+
+void MapCache::setCachedTile(uint16_t x, uint16_t y, uint8_t z, uint32_t cachedTile) {
 	if (z >= MAP_MAX_LAYERS) {
 		g_logger().error("Attempt to set tile on invalid coordinate: {}", Position(x, y, z).toString());
 		return;
 	}
 
-	const auto tile = static_tryGetTileFromCache(newTile);
 	if (const auto leaf = QTreeNode::getLeafStatic<QTreeLeafNode*, QTreeNode*>(&root, x, y)) {
-		leaf->createFloor(z)->setTileCache(x, y, tile);
+		leaf->createFloor(z)->setTileCache(x, y, cachedTile);
 	} else {
-		root.getBestLeaf(x, y, 15)->createFloor(z)->setTileCache(x, y, tile);
+		root.getBestLeaf(x, y, 15)->createFloor(z)->setTileCache(x, y, cachedTile);
+	}
+}
+
+uint32_t MapCache::cacheBasicTile(const std::shared_ptr<BasicTile> &basicTile) {
+	if (!basicTile) {
+		return 0;
+	}
+
+	const size_t hash = basicTile->hash();
+	if (const auto it = tileIndexes.find(hash); it != tileIndexes.end()) {
+		return it->second;
+	}
+
+	std::vector<uint32_t> items;
+	items.reserve(basicTile->items.size());
+	for (const auto &item : basicTile->items) {
+		items.emplace_back(cacheBasicItem(item));
+	}
+
+	CachedTile cachedTile;
+	cachedTile.flags = basicTile->flags;
+	cachedTile.houseId = basicTile->houseId;
+	cachedTile.ground = cacheBasicItem(basicTile->ground);
+	cachedTile.type = basicTile->type;
+	cachedTile.isStatic = basicTile->isStatic;
+
+	const uint32_t index = addCachedTile(cachedTile, items);
+	tileIndexes.emplace(hash, index);
+	return index;
+}
+
+uint32_t MapCache::cacheBasicItem(const std::shared_ptr<BasicItem> &basicItem) {
+	if (!basicItem) {
+		return 0;
+	}
+
+	const size_t hash = basicItem->hash();
+	if (const auto it = itemIndexes.find(hash); it != itemIndexes.end()) {
+		return it->second;
+	}
+
+	std::vector<uint32_t> children;
+	children.reserve(basicItem->items.size());
+	for (const auto &child : basicItem->items) {
+		children.emplace_back(cacheBasicItem(child));
+	}
+
+	CachedItem cachedItem;
+	cachedItem.text = addCachedText(basicItem->text);
+	cachedItem.id = basicItem->id;
+	cachedItem.charges = basicItem->charges;
+	cachedItem.actionId = basicItem->actionId;
+	cachedItem.uniqueId = basicItem->uniqueId;
+	cachedItem.destX = basicItem->destX;
+	cachedItem.destY = basicItem->destY;
+	cachedItem.doorOrDepotId = basicItem->doorOrDepotId;
+	cachedItem.destZ = basicItem->destZ;
+
+	const uint32_t index = addCachedItem(cachedItem, children);
+	itemIndexes.emplace(hash, index);
+	return index;
+}
+
+uint32_t MapCache::addCachedText(const std::string &text) {
+	const auto [it, inserted] = textIndexes.try_emplace(text, static_cast<uint32_t>(cachedTexts.size()));
+	if (inserted) {
+		cachedTexts.emplace_back(text);
 	}
+	return it->second;
 }
 
-std::shared_ptr<BasicItem> MapCache::tryReplaceItemFromCache(const std::shared_ptr<BasicItem> &ref) {
-	return static_tryGetItemFromCache(ref);
+uint32_t MapCache::addCachedItem(const CachedItem &item, std::span<const uint32_t> children) {
+	const uint32_t index = cachedItems.push_back(item);
+	auto &cachedItem = cachedItems[index];
+	cachedItem.firstChild = cachedItemLists.allocate(children.size());
+	cachedItem.childCount = static_cast<uint32_t>(children.size());
+	for (size_t i = 0; i < children.size(); ++i) {
+		cachedItemLists[cachedItem.firstChild + i] = children[i];
+	}
+	return index;
+}
+
+uint32_t MapCache::addCachedTile(const CachedTile &tile, std::span<const uint32_t> items) {
+	const uint32_t index = cachedTiles.push_back(tile);
+	auto &cachedTile = cachedTiles[index];
+	cachedTile.firstItem = cachedItemLists.allocate(items.size());
+	cachedTile.itemCount = static_cast<uint32_t>(items.size());
+	for (size_t i = 0; i < items.size(); ++i) {
+		cachedItemLists[cachedTile.firstItem + i] = items[i];
+	}
+	return index;
+}
+
+MapCache::MemoryReport MapCache::getMemoryReport() const {
+	MemoryReport report;
+	report.tiles = cachedTiles.size() - 1;
+	report.items = cachedItems.size() - 1;
+	report.texts = cachedTexts.size() - 1;
+
+	size_t textBytes = cachedTexts.capacity() * sizeof(std::string);
+	size_t longTextBytes = 0;
+	for (const auto &text : cachedTexts) {
+		if (text.size() > SHORT_STRING_SIZE) {
+			textBytes += text.capacity() + 1;
+			longTextBytes += text.size() + 1;
+		}
+	}
+	report.bytes = cachedItems.memoryUsage() + cachedTiles.memoryUsage() + cachedItemLists.memoryUsage() + textBytes;
+
+	// each object in its own allocation, each list a vector of shared_ptr, each item its own text
+	report.sharedObjectBytes = report.items * (sizeof(BasicItem) + SHARED_CONTROL_BLOCK_SIZE)
+		+ report.tiles * (sizeof(BasicTile) + SHARED_CONTROL_BLOCK_SIZE)
+		+ cachedItemLists.size() * sizeof(std::shared_ptr<BasicItem>)
+		+ longTextBytes;
+	return report;
 }
 
 void BasicTile::hash(size_t &h) const {
@@ -225,7 +350,7 @@ bool BasicItem::unserializeItemNode(FileStream &stream, uint16_t x, uint16_t y,
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Failed to load item.", x, y, z));
 		}
 
-		items.emplace_back(static_tryGetItemFromCache(item));
+		items.emplace_back(item);
 
 		if (!stream.endNode()) {
 			throw IOMapException(fmt::format("[x:{}, y:{}, z:{}] Could not end node.", x, y, z));
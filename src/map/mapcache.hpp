@@ -10,6 +10,7 @@
 #pragma once
 
 #include "items/items_definitions.hpp"
+#include "utils/index_arena.hpp"
 #include "utils/qtreenode.hpp"
 
 class Map;
@@ -81,24 +82,69 @@ private:
 
 #pragma pack()
 
+/**
+ * What the map cache keeps of a BasicItem, referring to its text and the items inside it by index.
+ * Index 0 is never an item, it stands for no item.
+ */
+struct CachedItem {
+	// in the cached texts, 0 is the empty text
+	uint32_t text = 0;
+	// in the cached item lists
+	uint32_t firstChild = 0;
+	uint32_t childCount = 0;
+
+	uint16_t id = 0;
+	uint16_t charges = 0;
+	uint16_t actionId = 0;
+	uint16_t uniqueId = 0;
+	uint16_t destX = 0;
+	uint16_t destY = 0;
+	uint16_t doorOrDepotId = 0;
+	uint8_t destZ = 0;
+};
+
+/**
+ * What the map cache keeps of a BasicTile, index 0 is never a tile.
+ */
+struct CachedTile {
+	uint32_t flags = 0;
+	uint32_t houseId = 0;
+	// a cached item, 0 when there is no ground
+	uint32_t ground = 0;
+	// in the cached item lists
+	uint32_t firstItem = 0;
+	uint32_t itemCount = 0;
+	uint8_t type = TILESTATE_NONE;
+	bool isStatic = false;
+
+	bool isEmpty() const {
+		return ground == 0 && itemCount == 0;
+	}
+
+	bool isHouse() const {
+		return houseId != 0;
+	}
+};
+
 struct Floor {
 	explicit Floor(uint8_t z) :
 		z(z) {};
 
 	std::shared_ptr<Tile> getTile(uint16_t x, uint16_t y) const {
-		return tiles[x & FLOOR_MASK][y & FLOOR_MASK].first;
+		return tiles[x & FLOOR_MASK][y & FLOOR_MASK];
 	}
 
 	void setTile(uint16_t x, uint16_t y, std::shared_ptr<Tile> tile) {
-		tiles[x & FLOOR_MASK][y & FLOOR_MASK].first = tile;
+		tiles[x & FLOOR_MASK][y & FLOOR_MASK] = tile;
 	}
 
-	std::shared_ptr<BasicTile> getTileCache(uint16_t x, uint16_t y) const {
-		return tiles[x & FLOOR_MASK][y & FLOOR_MASK].second;
+	// The cached tile not created yet at that position, 0 when there is none
+	uint32_t getTileCache(uint16_t x, uint16_t y) const {
+		return cachedTiles[x & FLOOR_MASK][y & FLOOR_MASK];
 	}
 
-	void setTileCache(uint16_t x, uint16_t y, const std::shared_ptr<BasicTile> &newTile) {
-		tiles[x & FLOOR_MASK][y & FLOOR_MASK].second = newTile;
+	void setTileCache(uint16_t x, uint16_t y, uint32_t cachedTile) {
+		cachedTiles[x & FLOOR_MASK][y & FLOOR_MASK] = cachedTile;
 	}
 
 	uint8_t getZ() const {
@@ -106,26 +152,86 @@ struct Floor {
 	}
 
 private:
-	std::pair<std::shared_ptr<Tile>, std::shared_ptr<BasicTile>> tiles[FLOOR_SIZE][FLOOR_SIZE] = {};
+	std::shared_ptr<Tile> tiles[FLOOR_SIZE][FLOOR_SIZE] = {};
+	uint32_t cachedTiles[FLOOR_SIZE][FLOOR_SIZE] = {};
 	uint8_t z { 0 };
 };
 
+/**
+ * The tiles of the loaded maps that were not created yet. They are kept as CachedTile and
+ * CachedItem records in arenas, deduplicated while the maps load, so the many equal tiles and
+ * items of a world share their storage without a shared_ptr and an allocation each.
+ * A tile is created from its record the first time it is needed, records are never freed.
+ */
 class MapCache {
 public:
+	MapCache();
 	virtual ~MapCache() = default;
 
-	void setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &BasicTile);
+	// Caches the tile and its items, sharing equal ones, and returns its index, 0 when the position is invalid
+	uint32_t setBasicTile(uint16_t x, uint16_t y, uint8_t z, const std::shared_ptr<BasicTile> &BasicTile);
+	// Places a tile cached already, 0 clears the position
+	void setCachedTile(uint16_t x, uint16_t y, uint8_t z, uint32_t cachedTile);
 
-	std::shared_ptr<BasicItem> tryReplaceItemFromCache(const std::shared_ptr<BasicItem> &ref);
+	// Caches the tile and its items without placing it anywhere
+	uint32_t cacheBasicTile(const std::shared_ptr<BasicTile> &BasicTile);
 
+	// Records stored as they are, for caches that were deduplicated when written, like map snapshots
+	uint32_t addCachedText(const std::string &text);
+	uint32_t addCachedItem(const CachedItem &item, std::span<const uint32_t> children);
+	uint32_t addCachedTile(const CachedTile &tile, std::span<const uint32_t> items);
+
+	const CachedItem &getCachedItem(uint32_t index) const {
+		return cachedItems[index];
+	}
+
+	const CachedTile &getCachedTile(uint32_t index) const {
+		return cachedTiles[index];
+	}
+
+	// Children of an item or items of a tile
+	std::span<const uint32_t> getCachedItemList(uint32_t first, uint32_t count) const {
+		return cachedItemLists.span(first, count);
+	}
+
+	const std::string &getCachedText(uint32_t index) const {
+		return cachedTexts[index];
+	}
+
+	// Drops what is only needed while loading, the tables used to deduplicate
 	void flush();
 
+	struct MemoryReport {
+		size_t tiles = 0;
+		size_t items = 0;
+		size_t texts = 0;
+		// taken by the arenas and the texts
+		size_t bytes = 0;
+		// estimate of what the same tiles and items took as shared BasicTile and BasicItem objects
+		size_t sharedObjectBytes = 0;
+	};
+
+	MemoryReport getMemoryReport() const;
+
 protected:
 	std::shared_ptr<Tile> getOrCreateTileFromCache(const std::unique_ptr<Floor> &floor, uint16_t x, uint16_t y);
 
 	QTreeNode root;
 
 private:
-	void parseItemAttr(const std::shared_ptr<BasicItem> &BasicItem, std::shared_ptr<Item> item);
-	std::shared_ptr<Item> createItem(const std::shared_ptr<BasicItem> &BasicItem, Position position);
+	uint32_t cacheBasicItem(const std::shared_ptr<BasicItem> &BasicItem);
+
+	void parseItemAttr(const CachedItem &cachedItem, const std::shared_ptr<Item> &item);
+	std::shared_ptr<Item> createItem(uint32_t cachedItem, Position position);
+
+	stdext::index_arena<CachedItem> cachedItems;
+	stdext::index_arena<CachedTile> cachedTiles;
+	// the children of the items and the items of the tiles, each list is contiguous
+	stdext::index_arena<uint32_t> cachedItemLists;
+	std::vector<std::string> cachedTexts;
+
+	// only while loading, index by hash
+	phmap::flat_hash_map<size_t, uint32_t> itemIndexes;
+	phmap::flat_hash_map<size_t, uint32_t> tileIndexes;
+	phmap::flat_hash_map<std::string, uint32_t> textIndexes;
 };
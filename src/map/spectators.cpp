@@ -11,9 +11,156 @@
 #include "game/game.hpp"
 
 phmap::flat_hash_map<Position, SpectatorsCache> Spectators::spectatorsCache;
+phmap::flat_hash_map<uint64_t, std::vector<Position>> Spectators::spectatorsCacheSectors;
+std::array<uint32_t, MAP_MAX_LAYERS> Spectators::spectatorsCacheFloors {};
+std::map<int32_t, uint32_t> Spectators::spectatorsCacheRangesX;
+std::map<int32_t, uint32_t> Spectators::spectatorsCacheRangesY;
+SpectatorsCacheStats Spectators::spectatorsCacheStats;
+
+namespace {
+	// entries are only evicted by nearby moves, so the viewports of quiet areas are dropped at once when it gets too big
+	constexpr size_t SPECTATORS_CACHE_MAX_ENTRIES = 1 << 16;
+}
 
 void Spectators::clearCache() {
+	spectatorsCacheStats.evictions += spectatorsCache.size();
 	spectatorsCache.clear();
+	spectatorsCacheSectors.clear();
+	spectatorsCacheFloors.fill(0);
+	spectatorsCacheRangesX.clear();
+	spectatorsCacheRangesY.clear();
+}
+
+void Spectators::clearCache(const Position &pos) {
+	if (spectatorsCache.empty()) {
+		return;
+	}
+
+	static std::vector<Position> evicted;
+	evicted.clear();
+
+	const int32_t rangeX = spectatorsCacheRangesX.rbegin()->first;
+	const int32_t rangeY = spectatorsCacheRangesY.rbegin()->first;
+
+	for (uint8_t z = 0; z < MAP_MAX_LAYERS; ++z) {
+		if (spectatorsCacheFloors[z] == 0) {
+			continue;
+		}
+
+		uint8_t minRangeZ;
+		uint8_t maxRangeZ;
+		getFloorRange(z, true, minRangeZ, maxRangeZ);
+		if (minRangeZ > pos.z || maxRangeZ < pos.z) {
+			continue;
+		}
+
+		// same bounds as the quadtree walk of find, from the point of view of the moved position
+		const int32_t offsetZ = z - pos.z;
+		const int32_t x = pos.x - offsetZ;
+		const int32_t y = pos.y - offsetZ;
+		const int32_t startX = std::max<int32_t>(0, x - rangeX) >> FLOOR_BITS;
+		const int32_t startY = std::max<int32_t>(0, y - rangeY) >> FLOOR_BITS;
+		const int32_t endX = std::clamp<int32_t>(x + rangeX, 0, 0xFFFF) >> FLOOR_BITS;
+		const int32_t endY = std::clamp<int32_t>(y + rangeY, 0, 0xFFFF) >> FLOOR_BITS;
+
+		for (int32_t sy = startY; sy <= endY; ++sy) {
+			for (int32_t sx = startX; sx <= endX; ++sx) {
+				const auto sectorIt = spectatorsCacheSectors.find(getCacheSector(sx << FLOOR_BITS, sy << FLOOR_BITS, z));
+				if (sectorIt == spectatorsCacheSectors.end()) {
+					continue;
+				}
+
+				for (const auto &centerPos : sectorIt->second) {
+					const auto &cache = spectatorsCache.at(centerPos);
+					const int32_t dx = x - centerPos.x;
+					const int32_t dy = y - centerPos.y;
+					if (dx >= cache.minRangeX && dx <= cache.maxRangeX && dy >= cache.minRangeY && dy <= cache.maxRangeY) {
+						evicted.emplace_back(centerPos);
+					}
+				}
+			}
+		}
+	}
+
+	for (const auto &centerPos : evicted) {
+		const auto it = spectatorsCache.find(centerPos);
+		removeCacheRange(it->second);
+		spectatorsCache.erase(it);
+		removeCacheSector(centerPos);
+	}
+	spectatorsCacheStats.evictions += evicted.size();
+}
+
+SpectatorsCacheStats Spectators::getCacheStats() {
+	auto stats = spectatorsCacheStats;
+	stats.entries = spectatorsCache.size();
+	return stats;
+}
+
+void Spectators::resetCacheStats() {
+	spectatorsCacheStats = {};
+}
+
+void Spectators::addCacheSector(const Position &centerPos) {
+	spectatorsCacheSectors[getCacheSector(centerPos.x, centerPos.y, centerPos.z)].emplace_back(centerPos);
+	++spectatorsCacheFloors[centerPos.z];
+}
+
+void Spectators::removeCacheSector(const Position &centerPos) {
+	const auto it = spectatorsCacheSectors.find(getCacheSector(centerPos.x, centerPos.y, centerPos.z));
+	if (it == spectatorsCacheSectors.end()) {
+		return;
+	}
+
+	auto &sector = it->second;
+	if (const auto posIt = std::ranges::find(sector, centerPos); posIt != sector.end()) {
+		*posIt = sector.back();
+		sector.pop_back();
+		--spectatorsCacheFloors[centerPos.z];
+	}
+
+	if (sector.empty()) {
+		spectatorsCacheSectors.erase(it);
+	}
+}
+
+void Spectators::addCacheRange(const SpectatorsCache &cache) {
+	++spectatorsCacheRangesX[std::max(-cache.minRangeX, cache.maxRangeX)];
+	++spectatorsCacheRangesY[std::max(-cache.minRangeY, cache.maxRangeY)];
+}
+
+void Spectators::removeCacheRange(const SpectatorsCache &cache) {
+	const auto release = [](std::map<int32_t, uint32_t> &ranges, int32_t range) {
+		const auto it = ranges.find(range);
+		if (it != ranges.end() && --it->second == 0) {
+			ranges.erase(it);
+		}
+	};
+	release(spectatorsCacheRangesX, std::max(-cache.minRangeX, cache.maxRangeX));
+	release(spectatorsCacheRangesY, std::max(-cache.minRangeY, cache.maxRangeY));
+}
+
+void Spectators::getFloorRange(uint8_t z, bool multifloor, uint8_t &minRangeZ, uint8_t &maxRangeZ) {
+	minRangeZ = z;
+	maxRangeZ = z;
+
+	if (!multifloor) {
+		return;
+	}
+
+	if (z > MAP_INIT_SURFACE_LAYER) {
+		minRangeZ = static_cast<uint8_t>(std::max<int8_t>(z - MAP_LAYER_VIEW_LIMIT, 0u));
+		maxRangeZ = static_cast<uint8_t>(std::min<int8_t>(z + MAP_LAYER_VIEW_LIMIT, MAP_MAX_LAYERS - 1));
+	} else if (z == MAP_INIT_SURFACE_LAYER - 1) {
+		minRangeZ = 0;
+		maxRangeZ = (MAP_INIT_SURFACE_LAYER - 1) + MAP_LAYER_VIEW_LIMIT;
+	} else if (z == MAP_INIT_SURFACE_LAYER) {
+		minRangeZ = 0;
+		maxRangeZ = MAP_INIT_SURFACE_LAYER + MAP_LAYER_VIEW_LIMIT;
+	} else {
+		minRangeZ = 0;
+		maxRangeZ = MAP_INIT_SURFACE_LAYER;
+	}
 }
 
 bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
@@ -50,6 +197,52 @@ bool Spectators::checkCache(const SpectatorsCache::FloorData &specData, bool onl
 	return true;
 }
 
+void Spectators::findInLeaves(SpectatorList &out, const Position &centerPos, bool multifloor, bool onlyPlayers, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
+	uint8_t minRangeZ;
+	uint8_t maxRangeZ;
+	getFloorRange(centerPos.z, multifloor, minRangeZ, maxRangeZ);
+
+	const int_fast32_t min_y = centerPos.y + minRangeY;
+	const int_fast32_t min_x = centerPos.x + minRangeX;
+	const int_fast32_t max_y = centerPos.y + maxRangeY;
+	const int_fast32_t max_x = centerPos.x + maxRangeX;
+
+	const int_fast16_t minoffset = centerPos.getZ() - maxRangeZ;
+	const int_fast32_t x1 = std::min<int_fast32_t>(0xFFFF, std::max<int_fast32_t>(0, (min_x + minoffset)));
+	const int_fast32_t y1 = std::min<int_fast32_t>(0xFFFF, std::max<int_fast32_t>(0, (min_y + minoffset)));
+
+	const int_fast16_t maxoffset = centerPos.getZ() - minRangeZ;
+	const int_fast32_t x2 = std::min<int_fast32_t>(0xFFFF, std::max<int_fast32_t>(0, (max_x + maxoffset)));
+	const int_fast32_t y2 = std::min<int_fast32_t>(0xFFFF, std::max<int_fast32_t>(0, (max_y + maxoffset)));
+
+	const uint_fast16_t startx1 = x1 - (x1 % FLOOR_SIZE);
+	const uint_fast16_t starty1 = y1 - (y1 % FLOOR_SIZE);
+	const uint_fast16_t endx2 = x2 - (x2 % FLOOR_SIZE);
+	const uint_fast16_t endy2 = y2 - (y2 % FLOOR_SIZE);
+
+	const auto startLeaf = g_game().map.getQTNode(static_cast<uint16_t>(startx1), static_cast<uint16_t>(starty1));
+	const QTreeLeafNode* leafS = startLeaf;
+	const QTreeLeafNode* leafE;
+
+	for (uint_fast16_t ny = starty1; ny <= endy2; ny += FLOOR_SIZE) {
+		leafE = leafS;
+		for (uint_fast16_t nx = startx1; nx <= endx2; nx += FLOOR_SIZE) {
+			if (leafE) {
+				leafE->findCreatures(out, onlyPlayers, centerPos.z, minRangeZ, maxRangeZ, min_x, max_x, min_y, max_y);
+				leafE = leafE->leafE;
+			} else {
+				leafE = g_game().map.getQTNode(static_cast<uint16_t>(nx + FLOOR_SIZE), static_cast<uint16_t>(ny));
+			}
+		}
+
+		if (leafS) {
+			leafS = leafS->leafS;
+		} else {
+			leafS = g_game().map.getQTNode(static_cast<uint16_t>(startx1), static_cast<uint16_t>(ny + FLOOR_SIZE));
+		}
+	}
+}
+
 Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onlyPlayers, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY) {
 	minRangeX = (minRangeX == 0 ? -MAP_MAX_VIEW_PORT_X : -minRangeX);
 	maxRangeX = (maxRangeX == 0 ? MAP_MAX_VIEW_PORT_X : maxRangeX);
@@ -62,121 +255,71 @@ Spectators Spectators::find(const Position &centerPos, bool multifloor, bool onl
 		auto &cache = it->second;
 		if (minRangeX < cache.minRangeX || maxRangeX > cache.maxRangeX || minRangeY < cache.minRangeY || maxRangeY > cache.maxRangeY) {
 			// recache with new range
+			removeCacheRange(cache);
 			cache.minRangeX = minRangeX = std::min<int32_t>(minRangeX, cache.minRangeX);
 			cache.minRangeY = minRangeY = std::min<int32_t>(minRangeY, cache.minRangeY);
 			cache.maxRangeX = maxRangeX = std::max<int32_t>(maxRangeX, cache.maxRangeX);
 			cache.maxRangeY = maxRangeY = std::max<int32_t>(maxRangeY, cache.maxRangeY);
+			addCacheRange(cache);
+			// the other lists were found with the old range, now that entries live longer they must not answer for the new one
+			cache.creatures = {};
+			cache.players = {};
 		} else {
 			const bool checkDistance = minRangeX != cache.minRangeX || maxRangeX != cache.maxRangeX || minRangeY != cache.minRangeY || maxRangeY != cache.maxRangeY;
 
 			if (onlyPlayers) {
 				// check players cache
 				if (checkCache(cache.players, true, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
+					++spectatorsCacheStats.hits;
 					return *this;
 				}
 
 				// if there is no player cache, look for players in the creatures cache.
 				if (checkCache(cache.creatures, true, centerPos, true, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
+					++spectatorsCacheStats.hits;
 					return *this;
 				}
 
 				// All Creatures
 			} else if (checkCache(cache.creatures, false, centerPos, checkDistance, multifloor, minRangeX, maxRangeX, minRangeY, maxRangeY)) {
+				++spectatorsCacheStats.hits;
 				return *this;
 			}
 		}
 	}
 
-	uint8_t minRangeZ = centerPos.z;
-	uint8_t maxRangeZ = centerPos.z;
-
-	if (multifloor) {
-		if (centerPos.z > MAP_INIT_SURFACE_LAYER) {
-			minRangeZ = static_cast<uint8_t>(std::max<int8_t>(centerPos.z - MAP_LAYER_VIEW_LIMIT, 0u));
-			maxRangeZ = static_cast<uint8_t>(std::min<int8_t>(centerPos.z + MAP_LAYER_VIEW_LIMIT, MAP_MAX_LAYERS - 1));
-		} else if (centerPos.z == MAP_INIT_SURFACE_LAYER - 1) {
-			minRangeZ = 0;
-			maxRangeZ = (MAP_INIT_SURFACE_LAYER - 1) + MAP_LAYER_VIEW_LIMIT;
-		} else if (centerPos.z == MAP_INIT_SURFACE_LAYER) {
-			minRangeZ = 0;
-			maxRangeZ = MAP_INIT_SURFACE_LAYER + MAP_LAYER_VIEW_LIMIT;
-		} else {
-			minRangeZ = 0;
-			maxRangeZ = MAP_INIT_SURFACE_LAYER;
-		}
-	}
-
-	const int_fast32_t min_y = centerPos.y + minRangeY;
-	const int_fast32_t min_x = centerPos.x + minRangeX;
-	const int_fast32_t max_y = centerPos.y + maxRangeY;
-	const int_fast32_t max_x = centerPos.x + maxRangeX;
-
-	const int_fast16_t minoffset = centerPos.getZ() - maxRangeZ;
-	const int_fast32_t x1 = std::min<int_fast32_t>(0xFFFF, std::max<int_fast32_t>(0, (min_x + minoffset)));
-	const int_fast32_t y1 = std::min<int_fast32_t>(0xFFFF, std::max<int_fast32_t>(0, (min_y + minoffset)));
-
-	const int_fast16_t maxoffset = centerPos.getZ() - minRangeZ;
-	const int_fast32_t x2 = std::min<int_fast32_t>(0xFFFF, std::max<int_fast32_t>(0, (max_x + maxoffset)));
-	const int_fast32_t y2 = std::min<int_fast32_t>(0xFFFF, std::max<int_fast32_t>(0, (max_y + maxoffset)));
-
-	const uint_fast16_t startx1 = x1 - (x1 % FLOOR_SIZE);
-	const uint_fast16_t starty1 = y1 - (y1 % FLOOR_SIZE);
-	const uint_fast16_t endx2 = x2 - (x2 % FLOOR_SIZE);
-	const uint_fast16_t endy2 = y2 - (y2 % FLOOR_SIZE);
-
-	const auto startLeaf = g_game().map.getQTNode(static_cast<uint16_t>(startx1), static_cast<uint16_t>(starty1));
-	const QTreeLeafNode* leafS = startLeaf;
-	const QTreeLeafNode* leafE;
+	++spectatorsCacheStats.misses;
 
 	SpectatorList spectators;
 	spectators.reserve(std::max<uint8_t>(MAP_MAX_VIEW_PORT_X, MAP_MAX_VIEW_PORT_Y) * 2);
+	findInLeaves(spectators, centerPos, multifloor, onlyPlayers, minRangeX, maxRangeX, minRangeY, maxRangeY);
 
-	for (uint_fast16_t ny = starty1; ny <= endy2; ny += FLOOR_SIZE) {
-		leafE = leafS;
-		for (uint_fast16_t nx = startx1; nx <= endx2; nx += FLOOR_SIZE) {
-			if (leafE) {
-				const auto &node_list = (onlyPlayers ? leafE->player_list : leafE->creature_list);
-				for (const auto creature : node_list) {
-					const auto &cpos = creature->getPosition();
-					if (minRangeZ > cpos.z || maxRangeZ < cpos.z) {
-						continue;
-					}
-
-					const int_fast16_t offsetZ = Position::getOffsetZ(centerPos, cpos);
-					if ((min_y + offsetZ) > cpos.y || (max_y + offsetZ) < cpos.y || (min_x + offsetZ) > cpos.x || (max_x + offsetZ) < cpos.x) {
-						continue;
-					}
+	if (!spectators.empty()) {
+		insertAll(spectators);
+	}
 
-					spectators.emplace_back(creature);
-				}
-				leafE = leafE->leafE;
-			} else {
-				leafE = g_game().map.getQTNode(static_cast<uint16_t>(nx + FLOOR_SIZE), static_cast<uint16_t>(ny));
-			}
+	if (cacheFound) {
+		const auto &cache = it->second;
+		if (minRangeX != cache.minRangeX || maxRangeX != cache.maxRangeX || minRangeY != cache.minRangeY || maxRangeY != cache.maxRangeY) {
+			// a narrower lookup must not be stored as if it covered the whole cached range
+			return *this;
 		}
-
-		if (leafS) {
-			leafS = leafS->leafS;
-		} else {
-			leafS = g_game().map.getQTNode(static_cast<uint16_t>(startx1), static_cast<uint16_t>(ny + FLOOR_SIZE));
+	} else {
+		if (spectatorsCache.size() >= SPECTATORS_CACHE_MAX_ENTRIES) {
+			clearCache();
 		}
+		addCacheSector(centerPos);
 	}
 
 	// It is necessary to create the cache even if no spectators is found, so that there is no future query.
 	auto &cache = cacheFound ? it->second : spectatorsCache.emplace(centerPos, SpectatorsCache { .minRangeX = minRangeX, .maxRangeX = maxRangeX, .minRangeY = minRangeY, .maxRangeY = maxRangeY }).first->second;
-	auto &creaturesCache = onlyPlayers ? cache.players : cache.creatures;
-	auto &creatureList = (multifloor ? creaturesCache.multiFloor : creaturesCache.floor);
-	if (creatureList) {
-		creatureList->clear();
-	} else {
-		creatureList.emplace();
+	if (!cacheFound) {
+		addCacheRange(cache);
 	}
 
-	if (!spectators.empty()) {
-		insertAll(spectators);
-
-		creatureList->insert(creatureList->end(), spectators.begin(), spectators.end());
-	}
+	auto &creaturesCache = onlyPlayers ? cache.players : cache.creatures;
+	auto &creatureList = (multifloor ? creaturesCache.multiFloor : creaturesCache.floor);
+	creatureList.emplace(std::move(spectators));
 
 	return *this;
 }
@@ -34,9 +34,21 @@ struct SpectatorsCache {
 	FloorData players;
 };
 
+struct SpectatorsCacheStats {
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t evictions = 0;
+	size_t entries = 0;
+};
+
 class Spectators {
 public:
 	static void clearCache();
+	// Evicts only the cached viewports that can see the given position, call it when a creature enters or leaves it
+	static void clearCache(const Position &pos);
+
+	static SpectatorsCacheStats getCacheStats();
+	static void resetCacheStats();
 
 	template <typename T>
 		requires std::is_same_v<Creature, T> || std::is_same_v<Player, T>
@@ -45,6 +57,19 @@ public:
 		return find(centerPos, multifloor, onlyPlayers, minRangeX, maxRangeX, minRangeY, maxRangeY);
 	}
 
+	/**
+	 * Uncached lookup of the creatures (or players) whose offset to centerPos, shifted by the floor
+	 * offset as in find, is within the given bounds. Unlike find the bounds are taken as they are,
+	 * so they can be narrow and one sided, e.g. the band of tiles a step of centerPos uncovers.
+	 */
+	template <typename T>
+		requires std::is_same_v<Creature, T> || std::is_same_v<Player, T>
+	Spectators findArea(const Position &centerPos, bool multifloor, int32_t minOffsetX, int32_t maxOffsetX, int32_t minOffsetY, int32_t maxOffsetY) {
+		SpectatorList found;
+		findInLeaves(found, centerPos, multifloor, std::is_same_v<T, Player>, minOffsetX, maxOffsetX, minOffsetY, maxOffsetY);
+		return insertAll(found);
+	}
+
 	template <typename T>
 		requires std::is_base_of_v<Creature, T>
 	Spectators filter();
@@ -102,8 +127,27 @@ public:
 
 private:
 	static phmap::flat_hash_map<Position, SpectatorsCache> spectatorsCache;
+	// cache centers by (z, x / FLOOR_SIZE, y / FLOOR_SIZE), so an invalidation only visits the nearby entries
+	static phmap::flat_hash_map<uint64_t, std::vector<Position>> spectatorsCacheSectors;
+	static std::array<uint32_t, MAP_MAX_LAYERS> spectatorsCacheFloors;
+	// how many cached entries reach each range, the widest one still cached bounds the sectors an invalidation has to visit
+	static std::map<int32_t, uint32_t> spectatorsCacheRangesX;
+	static std::map<int32_t, uint32_t> spectatorsCacheRangesY;
+	static SpectatorsCacheStats spectatorsCacheStats;
+
+	static uint64_t getCacheSector(uint16_t x, uint16_t y, uint8_t z) {
+		return (static_cast<uint64_t>(z) << 32) | (static_cast<uint64_t>(x >> FLOOR_BITS) << 16) | (y >> FLOOR_BITS);
+	}
+
+	static void getFloorRange(uint8_t z, bool multifloor, uint8_t &minRangeZ, uint8_t &maxRangeZ);
+	static void addCacheSector(const Position &centerPos);
+	static void removeCacheSector(const Position &centerPos);
+	static void addCacheRange(const SpectatorsCache &cache);
+	static void removeCacheRange(const SpectatorsCache &cache);
 
 	Spectators find(const Position &centerPos, bool multifloor = false, bool onlyPlayers = false, int32_t minRangeX = 0, int32_t maxRangeX = 0, int32_t minRangeY = 0, int32_t maxRangeY = 0);
+	// Walks the quadtree leaves under the area, the offsets are signed: centerPos.x + minRangeX is the west edge
+	static void findInLeaves(SpectatorList &out, const Position &centerPos, bool multifloor, bool onlyPlayers, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
 	bool checkCache(const SpectatorsCache::FloorData &specData, bool onlyPlayers, const Position &centerPos, bool checkDistance, bool multifloor, int32_t minRangeX, int32_t maxRangeX, int32_t minRangeY, int32_t maxRangeY);
 
 	stdext::vector_set<std::shared_ptr<Creature>> creatures;
@@ -13,70 +13,97 @@
 #include "creatures/monsters/monster.hpp"
 #include "creatures/combat/combat.hpp"
 
-AStarNodes::AStarNodes(uint32_t x, uint32_t y) :
-	nodes(), openNodes() {
-	curNode = 1;
-	closedNodes = 0;
-	openNodes[0] = true;
+// a stack, in case a path search ever runs inside another one on the same thread
+thread_local std::vector<std::unique_ptr<AStarNodes::Storage>> AStarNodes::storagePool;
 
-	AStarNode &startNode = nodes[0];
-	startNode.parent = nullptr;
-	startNode.x = x;
-	startNode.y = y;
-	startNode.f = 0;
-	nodeTable[(x << 16) | y] = nodes;
+AStarNodes::AStarNodes(uint32_t x, uint32_t y, int32_t maxNodes) :
+	storage(acquireStorage()), maxNodes(static_cast<size_t>(std::max<int32_t>(maxNodes, 1))), curNode(0), closedNodes(0) {
+	storage->prepare(this->maxNodes);
+
+	createOpenNode(nullptr, x, y, 0);
+}
+
+AStarNodes::~AStarNodes() {
+	releaseStorage(std::move(storage));
+}
+
+std::unique_ptr<AStarNodes::Storage> AStarNodes::acquireStorage() {
+	if (storagePool.empty()) {
+		return std::make_unique<Storage>();
+	}
+
+	auto storage = std::move(storagePool.back());
+	storagePool.pop_back();
+	return storage;
+}
+
+void AStarNodes::releaseStorage(std::unique_ptr<Storage> storage) {
+	storagePool.emplace_back(std::move(storage));
+}
+
+void AStarNodes::Storage::prepare(size_t maxNodes) {
+	// nodes are handed out by pointer, so the vector must never reallocate during a search
+	if (nodes.size() < maxNodes) {
+		nodes.resize(maxNodes);
+		heap.reserve(maxNodes);
+	}
+	heap.clear();
+
+	// at most half full, so the linear probing stays short
+	const auto capacity = std::bit_ceil(maxNodes * 2);
+	if (slots.size() < capacity) {
+		slots.assign(capacity, Slot {});
+		mask = static_cast<uint32_t>(capacity - 1);
+		generation = 0;
+	}
+
+	if (++generation == 0) {
+		std::ranges::fill(slots, Slot {});
+		generation = 1;
+	}
 }
 
 AStarNode* AStarNodes::createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f) {
-	if (curNode >= MAX_NODES) {
+	if (curNode >= maxNodes) {
 		return nullptr;
 	}
 
-	size_t retNode = curNode++;
-	openNodes[retNode] = true;
-
-	AStarNode* node = nodes + retNode;
-	nodeTable[(x << 16) | y] = node;
+	AStarNode* node = &storage->nodes[curNode++];
 	node->parent = parent;
 	node->x = x;
 	node->y = y;
 	node->f = f;
+
+	const uint32_t key = getKey(x, y);
+	auto index = (key * 0x9E3779B1u) & storage->mask;
+	while (storage->slots[index].generation == storage->generation) {
+		index = (index + 1) & storage->mask;
+	}
+	storage->slots[index] = { key, storage->generation, node };
+
+	pushHeap(node);
 	return node;
 }
 
 AStarNode* AStarNodes::getBestNode() {
-	if (curNode == 0) {
+	if (storage->heap.empty()) {
 		return nullptr;
 	}
-
-	int32_t best_node_f = std::numeric_limits<int32_t>::max();
-	int32_t best_node = -1;
-	for (size_t i = 0; i < curNode; i++) {
-		if (openNodes[i] && nodes[i].f < best_node_f) {
-			best_node_f = nodes[i].f;
-			best_node = i;
-		}
-	}
-
-	if (best_node >= 0) {
-		return nodes + best_node;
-	}
-	return nullptr;
+	return storage->heap.front();
 }
 
-void AStarNodes::closeNode(const AStarNode* node) {
-	size_t index = node - nodes;
-	assert(index < MAX_NODES);
-	openNodes[index] = false;
+void AStarNodes::closeNode(AStarNode* node) {
+	assert(node->heapIndex >= 0);
+	removeHeap(node);
 	++closedNodes;
 }
 
-void AStarNodes::openNode(const AStarNode* node) {
-	size_t index = node - nodes;
-	assert(index < MAX_NODES);
-	if (!openNodes[index]) {
-		openNodes[index] = true;
+void AStarNodes::openNode(AStarNode* node) {
+	if (node->heapIndex < 0) {
+		pushHeap(node);
 		--closedNodes;
+	} else {
+		siftUp(node->heapIndex);
 	}
 }
 
@@ -85,11 +112,78 @@ int_fast32_t AStarNodes::getClosedNodes() const {
 }
 
 AStarNode* AStarNodes::getNodeByPosition(uint32_t x, uint32_t y) {
-	auto it = nodeTable.find((x << 16) | y);
-	if (it == nodeTable.end()) {
-		return nullptr;
+	const uint32_t key = getKey(x, y);
+	auto index = (key * 0x9E3779B1u) & storage->mask;
+	while (storage->slots[index].generation == storage->generation) {
+		if (storage->slots[index].key == key) {
+			return storage->slots[index].node;
+		}
+		index = (index + 1) & storage->mask;
+	}
+	return nullptr;
+}
+
+void AStarNodes::pushHeap(AStarNode* node) {
+	auto &heap = storage->heap;
+	node->heapIndex = static_cast<int32_t>(heap.size());
+	heap.emplace_back(node);
+	siftUp(heap.size() - 1);
+}
+
+void AStarNodes::removeHeap(AStarNode* node) {
+	auto &heap = storage->heap;
+	const auto index = static_cast<size_t>(node->heapIndex);
+	node->heapIndex = -1;
+
+	AStarNode* last = heap.back();
+	heap.pop_back();
+	if (last == node) {
+		return;
+	}
+
+	heap[index] = last;
+	last->heapIndex = static_cast<int32_t>(index);
+	siftUp(index);
+	siftDown(static_cast<size_t>(last->heapIndex));
+}
+
+void AStarNodes::siftUp(size_t index) {
+	auto &heap = storage->heap;
+	AStarNode* node = heap[index];
+	while (index > 0) {
+		const auto parent = (index - 1) / 2;
+		if (!isBetter(node, heap[parent])) {
+			break;
+		}
+		heap[index] = heap[parent];
+		heap[index]->heapIndex = static_cast<int32_t>(index);
+		index = parent;
+	}
+	heap[index] = node;
+	node->heapIndex = static_cast<int32_t>(index);
+}
+
+void AStarNodes::siftDown(size_t index) {
+	auto &heap = storage->heap;
+	const auto size = heap.size();
+	AStarNode* node = heap[index];
+	while (true) {
+		auto child = index * 2 + 1;
+		if (child >= size) {
+			break;
+		}
+		if (child + 1 < size && isBetter(heap[child + 1], heap[child])) {
+			++child;
+		}
+		if (!isBetter(heap[child], node)) {
+			break;
+		}
+		heap[index] = heap[child];
+		heap[index]->heapIndex = static_cast<int32_t>(index);
+		index = child;
 	}
-	return it->second;
+	heap[index] = node;
+	node->heapIndex = static_cast<int32_t>(index);
 }
 
 int_fast32_t AStarNodes::getMapWalkCost(AStarNode* node, const Position &neighborPos, bool preferDiagonal) {
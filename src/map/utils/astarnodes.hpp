@@ -9,6 +9,8 @@
 
 #pragma once
 
+#include "map/map_const.hpp"
+
 class Position;
 class Creature;
 class Tile;
@@ -17,16 +19,32 @@ struct AStarNode {
 	AStarNode* parent;
 	int_fast32_t f;
 	uint16_t x, y;
+	// position in the open list heap, -1 once closed
+	int32_t heapIndex;
 };
 
+/**
+ * Open/closed node storage of a single A* search.
+ * The open list is an indexed binary heap (ties broken by creation order, as the old linear scan did),
+ * positions are looked up in an open-addressed table, and both are borrowed from a per-thread pool,
+ * so a search does not allocate once the pool has grown to the configured node limit.
+ */
 class AStarNodes {
 public:
-	AStarNodes(uint32_t x, uint32_t y);
+	static constexpr int32_t DEFAULT_MAX_NODES = MAP_PATHFINDING_DEFAULT_MAX_NODES;
+
+	AStarNodes(uint32_t x, uint32_t y, int32_t maxNodes = DEFAULT_MAX_NODES);
+	~AStarNodes();
+
+	// non-copyable
+	AStarNodes(const AStarNodes &) = delete;
+	AStarNodes &operator=(const AStarNodes &) = delete;
 
 	AStarNode* createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f);
 	AStarNode* getBestNode();
-	void closeNode(const AStarNode* node);
-	void openNode(const AStarNode* node);
+	void closeNode(AStarNode* node);
+	// Reopens a closed node or, as its f must only have decreased, moves an open one up the heap
+	void openNode(AStarNode* node);
 	int_fast32_t getClosedNodes() const;
 	AStarNode* getNodeByPosition(uint32_t x, uint32_t y);
 
@@ -34,14 +52,47 @@ public:
 	static int_fast32_t getTileWalkCost(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Tile> &tile);
 
 private:
-	static constexpr int32_t MAX_NODES = 512;
 	static constexpr int32_t MAP_NORMALWALKCOST = 10;
 	static constexpr int32_t MAP_PREFERDIAGONALWALKCOST = 14;
 	static constexpr int32_t MAP_DIAGONALWALKCOST = 25;
 
-	AStarNode nodes[MAX_NODES];
-	bool openNodes[MAX_NODES];
-	phmap::flat_hash_map<uint32_t, AStarNode*> nodeTable;
+	struct Storage {
+		struct Slot {
+			uint32_t key;
+			uint32_t generation;
+			AStarNode* node;
+		};
+
+		void prepare(size_t maxNodes);
+
+		std::vector<AStarNode> nodes;
+		std::vector<AStarNode*> heap;
+		// a slot is only used when its generation is the current one, so there is nothing to clear between searches
+		std::vector<Slot> slots;
+		uint32_t generation = 0;
+		uint32_t mask = 0;
+	};
+
+	static thread_local std::vector<std::unique_ptr<Storage>> storagePool;
+
+	static std::unique_ptr<Storage> acquireStorage();
+	static void releaseStorage(std::unique_ptr<Storage> storage);
+
+	static uint32_t getKey(uint32_t x, uint32_t y) {
+		return (x << 16) | y;
+	}
+
+	static bool isBetter(const AStarNode* a, const AStarNode* b) {
+		return a->f < b->f || (a->f == b->f && a < b);
+	}
+
+	void pushHeap(AStarNode* node);
+	void removeHeap(AStarNode* node);
+	void siftUp(size_t index);
+	void siftDown(size_t index);
+
+	std::unique_ptr<Storage> storage;
+	size_t maxNodes;
 	size_t curNode;
 	int_fast32_t closedNodes;
 };
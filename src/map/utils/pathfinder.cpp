@@ -0,0 +1,303 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "map/utils/pathfinder.hpp"
+#include "map/utils/astarnodes.hpp"
+#include "creatures/creature.hpp"
+#include "game/game.hpp"
+#include "game/scheduling/dispatcher.hpp"
+#include "lib/di/container.hpp"
+
+void PathfindingGrid::capture(const std::shared_ptr<Creature> &creature, const Position &startPos, const Position &targetPos, int32_t maxSearchDist) {
+	static constexpr int32_t MAX_COORDINATE = std::numeric_limits<uint16_t>::max();
+
+	// the search never leaves the square around the start, the sight lines also reach the target
+	const int32_t minX = std::max<int32_t>(std::min<int32_t>(startPos.x - maxSearchDist, targetPos.x), 0);
+	const int32_t minY = std::max<int32_t>(std::min<int32_t>(startPos.y - maxSearchDist, targetPos.y), 0);
+	const int32_t maxX = std::min<int32_t>(std::max<int32_t>(startPos.x + maxSearchDist, targetPos.x), MAX_COORDINATE);
+	const int32_t maxY = std::min<int32_t>(std::max<int32_t>(startPos.y + maxSearchDist, targetPos.y), MAX_COORDINATE);
+
+	originX = minX;
+	originY = minY;
+	width = maxX - minX + 1;
+	height = maxY - minY + 1;
+	z = startPos.z;
+	cells.assign(static_cast<size_t>(width) * height, Cell());
+
+	auto &map = g_game().map;
+	// a leaf at a time, so the quadtree is not walked down again for every tile
+	for (int32_t leafY = minY & ~FLOOR_MASK; leafY <= maxY; leafY += FLOOR_SIZE) {
+		for (int32_t leafX = minX & ~FLOOR_MASK; leafX <= maxX; leafX += FLOOR_SIZE) {
+			const auto leaf = map.getQTNode(static_cast<uint16_t>(leafX), static_cast<uint16_t>(leafY));
+			if (!leaf) {
+				continue;
+			}
+
+			const auto &floor = leaf->getFloor(z);
+			if (!floor) {
+				continue;
+			}
+
+			for (int32_t y = std::max(leafY, minY), endY = std::min(leafY + FLOOR_MASK, maxY); y <= endY; ++y) {
+				const bool searchRow = std::abs(y - startPos.y) <= maxSearchDist;
+				for (int32_t x = std::max(leafX, minX), endX = std::min(leafX + FLOOR_MASK, maxX); x <= endX; ++x) {
+					auto tile = floor->getTile(x, y);
+					if (!tile) {
+						if (floor->getTileCache(x, y) == 0) {
+							continue;
+						}
+
+						// still a map cache record, created like any other lookup would
+						tile = map.getTile(x, y, z);
+						if (!tile) {
+							continue;
+						}
+					}
+
+					captureCell(creature, tile, x, y, searchRow && std::abs(x - startPos.x) <= maxSearchDist);
+				}
+			}
+		}
+	}
+}
+
+void PathfindingGrid::captureCell(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Tile> &tile, int32_t x, int32_t y, bool searched) {
+	auto &cell = cells[(y - originY) * width + (x - originX)];
+	cell.flags = CELL_EXISTS;
+	if (tile->hasFlag(TILESTATE_BLOCKPROJECTILE)) {
+		cell.flags |= CELL_BLOCK_PROJECTILE;
+	}
+
+	// the sight lines also cross tiles the search never enters
+	if (!searched) {
+		return;
+	}
+
+	// the walk cache answers for the view of the creature, only the tiles beyond it are queried
+	const Position pos(x, y, z);
+	const int32_t walkCache = creature->getWalkCache(pos);
+	if (walkCache == 1 || (walkCache == 2 && g_game().map.canWalkTo(creature, pos))) {
+		cell.flags |= CELL_WALKABLE;
+	}
+
+	// nothing else adds to the walk cost
+	if (tile->getCreatures() || tile->hasFlag(TILESTATE_MAGICFIELD)) {
+		cell.extraCost = static_cast<uint16_t>(AStarNodes::getTileWalkCost(creature, tile));
+	}
+}
+
+bool PathfindingGrid::isSightClear(const Position &fromPos, const Position &toPos) const {
+	if (fromPos.z != toPos.z) {
+		return false;
+	}
+
+	return checkSightLine(fromPos, toPos) || checkSightLine(toPos, fromPos);
+}
+
+bool PathfindingGrid::checkSightLine(const Position &fromPos, const Position &toPos) const {
+	// same walk as Map::checkSightLine, both positions are on the snapshot floor
+	if (fromPos == toPos) {
+		return true;
+	}
+
+	Position start(fromPos);
+	const Position &destination = toPos;
+
+	const int8_t mx = start.x < destination.x ? 1 : start.x == destination.x ? 0
+																			 : -1;
+	const int8_t my = start.y < destination.y ? 1 : start.y == destination.y ? 0
+																			 : -1;
+
+	int32_t A = Position::getOffsetY(destination, start);
+	int32_t B = Position::getOffsetX(start, destination);
+	int32_t C = -(A * destination.x + B * destination.y);
+
+	while (start.x != destination.x || start.y != destination.y) {
+		int32_t move_hor = std::abs(A * (start.x + mx) + B * (start.y) + C);
+		int32_t move_ver = std::abs(A * (start.x) + B * (start.y + my) + C);
+		int32_t move_cross = std::abs(A * (start.x + mx) + B * (start.y + my) + C);
+
+		if (start.y != destination.y && (start.x == destination.x || move_hor > move_ver || move_hor > move_cross)) {
+			start.y += my;
+		}
+
+		if (start.x != destination.x && (start.y == destination.y || move_ver > move_hor || move_ver > move_cross)) {
+			start.x += mx;
+		}
+
+		const auto* cell = getCell(start.x, start.y);
+		if (cell && (cell->flags & CELL_BLOCK_PROJECTILE)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool PathfindingGrid::matches(const FrozenPathingConditionCall &pathCondition, const Position &startPos, const Position &testPos, const FindPathParams &fpp, int32_t &bestMatchDist) const {
+	return pathCondition(startPos, testPos, fpp, bestMatchDist, [this](const Position &fromPos, const Position &toPos) {
+		return isSightClear(fromPos, toPos);
+	});
+}
+
+bool PathfindingGrid::canEnter(const Position &pos, bool known, int_fast32_t &extraCost) const {
+	const auto* cell = getCell(pos.x, pos.y);
+	if (!cell || !(cell->flags & CELL_EXISTS)) {
+		return false;
+	}
+
+	// a known node was already walked into, only new ones need the walk check
+	if (!known && !(cell->flags & CELL_WALKABLE)) {
+		return false;
+	}
+
+	extraCost = cell->extraCost;
+	return true;
+}
+
+Pathfinder::Pathfinder(ThreadPool &threadPool) :
+	threadPool(threadPool) { }
+
+Pathfinder &Pathfinder::getInstance() {
+	return inject<Pathfinder>();
+}
+
+void Pathfinder::requestFollowPath(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Creature> &target, const FindPathParams &fpp, bool executeOnFollow, std::function<void()> &&onComplete) {
+	requested.fetch_add(1, std::memory_order_relaxed);
+
+	const Request request { creature->getPosition(), target->getPosition(), target->getID(), fpp, executeOnFollow };
+	switch (requests.add(creature->getID(), request, std::move(onComplete))) {
+		case FollowPathRequests::Result::Coalesced:
+			coalesced.fetch_add(1, std::memory_order_relaxed);
+			return;
+		case FollowPathRequests::Result::Superseded:
+			superseded.fetch_add(1, std::memory_order_relaxed);
+			return;
+		case FollowPathRequests::Result::Submit:
+			break;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	auto grid = std::make_shared<PathfindingGrid>();
+	grid->capture(creature, request.startPos, request.targetPos, fpp.maxSearchDist);
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+	captureTime.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+
+	submit(creature->getID(), request, std::move(grid));
+}
+
+void Pathfinder::submit(uint32_t creatureId, const Request &request, std::shared_ptr<PathfindingGrid> grid) {
+	threadPool.addLoad([this, creatureId, request, grid = std::move(grid)] {
+		const auto start = std::chrono::steady_clock::now();
+
+		stdext::arraylist<Direction> listDir(128);
+		const bool found = Map::getPathMatching(*grid, request.startPos, listDir, FrozenPathingConditionCall(request.targetPos), request.fpp);
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		searchTime.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+
+		g_dispatcher().addEvent(
+			[this, creatureId, request, found, listDir = std::move(listDir)]() mutable {
+				onPathFound(creatureId, request, found, listDir);
+			},
+			"Pathfinder::onPathFound"
+		);
+	});
+}
+
+void Pathfinder::onPathFound(uint32_t creatureId, const Request &request, bool found, stdext::arraylist<Direction> &listDir) {
+	auto finished = requests.finish(creatureId);
+	const auto complete = [&finished] {
+		if (finished.onComplete) {
+			g_dispatcher().context().addEvent(std::move(finished.onComplete));
+		}
+	};
+
+	const auto &creature = g_game().getCreatureByID(creatureId);
+	if (!creature || creature->isRemoved() || creature->getHealth() <= 0) {
+		discarded.fetch_add(1, std::memory_order_relaxed);
+		complete();
+		return;
+	}
+
+	// a stale path does not start where the creature is or does not go where its target is
+	if (finished.rerun || creature->getPosition() != request.startPos || !creature->onFollowPathFound(request.targetId, request.targetPos, found, listDir, request.executeOnFollow)) {
+		discarded.fetch_add(1, std::memory_order_relaxed);
+		// the callbacks do not wait on the next search, a target that keeps moving would hold them forever
+		complete();
+		creature->goToFollowCreature_async();
+		return;
+	}
+
+	completed.fetch_add(1, std::memory_order_relaxed);
+	complete();
+}
+
+FollowPathRequests::Result FollowPathRequests::add(uint32_t creatureId, const Request &request, std::function<void()> &&onComplete) {
+	const auto [it, inserted] = jobs.try_emplace(creatureId);
+	auto &job = it->second;
+	if (onComplete) {
+		job.onComplete.emplace_back(std::move(onComplete));
+	}
+
+	if (inserted) {
+		job.request = request;
+		return Result::Submit;
+	}
+
+	if (job.request == request) {
+		return Result::Coalesced;
+	}
+
+	job.rerun = true;
+	return Result::Superseded;
+}
+
+FollowPathRequests::Finished FollowPathRequests::finish(uint32_t creatureId) {
+	const auto it = jobs.find(creatureId);
+	if (it == jobs.end()) {
+		return {};
+	}
+
+	Finished finished { it->second.rerun, nullptr };
+	if (!it->second.onComplete.empty()) {
+		finished.onComplete = [callbacks = std::move(it->second.onComplete)] {
+			for (const auto &callback : callbacks) {
+				callback();
+			}
+		};
+	}
+	jobs.erase(it);
+	return finished;
+}
+
+Pathfinder::Stats Pathfinder::getStats() const {
+	return {
+		requested.load(std::memory_order_relaxed),
+		coalesced.load(std::memory_order_relaxed),
+		superseded.load(std::memory_order_relaxed),
+		completed.load(std::memory_order_relaxed),
+		discarded.load(std::memory_order_relaxed),
+		searchTime.load(std::memory_order_relaxed),
+		captureTime.load(std::memory_order_relaxed),
+		requests.size(),
+	};
+}
+
+void Pathfinder::resetStats() {
+	requested.store(0, std::memory_order_relaxed);
+	coalesced.store(0, std::memory_order_relaxed);
+	superseded.store(0, std::memory_order_relaxed);
+	completed.store(0, std::memory_order_relaxed);
+	discarded.store(0, std::memory_order_relaxed);
+	searchTime.store(0, std::memory_order_relaxed);
+	captureTime.store(0, std::memory_order_relaxed);
+}
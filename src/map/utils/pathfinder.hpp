@@ -0,0 +1,197 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "creatures/creatures_definitions.hpp"
+#include "game/movement/position.hpp"
+#include "lib/thread/thread_pool.hpp"
+
+class Creature;
+class FrozenPathingConditionCall;
+class Tile;
+
+/**
+ * Read-only copy of what a follow search needs from the map: whether each tile of the
+ * search square exists, can be walked by the creature and its extra walk cost, plus which tiles
+ * between it and the target block projectiles.
+ * It is captured on the dispatcher and can then be searched by Map::getPathMatching on any thread.
+ * The capture walks the square a quadtree leaf at a time and only reads what is already at hand:
+ * tile flags, the walk cache the creature keeps of its view and, for the few tiles with creatures
+ * or fields on them, their walk cost. Only tiles outside the walk cache need a queryAdd.
+ */
+class PathfindingGrid {
+public:
+	// Dispatcher only, the creature must be on the floor of startPos
+	void capture(const std::shared_ptr<Creature> &creature, const Position &startPos, const Position &targetPos, int32_t maxSearchDist);
+
+	// same floor line of sight, as Map::isSightClear(fromPos, toPos, true)
+	bool isSightClear(const Position &fromPos, const Position &toPos) const;
+
+	bool preferDiagonal() const {
+		return false;
+	}
+
+	bool matches(const FrozenPathingConditionCall &pathCondition, const Position &startPos, const Position &testPos, const FindPathParams &fpp, int32_t &bestMatchDist) const;
+
+	bool canEnter(const Position &pos, bool known, int_fast32_t &extraCost) const;
+
+	size_t size() const {
+		return cells.size();
+	}
+
+private:
+	enum CellFlags : uint8_t {
+		CELL_EXISTS = 1 << 0,
+		CELL_WALKABLE = 1 << 1,
+		CELL_BLOCK_PROJECTILE = 1 << 2,
+	};
+
+	struct Cell {
+		uint8_t flags = 0;
+		uint16_t extraCost = 0;
+	};
+
+	const Cell* getCell(int32_t x, int32_t y) const {
+		const auto offsetX = x - originX;
+		const auto offsetY = y - originY;
+		if (offsetX < 0 || offsetY < 0 || offsetX >= width || offsetY >= height) {
+			return nullptr;
+		}
+		return &cells[offsetY * width + offsetX];
+	}
+
+	bool checkSightLine(const Position &fromPos, const Position &toPos) const;
+	void captureCell(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Tile> &tile, int32_t x, int32_t y, bool searched);
+
+	std::vector<Cell> cells;
+	int32_t originX = 0;
+	int32_t originY = 0;
+	int32_t width = 0;
+	int32_t height = 0;
+	uint8_t z = 0;
+};
+
+/**
+ * The follow searches in flight, at most one per creature.
+ * A repeated request for the same start, target and parameters is coalesced into the running
+ * search, a different one marks it to be run again once it is done. The onComplete callbacks of
+ * every request are kept until then, so they run after the path they waited for is applied.
+ * Dispatcher only.
+ */
+class FollowPathRequests {
+public:
+	struct Request {
+		Position startPos;
+		Position targetPos;
+		uint32_t targetId = 0;
+		FindPathParams fpp;
+		bool executeOnFollow = false;
+
+		bool operator==(const Request &) const = default;
+	};
+
+	enum class Result : uint8_t {
+		// no search was running, one has to be started
+		Submit,
+		Coalesced,
+		Superseded,
+	};
+
+	Result add(uint32_t creatureId, const Request &request, std::function<void()> &&onComplete);
+
+	struct Finished {
+		// a different request arrived while it was searching
+		bool rerun = false;
+		// the callbacks of every request that waited on it, empty when there were none
+		std::function<void()> onComplete;
+	};
+
+	// Forgets the search of the creature, its result is back
+	Finished finish(uint32_t creatureId);
+
+	bool contains(uint32_t creatureId) const {
+		return jobs.contains(creatureId);
+	}
+
+	size_t size() const {
+		return jobs.size();
+	}
+
+private:
+	struct Job {
+		Request request;
+		bool rerun = false;
+		std::vector<std::function<void()>> onComplete;
+	};
+
+	phmap::flat_hash_map<uint32_t, Job> jobs;
+};
+
+/**
+ * Runs the follow searches of monsters on the thread pool, so the dispatcher only pays for
+ * the walkability snapshot and for applying the path.
+ * Requests are tracked by FollowPathRequests: a finished search is discarded and started again
+ * when a different request arrived meanwhile, the creature moved or its target is no longer
+ * where the search went.
+ */
+class Pathfinder {
+public:
+	explicit Pathfinder(ThreadPool &threadPool);
+
+	// Ensures that we don't accidentally copy it
+	Pathfinder(const Pathfinder &) = delete;
+	Pathfinder &operator=(const Pathfinder &) = delete;
+
+	static Pathfinder &getInstance();
+
+	struct Stats {
+		uint64_t requested = 0;
+		uint64_t coalesced = 0;
+		uint64_t superseded = 0;
+		uint64_t completed = 0;
+		uint64_t discarded = 0;
+		// time spent on the thread pool, in microseconds
+		uint64_t searchTime = 0;
+		// time spent taking the snapshots on the dispatcher, in microseconds
+		uint64_t captureTime = 0;
+		size_t inFlight = 0;
+	};
+
+	/**
+	 * Searches a path to the current position of target for the creature, the result is handed to
+	 * Creature::onFollowPathFound on the dispatcher and onComplete runs after it.
+	 * Dispatcher only.
+	 */
+	void requestFollowPath(const std::shared_ptr<Creature> &creature, const std::shared_ptr<Creature> &target, const FindPathParams &fpp, bool executeOnFollow, std::function<void()> &&onComplete);
+
+	Stats getStats() const;
+	void resetStats();
+
+private:
+	using Request = FollowPathRequests::Request;
+
+	void submit(uint32_t creatureId, const Request &request, std::shared_ptr<PathfindingGrid> grid);
+	void onPathFound(uint32_t creatureId, const Request &request, bool found, stdext::arraylist<Direction> &listDir);
+
+	ThreadPool &threadPool;
+
+	// only touched on the dispatcher
+	FollowPathRequests requests;
+
+	std::atomic_uint64_t requested = 0;
+	std::atomic_uint64_t coalesced = 0;
+	std::atomic_uint64_t superseded = 0;
+	std::atomic_uint64_t completed = 0;
+	std::atomic_uint64_t discarded = 0;
+	std::atomic_uint64_t searchTime = 0;
+	std::atomic_uint64_t captureTime = 0;
+};
+
+constexpr auto g_pathfinder = Pathfinder::getInstance;
@@ -71,23 +71,144 @@ QTreeLeafNode* QTreeNode::getBestLeaf(uint32_t x, uint32_t y, uint32_t level) {
 }
 
 void QTreeLeafNode::addCreature(const std::shared_ptr<Creature> &c) {
+	const auto &pos = c->getPosition();
 	creature_list.push_back(c);
+	creature_positions.push_back(pos);
 
 	if (c->getPlayer()) {
 		player_list.push_back(c);
+		player_positions.push_back(pos);
 	}
 }
 
 void QTreeLeafNode::removeCreature(std::shared_ptr<Creature> c) {
 	auto iter = std::find(creature_list.begin(), creature_list.end(), c);
 	assert(iter != creature_list.end());
+	creature_positions.swapAndPop(iter - creature_list.begin());
 	*iter = creature_list.back();
 	creature_list.pop_back();
 
 	if (c->getPlayer()) {
 		iter = std::find(player_list.begin(), player_list.end(), c);
 		assert(iter != player_list.end());
+		player_positions.swapAndPop(iter - player_list.begin());
 		*iter = player_list.back();
 		player_list.pop_back();
 	}
 }
+
+void QTreeLeafNode::updateCreature(const std::shared_ptr<Creature> &c) {
+	const auto &pos = c->getPosition();
+	auto iter = std::find(creature_list.begin(), creature_list.end(), c);
+	if (iter == creature_list.end()) {
+		return;
+	}
+	creature_positions.set(iter - creature_list.begin(), pos);
+
+	if (c->getPlayer()) {
+		iter = std::find(player_list.begin(), player_list.end(), c);
+		if (iter != player_list.end()) {
+			player_positions.set(iter - player_list.begin(), pos);
+		}
+	}
+}
+
+void QTreeLeafNode::findCreatures(std::vector<std::shared_ptr<Creature>> &out, bool onlyPlayers, int32_t centerZ, int32_t minRangeZ, int32_t maxRangeZ, int32_t minX, int32_t maxX, int32_t minY, int32_t maxY) const {
+	const auto &list = onlyPlayers ? player_list : creature_list;
+	const auto &positions = onlyPlayers ? player_positions : creature_positions;
+	const auto size = list.size();
+	const int32_t* xs = positions.x.data();
+	const int32_t* ys = positions.y.data();
+	const int32_t* zs = positions.z.data();
+
+	// x - (centerZ - z) in [minX, maxX] is x + z in [minX + centerZ, maxX + centerZ], the same for y
+	minX += centerZ;
+	maxX += centerZ;
+	minY += centerZ;
+	maxY += centerZ;
+
+	size_t i = 0;
+#if defined(__AVX2__)
+	{
+		const __m256i lowZ = _mm256_set1_epi32(minRangeZ - 1);
+		const __m256i highZ = _mm256_set1_epi32(maxRangeZ + 1);
+		const __m256i lowX = _mm256_set1_epi32(minX - 1);
+		const __m256i highX = _mm256_set1_epi32(maxX + 1);
+		const __m256i lowY = _mm256_set1_epi32(minY - 1);
+		const __m256i highY = _mm256_set1_epi32(maxY + 1);
+		for (; i + 8 <= size; i += 8) {
+			const __m256i z = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(zs + i));
+			const __m256i x = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i)), z);
+			const __m256i y = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i)), z);
+
+			__m256i mask = _mm256_and_si256(_mm256_cmpgt_epi32(z, lowZ), _mm256_cmpgt_epi32(highZ, z));
+			mask = _mm256_and_si256(mask, _mm256_and_si256(_mm256_cmpgt_epi32(x, lowX), _mm256_cmpgt_epi32(highX, x)));
+			mask = _mm256_and_si256(mask, _mm256_and_si256(_mm256_cmpgt_epi32(y, lowY), _mm256_cmpgt_epi32(highY, y)));
+
+			for (auto bits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))); bits != 0; bits &= bits - 1) {
+				out.emplace_back(list[i + _mm_ctz(bits)]);
+			}
+		}
+	}
+#endif
+#if defined(__SSE2__)
+	{
+		const __m128i lowZ = _mm_set1_epi32(minRangeZ - 1);
+		const __m128i highZ = _mm_set1_epi32(maxRangeZ + 1);
+		const __m128i lowX = _mm_set1_epi32(minX - 1);
+		const __m128i highX = _mm_set1_epi32(maxX + 1);
+		const __m128i lowY = _mm_set1_epi32(minY - 1);
+		const __m128i highY = _mm_set1_epi32(maxY + 1);
+		for (; i + 4 <= size; i += 4) {
+			const __m128i z = _mm_loadu_si128(reinterpret_cast<const __m128i*>(zs + i));
+			const __m128i x = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(xs + i)), z);
+			const __m128i y = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ys + i)), z);
+
+			__m128i mask = _mm_and_si128(_mm_cmpgt_epi32(z, lowZ), _mm_cmplt_epi32(z, highZ));
+			mask = _mm_and_si128(mask, _mm_and_si128(_mm_cmpgt_epi32(x, lowX), _mm_cmplt_epi32(x, highX)));
+			mask = _mm_and_si128(mask, _mm_and_si128(_mm_cmpgt_epi32(y, lowY), _mm_cmplt_epi32(y, highY)));
+
+			for (auto bits = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask))); bits != 0; bits &= bits - 1) {
+				out.emplace_back(list[i + _mm_ctz(bits)]);
+			}
+		}
+	}
+#endif
+	findCreaturesFrom(out, list, positions, i, minRangeZ, maxRangeZ, minX, maxX, minY, maxY);
+}
+
+void QTreeLeafNode::findCreaturesScalar(std::vector<std::shared_ptr<Creature>> &out, bool onlyPlayers, int32_t centerZ, int32_t minRangeZ, int32_t maxRangeZ, int32_t minX, int32_t maxX, int32_t minY, int32_t maxY) const {
+	findCreaturesFrom(out, onlyPlayers ? player_list : creature_list, onlyPlayers ? player_positions : creature_positions, 0, minRangeZ, maxRangeZ, minX + centerZ, maxX + centerZ, minY + centerZ, maxY + centerZ);
+}
+
+void QTreeLeafNode::findCreaturesFrom(std::vector<std::shared_ptr<Creature>> &out, const std::vector<std::shared_ptr<Creature>> &list, const PackedPositions &positions, size_t first, int32_t minRangeZ, int32_t maxRangeZ, int32_t minX, int32_t maxX, int32_t minY, int32_t maxY) {
+	for (size_t i = first, size = list.size(); i < size; ++i) {
+		const auto z = positions.z[i];
+		const auto x = positions.x[i] + z;
+		const auto y = positions.y[i] + z;
+		if (z >= minRangeZ && z <= maxRangeZ && x >= minX && x <= maxX && y >= minY && y <= maxY) {
+			out.emplace_back(list[i]);
+		}
+	}
+}
+
+void QTreeLeafNode::PackedPositions::push_back(const Position &pos) {
+	x.push_back(pos.x);
+	y.push_back(pos.y);
+	z.push_back(pos.z);
+}
+
+void QTreeLeafNode::PackedPositions::set(size_t index, const Position &pos) {
+	x[index] = pos.x;
+	y[index] = pos.y;
+	z[index] = pos.z;
+}
+
+void QTreeLeafNode::PackedPositions::swapAndPop(size_t index) {
+	x[index] = x.back();
+	x.pop_back();
+	y[index] = y.back();
+	y.pop_back();
+	z[index] = z.back();
+	z.pop_back();
+}
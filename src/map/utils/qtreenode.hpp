@@ -14,6 +14,7 @@
 struct Floor;
 class QTreeLeafNode;
 class Creature;
+struct Position;
 
 class QTreeNode {
 public:
@@ -78,8 +79,32 @@ public:
 
 	void addCreature(const std::shared_ptr<Creature> &c);
 	void removeCreature(std::shared_ptr<Creature> c);
+	// Refreshes the packed position of a creature that moved inside this leaf
+	void updateCreature(const std::shared_ptr<Creature> &c);
+
+	/**
+	 * Appends to out the creatures (or players) whose position passes the spectators range test:
+	 * minRangeZ <= z <= maxRangeZ and, shifted by the floor offset (centerZ - z), minX <= x <= maxX and minY <= y <= maxY.
+	 */
+	void findCreatures(std::vector<std::shared_ptr<Creature>> &out, bool onlyPlayers, int32_t centerZ, int32_t minRangeZ, int32_t maxRangeZ, int32_t minX, int32_t maxX, int32_t minY, int32_t maxY) const;
+	// The same test one creature at a time, the baseline the vector kernels are measured against
+	void findCreaturesScalar(std::vector<std::shared_ptr<Creature>> &out, bool onlyPlayers, int32_t centerZ, int32_t minRangeZ, int32_t maxRangeZ, int32_t minX, int32_t maxX, int32_t minY, int32_t maxY) const;
 
 private:
+	// Positions of a creature list packed in the same order, so the range test does not dereference every creature
+	struct PackedPositions {
+		std::vector<int32_t> x;
+		std::vector<int32_t> y;
+		std::vector<int32_t> z;
+
+		void push_back(const Position &pos);
+		void set(size_t index, const Position &pos);
+		void swapAndPop(size_t index);
+	};
+
+	// The scalar range test from first on, with the bounds already shifted by centerZ
+	static void findCreaturesFrom(std::vector<std::shared_ptr<Creature>> &out, const std::vector<std::shared_ptr<Creature>> &list, const PackedPositions &positions, size_t first, int32_t minRangeZ, int32_t maxRangeZ, int32_t minX, int32_t maxX, int32_t minY, int32_t maxY);
+
 	static bool newLeaf;
 	QTreeLeafNode* leafS = nullptr;
 	QTreeLeafNode* leafE = nullptr;
@@ -88,6 +113,8 @@ private:
 
 	std::vector<std::shared_ptr<Creature>> creature_list;
 	std::vector<std::shared_ptr<Creature>> player_list;
+	PackedPositions creature_positions;
+	PackedPositions player_positions;
 
 	friend class Map;
 	friend class MapCache;
@@ -0,0 +1,158 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "map/utils/sector_activity.hpp"
+#include "game/movement/position.hpp"
+
+uint32_t SectorActivity::getSector(const Position &pos) {
+	return getSector(pos.x, pos.y);
+}
+
+void SectorActivity::addPlayer(const void* player, const Position &pos) {
+	const auto [it, inserted] = players.try_emplace(player, pos);
+	if (!inserted) {
+		// placed again without having been removed, it only moved
+		movePlayer(player, pos);
+		return;
+	}
+
+	watch(pos, 1);
+}
+
+void SectorActivity::removePlayer(const void* player) {
+	const auto it = players.find(player);
+	if (it == players.end()) {
+		return;
+	}
+
+	const Position pos = it->second;
+	players.erase(it);
+	watch(pos, -1);
+}
+
+void SectorActivity::movePlayer(const void* player, const Position &toPos) {
+	const auto it = players.find(player);
+	if (it == players.end()) {
+		return;
+	}
+
+	const Position fromPos = it->second;
+	it->second = toPos;
+	if (getSector(fromPos) == getSector(toPos)) {
+		return;
+	}
+
+	// the sectors in range of both stay watched, so they never go dormant in between
+	watch(toPos, 1, &fromPos);
+	watch(fromPos, -1, &toPos);
+}
+
+void SectorActivity::watch(const Position &pos, int32_t delta, const Position* skipPos /* = nullptr*/) {
+	const int32_t sectorX = pos.x >> FLOOR_BITS;
+	const int32_t sectorY = pos.y >> FLOOR_BITS;
+	const int32_t skipX = skipPos ? skipPos->x >> FLOOR_BITS : 0;
+	const int32_t skipY = skipPos ? skipPos->y >> FLOOR_BITS : 0;
+
+	for (int32_t x = std::max(sectorX - WAKE_RANGE, 0); x <= sectorX + WAKE_RANGE; ++x) {
+		for (int32_t y = std::max(sectorY - WAKE_RANGE, 0); y <= sectorY + WAKE_RANGE; ++y) {
+			if (skipPos && std::abs(x - skipX) <= WAKE_RANGE && std::abs(y - skipY) <= WAKE_RANGE) {
+				continue;
+			}
+
+			const uint32_t sector = getSector(x << FLOOR_BITS, y << FLOOR_BITS);
+			if (delta > 0) {
+				if (++watchers[sector] == 1) {
+					wake(sector);
+				}
+				continue;
+			}
+
+			const auto it = watchers.find(sector);
+			if (it != watchers.end() && --it->second == 0) {
+				watchers.erase(it);
+			}
+		}
+	}
+}
+
+bool SectorActivity::isDormant(const Position &pos, int32_t radius /* = 0*/) const {
+	bool dormant = true;
+	forEachSector(pos, radius, [this, &dormant](uint32_t sector) {
+		dormant = dormant && !watchers.contains(sector);
+	});
+	return dormant;
+}
+
+void SectorActivity::wake(uint32_t sector) {
+	const auto it = sleepers.find(sector);
+	if (it == sleepers.end()) {
+		return;
+	}
+
+	// the callbacks may sleep again, so every owner is taken out of all its sectors first
+	const auto owners = std::move(it->second);
+	sleepers.erase(it);
+
+	std::vector<std::function<void()>> callbacks;
+	callbacks.reserve(owners.size());
+	for (const auto owner : owners) {
+		const auto areaIt = sleeperAreas.find(owner);
+		if (areaIt == sleeperAreas.end()) {
+			continue;
+		}
+
+		callbacks.emplace_back(std::move(areaIt->second.onWake));
+		cancel(owner);
+	}
+
+	woken += callbacks.size();
+	for (const auto &onWake : callbacks) {
+		onWake();
+	}
+}
+
+void SectorActivity::sleep(const Position &pos, int32_t radius, const void* owner, std::function<void()> onWake) {
+	cancel(owner);
+
+	if (!isDormant(pos, radius)) {
+		onWake();
+		return;
+	}
+
+	auto &area = sleeperAreas[owner];
+	area.onWake = std::move(onWake);
+	forEachSector(pos, radius, [this, owner, &area](uint32_t sector) {
+		sleepers[sector].emplace_back(owner);
+		area.sectors.emplace_back(sector);
+	});
+	++slept;
+}
+
+void SectorActivity::cancel(const void* owner) {
+	const auto it = sleeperAreas.find(owner);
+	if (it == sleeperAreas.end()) {
+		return;
+	}
+
+	for (const auto sector : it->second.sectors) {
+		const auto sectorIt = sleepers.find(sector);
+		if (sectorIt == sleepers.end()) {
+			continue;
+		}
+
+		auto &owners = sectorIt->second;
+		std::erase(owners, owner);
+		if (owners.empty()) {
+			sleepers.erase(sectorIt);
+		}
+	}
+	sleeperAreas.erase(it);
+}
@@ -0,0 +1,101 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "map/map_const.hpp"
+#include "game/movement/position.hpp"
+
+/**
+ * Tracks which sectors of the map have a player close enough to see them.
+ * A sector is a column of FLOOR_SIZE x FLOOR_SIZE tiles on every floor, the area of a
+ * QTreeLeafNode. Every player keeps the sectors within WAKE_RANGE of its own awake, the
+ * rest of the map is dormant.
+ * Work that only matters while someone is around can sleep on a dormant sector instead of
+ * polling it, and is woken once when the first player comes in range.
+ */
+class SectorActivity {
+public:
+	// in sectors, the view port plus a sector, so what wakes up is settled before it can be seen
+	static constexpr int32_t WAKE_RANGE = (std::max(MAP_MAX_VIEW_PORT_X, MAP_MAX_VIEW_PORT_Y) + 2 * FLOOR_SIZE - 1) / FLOOR_SIZE;
+
+	// Players are tracked by where they were added, so they are removed at most once
+	void addPlayer(const void* player, const Position &pos);
+	void removePlayer(const void* player);
+	// Only changes anything when the player went to another sector
+	void movePlayer(const void* player, const Position &toPos);
+
+	// Dormant while no sector within radius tiles of pos is awake
+	bool isDormant(const Position &pos, int32_t radius = 0) const;
+
+	/**
+	 * Calls onWake once any sector within radius tiles of pos is awake again, right away if one already is.
+	 * It is called while a player is being placed or moved, so it should only schedule work.
+	 * An owner sleeps on one area at a time, sleeping again replaces the previous callback.
+	 */
+	void sleep(const Position &pos, int32_t radius, const void* owner, std::function<void()> onWake);
+	void cancel(const void* owner);
+
+	struct Stats {
+		size_t awakeSectors = 0;
+		size_t sleepers = 0;
+		uint64_t slept = 0;
+		uint64_t woken = 0;
+	};
+
+	Stats getStats() const {
+		return { watchers.size(), sleeperAreas.size(), slept, woken };
+	}
+
+	void resetStats() {
+		slept = 0;
+		woken = 0;
+	}
+
+private:
+	static uint32_t getSector(int32_t x, int32_t y) {
+		return (static_cast<uint32_t>(x >> FLOOR_BITS) << 16) | static_cast<uint32_t>(y >> FLOOR_BITS);
+	}
+	static uint32_t getSector(const Position &pos);
+
+	// Calls f with every sector that has a tile within radius tiles of pos
+	template <typename F>
+	static void forEachSector(const Position &pos, int32_t radius, F &&f) {
+		const int32_t minX = std::max<int32_t>(pos.x - radius, 0) >> FLOOR_BITS;
+		const int32_t minY = std::max<int32_t>(pos.y - radius, 0) >> FLOOR_BITS;
+		const int32_t maxX = (pos.x + radius) >> FLOOR_BITS;
+		const int32_t maxY = (pos.y + radius) >> FLOOR_BITS;
+		for (int32_t x = minX; x <= maxX; ++x) {
+			for (int32_t y = minY; y <= maxY; ++y) {
+				f(getSector(x << FLOOR_BITS, y << FLOOR_BITS));
+			}
+		}
+	}
+
+	// Adds delta to the watchers of the sectors around the one of pos, skipping those around skipPos
+	void watch(const Position &pos, int32_t delta, const Position* skipPos = nullptr);
+	void wake(uint32_t sector);
+
+	// position each player watches from
+	phmap::flat_hash_map<const void*, Position> players;
+	// players in range of each awake sector, dormant sectors are not in it
+	phmap::flat_hash_map<uint32_t, uint32_t> watchers;
+	// owners sleeping on each dormant sector
+	phmap::flat_hash_map<uint32_t, std::vector<const void*>> sleepers;
+
+	struct SleepingArea {
+		std::vector<uint32_t> sectors;
+		std::function<void()> onWake;
+	};
+	// sectors each owner sleeps on
+	phmap::flat_hash_map<const void*, SleepingArea> sleeperAreas;
+
+	uint64_t slept = 0;
+	uint64_t woken = 0;
+};
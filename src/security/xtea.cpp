@@ -0,0 +1,331 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "security/xtea.hpp"
+
+#if !defined(__DISABLE_VECTORIZATION__) && (defined(__SSE2__) || defined(_M_X64))
+	#define XTEA_SSE2 1
+	#include <emmintrin.h>
+	#include <immintrin.h>
+
+	#if defined(__GNUC__) || defined(__clang__)
+		#define XTEA_AVX2 1
+		#define XTEA_TARGET_AVX2 __attribute__((target("avx2")))
+	#elif defined(_MSC_VER)
+		#define XTEA_AVX2 1
+		#define XTEA_TARGET_AVX2
+	#endif
+#endif
+
+namespace xtea {
+	namespace {
+		constexpr uint32_t DELTA = 0x61C88647;
+		constexpr size_t ROUNDS = 32;
+
+		void encryptScalar(uint8_t* data, size_t length, const RoundKeys &keys) {
+			for (size_t pos = 0; pos < length; pos += 8) {
+				std::array<uint32_t, 2> v;
+				memcpy(v.data(), data + pos, 8);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					v[0] += ((v[1] << 4 ^ v[1] >> 5) + v[1]) ^ keys[i * 2];
+					v[1] += ((v[0] << 4 ^ v[0] >> 5) + v[0]) ^ keys[i * 2 + 1];
+				}
+				memcpy(data + pos, v.data(), 8);
+			}
+		}
+
+		void decryptScalar(uint8_t* data, size_t length, const RoundKeys &keys) {
+			for (size_t pos = 0; pos < length; pos += 8) {
+				std::array<uint32_t, 2> v;
+				memcpy(v.data(), data + pos, 8);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					v[1] -= ((v[0] << 4 ^ v[0] >> 5) + v[0]) ^ keys[i * 2];
+					v[0] -= ((v[1] << 4 ^ v[1] >> 5) + v[1]) ^ keys[i * 2 + 1];
+				}
+				memcpy(data + pos, v.data(), 8);
+			}
+		}
+
+#if defined(XTEA_SSE2)
+		// Two registers of 4 interleaved blocks become one with the first words and one with the second,
+		// the lane order does not matter as long as the store undoes it
+		inline void splitSSE2(const uint8_t* data, __m128i &v0, __m128i &v1) {
+			const auto a = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+			const auto b = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)));
+			v0 = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+			v1 = _mm_castps_si128(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+
+		inline void joinSSE2(uint8_t* data, __m128i v0, __m128i v1) {
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(data), _mm_unpacklo_epi32(v0, v1));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(data + 16), _mm_unpackhi_epi32(v0, v1));
+		}
+
+		inline __m128i mixSSE2(__m128i v) {
+			return _mm_add_epi32(_mm_xor_si128(_mm_slli_epi32(v, 4), _mm_srli_epi32(v, 5)), v);
+		}
+
+		void encryptSSE2(uint8_t* data, size_t length, const RoundKeys &keys) {
+			size_t pos = 0;
+			// two independent groups of 4 blocks, so the rounds of one hide the latency of the other
+			for (; pos + 64 <= length; pos += 64) {
+				__m128i a0, a1, b0, b1;
+				splitSSE2(data + pos, a0, a1);
+				splitSSE2(data + pos + 32, b0, b1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					const auto k0 = _mm_set1_epi32(static_cast<int32_t>(keys[i * 2]));
+					const auto k1 = _mm_set1_epi32(static_cast<int32_t>(keys[i * 2 + 1]));
+					a0 = _mm_add_epi32(a0, _mm_xor_si128(mixSSE2(a1), k0));
+					b0 = _mm_add_epi32(b0, _mm_xor_si128(mixSSE2(b1), k0));
+					a1 = _mm_add_epi32(a1, _mm_xor_si128(mixSSE2(a0), k1));
+					b1 = _mm_add_epi32(b1, _mm_xor_si128(mixSSE2(b0), k1));
+				}
+				joinSSE2(data + pos, a0, a1);
+				joinSSE2(data + pos + 32, b0, b1);
+			}
+
+			for (; pos + 32 <= length; pos += 32) {
+				__m128i v0, v1;
+				splitSSE2(data + pos, v0, v1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					v0 = _mm_add_epi32(v0, _mm_xor_si128(mixSSE2(v1), _mm_set1_epi32(static_cast<int32_t>(keys[i * 2]))));
+					v1 = _mm_add_epi32(v1, _mm_xor_si128(mixSSE2(v0), _mm_set1_epi32(static_cast<int32_t>(keys[i * 2 + 1]))));
+				}
+				joinSSE2(data + pos, v0, v1);
+			}
+
+			encryptScalar(data + pos, length - pos, keys);
+		}
+
+		void decryptSSE2(uint8_t* data, size_t length, const RoundKeys &keys) {
+			size_t pos = 0;
+			for (; pos + 64 <= length; pos += 64) {
+				__m128i a0, a1, b0, b1;
+				splitSSE2(data + pos, a0, a1);
+				splitSSE2(data + pos + 32, b0, b1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					const auto k0 = _mm_set1_epi32(static_cast<int32_t>(keys[i * 2]));
+					const auto k1 = _mm_set1_epi32(static_cast<int32_t>(keys[i * 2 + 1]));
+					a1 = _mm_sub_epi32(a1, _mm_xor_si128(mixSSE2(a0), k0));
+					b1 = _mm_sub_epi32(b1, _mm_xor_si128(mixSSE2(b0), k0));
+					a0 = _mm_sub_epi32(a0, _mm_xor_si128(mixSSE2(a1), k1));
+					b0 = _mm_sub_epi32(b0, _mm_xor_si128(mixSSE2(b1), k1));
+				}
+				joinSSE2(data + pos, a0, a1);
+				joinSSE2(data + pos + 32, b0, b1);
+			}
+
+			for (; pos + 32 <= length; pos += 32) {
+				__m128i v0, v1;
+				splitSSE2(data + pos, v0, v1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					v1 = _mm_sub_epi32(v1, _mm_xor_si128(mixSSE2(v0), _mm_set1_epi32(static_cast<int32_t>(keys[i * 2]))));
+					v0 = _mm_sub_epi32(v0, _mm_xor_si128(mixSSE2(v1), _mm_set1_epi32(static_cast<int32_t>(keys[i * 2 + 1]))));
+				}
+				joinSSE2(data + pos, v0, v1);
+			}
+
+			decryptScalar(data + pos, length - pos, keys);
+		}
+#endif
+
+#if defined(XTEA_AVX2)
+	// Same layout as the SSE2 kernel, shuffles and unpacks work inside each 128-bit half.
+	// Everything is spelled out in the functions, helpers would not inherit the target attribute.
+	#define XTEA_SPLIT_AVX2(ptr, v0, v1)                                                                          \
+		do {                                                                                                      \
+			const auto a = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)));        \
+			const auto b = _mm256_castsi256_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>((ptr) + 32))); \
+			v0 = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));                           \
+			v1 = _mm256_castps_si256(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));                           \
+		} while (false)
+
+	#define XTEA_JOIN_AVX2(ptr, v0, v1)                                                                 \
+		do {                                                                                            \
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), _mm256_unpacklo_epi32(v0, v1));        \
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>((ptr) + 32), _mm256_unpackhi_epi32(v0, v1)); \
+		} while (false)
+
+	#define XTEA_MIX_AVX2(v) _mm256_add_epi32(_mm256_xor_si256(_mm256_slli_epi32(v, 4), _mm256_srli_epi32(v, 5)), v)
+
+		XTEA_TARGET_AVX2 void encryptAVX2(uint8_t* data, size_t length, const RoundKeys &keys) {
+			size_t pos = 0;
+			for (; pos + 128 <= length; pos += 128) {
+				__m256i a0, a1, b0, b1;
+				XTEA_SPLIT_AVX2(data + pos, a0, a1);
+				XTEA_SPLIT_AVX2(data + pos + 64, b0, b1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					const auto k0 = _mm256_set1_epi32(static_cast<int32_t>(keys[i * 2]));
+					const auto k1 = _mm256_set1_epi32(static_cast<int32_t>(keys[i * 2 + 1]));
+					a0 = _mm256_add_epi32(a0, _mm256_xor_si256(XTEA_MIX_AVX2(a1), k0));
+					b0 = _mm256_add_epi32(b0, _mm256_xor_si256(XTEA_MIX_AVX2(b1), k0));
+					a1 = _mm256_add_epi32(a1, _mm256_xor_si256(XTEA_MIX_AVX2(a0), k1));
+					b1 = _mm256_add_epi32(b1, _mm256_xor_si256(XTEA_MIX_AVX2(b0), k1));
+				}
+				XTEA_JOIN_AVX2(data + pos, a0, a1);
+				XTEA_JOIN_AVX2(data + pos + 64, b0, b1);
+			}
+
+			for (; pos + 64 <= length; pos += 64) {
+				__m256i v0, v1;
+				XTEA_SPLIT_AVX2(data + pos, v0, v1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					v0 = _mm256_add_epi32(v0, _mm256_xor_si256(XTEA_MIX_AVX2(v1), _mm256_set1_epi32(static_cast<int32_t>(keys[i * 2]))));
+					v1 = _mm256_add_epi32(v1, _mm256_xor_si256(XTEA_MIX_AVX2(v0), _mm256_set1_epi32(static_cast<int32_t>(keys[i * 2 + 1]))));
+				}
+				XTEA_JOIN_AVX2(data + pos, v0, v1);
+			}
+
+			encryptSSE2(data + pos, length - pos, keys);
+		}
+
+		XTEA_TARGET_AVX2 void decryptAVX2(uint8_t* data, size_t length, const RoundKeys &keys) {
+			size_t pos = 0;
+			for (; pos + 128 <= length; pos += 128) {
+				__m256i a0, a1, b0, b1;
+				XTEA_SPLIT_AVX2(data + pos, a0, a1);
+				XTEA_SPLIT_AVX2(data + pos + 64, b0, b1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					const auto k0 = _mm256_set1_epi32(static_cast<int32_t>(keys[i * 2]));
+					const auto k1 = _mm256_set1_epi32(static_cast<int32_t>(keys[i * 2 + 1]));
+					a1 = _mm256_sub_epi32(a1, _mm256_xor_si256(XTEA_MIX_AVX2(a0), k0));
+					b1 = _mm256_sub_epi32(b1, _mm256_xor_si256(XTEA_MIX_AVX2(b0), k0));
+					a0 = _mm256_sub_epi32(a0, _mm256_xor_si256(XTEA_MIX_AVX2(a1), k1));
+					b0 = _mm256_sub_epi32(b0, _mm256_xor_si256(XTEA_MIX_AVX2(b1), k1));
+				}
+				XTEA_JOIN_AVX2(data + pos, a0, a1);
+				XTEA_JOIN_AVX2(data + pos + 64, b0, b1);
+			}
+
+			for (; pos + 64 <= length; pos += 64) {
+				__m256i v0, v1;
+				XTEA_SPLIT_AVX2(data + pos, v0, v1);
+				for (size_t i = 0; i < ROUNDS; ++i) {
+					v1 = _mm256_sub_epi32(v1, _mm256_xor_si256(XTEA_MIX_AVX2(v0), _mm256_set1_epi32(static_cast<int32_t>(keys[i * 2]))));
+					v0 = _mm256_sub_epi32(v0, _mm256_xor_si256(XTEA_MIX_AVX2(v1), _mm256_set1_epi32(static_cast<int32_t>(keys[i * 2 + 1]))));
+				}
+				XTEA_JOIN_AVX2(data + pos, v0, v1);
+			}
+
+			decryptSSE2(data + pos, length - pos, keys);
+		}
+
+	#undef XTEA_SPLIT_AVX2
+	#undef XTEA_JOIN_AVX2
+	#undef XTEA_MIX_AVX2
+#endif
+	}
+
+	RoundKeys expandEncryptKey(const Key &key) {
+		RoundKeys keys;
+		uint32_t sum = 0;
+		for (size_t i = 0; i < ROUNDS; ++i) {
+			keys[i * 2] = sum + key[sum & 3];
+			sum -= DELTA;
+			keys[i * 2 + 1] = sum + key[(sum >> 11) & 3];
+		}
+		return keys;
+	}
+
+	RoundKeys expandDecryptKey(const Key &key) {
+		RoundKeys keys;
+		uint32_t sum = 0xC6EF3720;
+		for (size_t i = 0; i < ROUNDS; ++i) {
+			keys[i * 2] = sum + key[(sum >> 11) & 3];
+			sum += DELTA;
+			keys[i * 2 + 1] = sum + key[sum & 3];
+		}
+		return keys;
+	}
+
+	bool isSupported(Implementation implementation) {
+		switch (implementation) {
+			case Implementation::Scalar:
+				return true;
+#if defined(XTEA_SSE2)
+			case Implementation::SSE2:
+				return true;
+#endif
+#if defined(XTEA_AVX2)
+			case Implementation::AVX2:
+				return simd::hasAVX2();
+#endif
+			default:
+				return false;
+		}
+	}
+
+	Implementation getImplementation() {
+		static const auto implementation = [] {
+			if (isSupported(Implementation::AVX2)) {
+				return Implementation::AVX2;
+			}
+			if (isSupported(Implementation::SSE2)) {
+				return Implementation::SSE2;
+			}
+			return Implementation::Scalar;
+		}();
+		return implementation;
+	}
+
+	std::string_view getImplementationName(Implementation implementation) {
+		switch (implementation) {
+			case Implementation::SSE2:
+				return "SSE2";
+			case Implementation::AVX2:
+				return "AVX2";
+			default:
+				return "scalar";
+		}
+	}
+
+	void encrypt(uint8_t* data, size_t length, const RoundKeys &keys) {
+		encrypt(data, length, keys, getImplementation());
+	}
+
+	void decrypt(uint8_t* data, size_t length, const RoundKeys &keys) {
+		decrypt(data, length, keys, getImplementation());
+	}
+
+	void encrypt(uint8_t* data, size_t length, const RoundKeys &keys, Implementation implementation) {
+		switch (implementation) {
+#if defined(XTEA_AVX2)
+			case Implementation::AVX2:
+				encryptAVX2(data, length, keys);
+				return;
+#endif
+#if defined(XTEA_SSE2)
+			case Implementation::SSE2:
+				encryptSSE2(data, length, keys);
+				return;
+#endif
+			default:
+				encryptScalar(data, length, keys);
+		}
+	}
+
+	void decrypt(uint8_t* data, size_t length, const RoundKeys &keys, Implementation implementation) {
+		switch (implementation) {
+#if defined(XTEA_AVX2)
+			case Implementation::AVX2:
+				decryptAVX2(data, length, keys);
+				return;
+#endif
+#if defined(XTEA_SSE2)
+			case Implementation::SSE2:
+				decryptSSE2(data, length, keys);
+				return;
+#endif
+			default:
+				decryptScalar(data, length, keys);
+		}
+	}
+}
@@ -0,0 +1,43 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * XTEA (32 rounds, little-endian words) as used by the client protocol.
+ * Blocks are independent, so the vectorized kernels run several of them in parallel lanes:
+ * 4 per register with SSE2 and 8 with AVX2, the best one the CPU supports is picked at runtime.
+ */
+namespace xtea {
+	using Key = std::array<uint32_t, 4>;
+	// the sum + key word of each half round, they only depend on the key
+	using RoundKeys = std::array<uint32_t, 64>;
+
+	enum class Implementation : uint8_t {
+		Scalar,
+		SSE2,
+		AVX2,
+	};
+
+	RoundKeys expandEncryptKey(const Key &key);
+	RoundKeys expandDecryptKey(const Key &key);
+
+	bool isSupported(Implementation implementation);
+	// the fastest implementation supported by this CPU
+	Implementation getImplementation();
+	std::string_view getImplementationName(Implementation implementation);
+
+	// length must be a multiple of 8
+	void encrypt(uint8_t* data, size_t length, const RoundKeys &keys);
+	void decrypt(uint8_t* data, size_t length, const RoundKeys &keys);
+
+	// Same, with a given implementation, it must be supported
+	void encrypt(uint8_t* data, size_t length, const RoundKeys &keys, Implementation implementation);
+	void decrypt(uint8_t* data, size_t length, const RoundKeys &keys, Implementation implementation);
+}
@@ -15,6 +15,13 @@
 #include "game/scheduling/dispatcher.hpp"
 #include "server/server.hpp"
 
+namespace {
+	std::atomic_uint64_t totalWrites = 0;
+	std::atomic_uint64_t totalWrittenMessages = 0;
+	std::atomic_uint64_t totalWrittenBytes = 0;
+	std::atomic_uint64_t totalOverflows = 0;
+}
+
 Connection_ptr ConnectionManager::createConnection(asio::io_service &io_service, ConstServicePort_ptr servicePort) {
 	auto connection = std::make_shared<Connection>(io_service, servicePort);
 	connections.emplace(connection);
@@ -64,7 +71,7 @@ void Connection::close(bool force) {
 		g_dispatcher().addEvent(std::bind_front(&Protocol::release, protocol), "Protocol::release", 1000);
 	}
 
-	if (messageQueue.empty() || force) {
+	if (!writing || force) {
 		closeSocket();
 	} else {
 		// will be closed by the destructor or onWriteOperation
@@ -292,15 +299,23 @@ void Connection::send(const OutputMessage_ptr &outputMessage) {
 		return;
 	}
 
-	bool noPendingWrite = messageQueue.empty();
-	messageQueue.emplace_back(outputMessage);
-	if (noPendingWrite) {
+	if (!messageQueue.push(outputMessage)) {
+		totalOverflows.fetch_add(1, std::memory_order_relaxed);
+		g_logger().warn("[Connection::send] - {} messages waiting to be written to {}, closing the connection", messageQueue.size(), convertIPToString(getIP()));
+		messageQueue.clear();
+		close(FORCE_CLOSE);
+		return;
+	}
+
+	if (!writing) {
+		writing = true;
 		// Make asio thread handle xtea encryption instead of dispatcher
 		try {
 			asio::post(socket.get_executor(), std::bind(&Connection::internalWorker, shared_from_this()));
 		} catch (const std::system_error &e) {
 			g_logger().error("[Connection::send] - error: {}", e.what());
 			messageQueue.clear();
+			writing = false;
 			close(FORCE_CLOSE);
 		}
 	}
@@ -308,15 +323,26 @@ void Connection::send(const OutputMessage_ptr &outputMessage) {
 
 void Connection::internalWorker() {
 	std::unique_lock<std::recursive_mutex> lockClass(connectionLock);
-	if (!messageQueue.empty()) {
-		const OutputMessage_ptr &outputMessage = messageQueue.front();
-		lockClass.unlock();
+	if (messageQueue.empty()) {
+		writing = false;
+		if (connectionState == CONNECTION_STATE_CLOSED) {
+			closeSocket();
+		}
+		return;
+	}
+
+	// everything queued so far goes in one write, what arrives meanwhile waits for the next one
+	while (!messageQueue.empty() && writeBatch.size() < MAX_WRITE_BATCH) {
+		writeBatch.emplace_back(messageQueue.pop());
+	}
+
+	lockClass.unlock();
+	for (const auto &outputMessage : writeBatch) {
 		protocol->onSendMessage(outputMessage);
-		lockClass.lock();
-		internalSend(outputMessage);
-	} else if (connectionState == CONNECTION_STATE_CLOSED) {
-		closeSocket();
 	}
+	lockClass.lock();
+
+	internalSend();
 }
 
 uint32_t Connection::getIP() {
@@ -333,37 +359,61 @@ uint32_t Connection::getIP() {
 	return ip;
 }
 
-void Connection::internalSend(const OutputMessage_ptr &outputMessage) {
+void Connection::internalSend() {
+	writeBuffers.clear();
+	for (const auto &outputMessage : writeBatch) {
+		writeBuffers.emplace_back(outputMessage->getOutputBuffer(), outputMessage->getLength());
+	}
+
 	try {
 		writeTimer.expires_from_now(std::chrono::seconds(CONNECTION_WRITE_TIMEOUT));
 		writeTimer.async_wait(std::bind(&Connection::handleTimeout, std::weak_ptr<Connection>(shared_from_this()), std::placeholders::_1));
 
-		asio::async_write(socket, asio::buffer(outputMessage->getOutputBuffer(), outputMessage->getLength()), std::bind(&Connection::onWriteOperation, shared_from_this(), std::placeholders::_1));
+		asio::async_write(socket, writeBuffers, std::bind(&Connection::onWriteOperation, shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 	} catch (const std::system_error &e) {
 		g_logger().error("[Connection::internalSend] - error: {}", e.what());
+		// no write completes to start the next batch, so the connection is closed as after a failed write
+		writeBatch.clear();
+		messageQueue.clear();
+		writing = false;
+		close(FORCE_CLOSE);
 	}
 }
 
-void Connection::onWriteOperation(const std::error_code &error) {
+void Connection::onWriteOperation(const std::error_code &error, size_t bytesTransferred) {
 	std::unique_lock<std::recursive_mutex> lockClass(connectionLock);
 	writeTimer.cancel();
-	messageQueue.pop_front();
+
+	totalWrites.fetch_add(1, std::memory_order_relaxed);
+	totalWrittenMessages.fetch_add(writeBatch.size(), std::memory_order_relaxed);
+	totalWrittenBytes.fetch_add(bytesTransferred, std::memory_order_relaxed);
+	writeBatch.clear();
 
 	if (error) {
 		messageQueue.clear();
+		writing = false;
 		close(FORCE_CLOSE);
 		return;
 	}
 
-	if (!messageQueue.empty()) {
-		const OutputMessage_ptr &outputMessage = messageQueue.front();
-		lockClass.unlock();
-		protocol->onSendMessage(outputMessage);
-		lockClass.lock();
-		internalSend(outputMessage);
-	} else if (connectionState == CONNECTION_STATE_CLOSED) {
-		closeSocket();
-	}
+	lockClass.unlock();
+	internalWorker();
+}
+
+Connection::WriteStats Connection::getWriteStats() {
+	return {
+		totalWrites.load(std::memory_order_relaxed),
+		totalWrittenMessages.load(std::memory_order_relaxed),
+		totalWrittenBytes.load(std::memory_order_relaxed),
+		totalOverflows.load(std::memory_order_relaxed),
+	};
+}
+
+void Connection::resetWriteStats() {
+	totalWrites.store(0, std::memory_order_relaxed);
+	totalWrittenMessages.store(0, std::memory_order_relaxed);
+	totalWrittenBytes.store(0, std::memory_order_relaxed);
+	totalOverflows.store(0, std::memory_order_relaxed);
 }
 
 void Connection::handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error) {
@@ -12,6 +12,7 @@
 #include "declarations.hpp"
 #include "lib/di/container.hpp"
 #include "server/network/message/networkmessage.hpp"
+#include "utils/ring_queue.hpp"
 
 static constexpr int32_t CONNECTION_WRITE_TIMEOUT = 30;
 static constexpr int32_t CONNECTION_READ_TIMEOUT = 30;
@@ -68,18 +69,35 @@ public:
 
 	uint32_t getIP();
 
+	// a client this far behind reads slower than it is sent to, the connection is closed
+	static constexpr size_t MAX_QUEUED_MESSAGES = 4096;
+	// messages gathered in a single vectored write
+	static constexpr size_t MAX_WRITE_BATCH = 64;
+
+	// totals of every connection, a write is one async_write of a whole batch
+	struct WriteStats {
+		uint64_t writes = 0;
+		uint64_t messages = 0;
+		uint64_t bytes = 0;
+		// connections closed for having MAX_QUEUED_MESSAGES waiting
+		uint64_t overflows = 0;
+	};
+
+	static WriteStats getWriteStats();
+	static void resetWriteStats();
+
 private:
 	void parseProxyIdentification(const std::error_code &error);
 	void parseHeader(const std::error_code &error);
 	void parsePacket(const std::error_code &error);
 
-	void onWriteOperation(const std::error_code &error);
+	void onWriteOperation(const std::error_code &error, size_t bytesTransferred);
 
 	static void handleTimeout(ConnectionWeak_ptr connectionWeak, const std::error_code &error);
 
 	void closeSocket();
 	void internalWorker();
-	void internalSend(const OutputMessage_ptr &outputMessage);
+	void internalSend();
 
 	asio::ip::tcp::socket &getSocket() {
 		return socket;
@@ -92,7 +110,14 @@ private:
 
 	std::recursive_mutex connectionLock;
 
-	std::list<OutputMessage_ptr> messageQueue;
+	// the messages waiting to be written
+	stdext::ring_queue<OutputMessage_ptr> messageQueue { MAX_QUEUED_MESSAGES };
+
+	// the batch being written and its buffer sequence
+	std::vector<OutputMessage_ptr> writeBatch;
+	std::vector<asio::const_buffer> writeBuffers;
+	// a batch is being encrypted or written, the next one starts from its completion
+	bool writing = false;
 
 	ConstServicePort_ptr service_port;
 	Protocol_ptr protocol;
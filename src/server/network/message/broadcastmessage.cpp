@@ -0,0 +1,48 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/message/broadcastmessage.hpp"
+
+namespace {
+	std::atomic_uint64_t serializedMessages = 0;
+	std::atomic_uint64_t sentMessages = 0;
+}
+
+const std::shared_ptr<const NetworkMessage> &BroadcastMessage::get(bool oldProtocol) {
+	const size_t index = oldProtocol ? 1 : 0;
+	if (!serialized[index]) {
+		serialized[index] = true;
+
+		auto msg = std::make_shared<NetworkMessage>();
+		serializer(*msg, oldProtocol);
+		if (msg->getLength() > 0) {
+			messages[index] = std::move(msg);
+			serializedMessages.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (messages[index]) {
+		sentMessages.fetch_add(1, std::memory_order_relaxed);
+	}
+	return messages[index];
+}
+
+BroadcastMessage::Stats BroadcastMessage::getStats() {
+	return {
+		serializedMessages.load(std::memory_order_relaxed),
+		sentMessages.load(std::memory_order_relaxed),
+	};
+}
+
+void BroadcastMessage::resetStats() {
+	serializedMessages.store(0, std::memory_order_relaxed);
+	sentMessages.store(0, std::memory_order_relaxed);
+}
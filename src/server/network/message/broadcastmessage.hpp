@@ -0,0 +1,47 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include "server/network/message/networkmessage.hpp"
+
+/**
+ * A packet that every spectator receives the same, as a magic effect or a creature speech.
+ * It is serialized at most once per client protocol version, when the first viewer with that
+ * version asks for it, and then only copied into each viewer output buffer.
+ * The serialized messages are immutable and shared, so they may outlive the broadcast.
+ * Packets that depend on the viewer (known creatures, stack positions) keep the per player path.
+ */
+class BroadcastMessage {
+public:
+	using Serializer = std::function<void(NetworkMessage &msg, bool oldProtocol)>;
+
+	explicit BroadcastMessage(Serializer serializer) :
+		serializer(std::move(serializer)) { }
+
+	// non-copyable
+	BroadcastMessage(const BroadcastMessage &) = delete;
+	BroadcastMessage &operator=(const BroadcastMessage &) = delete;
+
+	// nullptr when there is no such packet for that protocol version
+	const std::shared_ptr<const NetworkMessage> &get(bool oldProtocol);
+
+	struct Stats {
+		uint64_t serialized = 0;
+		uint64_t sent = 0;
+	};
+
+	static Stats getStats();
+	static void resetStats();
+
+private:
+	Serializer serializer;
+	std::array<std::shared_ptr<const NetworkMessage>, 2> messages;
+	std::array<bool, 2> serialized {};
+};
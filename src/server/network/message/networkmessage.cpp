@@ -12,6 +12,95 @@
 #include "server/network/message/networkmessage.hpp"
 #include "items/containers/container.hpp"
 
+namespace {
+	// full size buffers of the messages that outgrew their inline one, kept for reuse by each thread
+	constexpr size_t MAX_CACHED_BUFFERS = 8;
+
+	struct BufferCache {
+		~BufferCache() {
+			// messages with static storage are destroyed after the thread locals, they free their own buffer
+			destroyed = true;
+		}
+
+		std::vector<std::unique_ptr<uint8_t[]>> buffers;
+		static thread_local bool destroyed;
+	};
+
+	thread_local bool BufferCache::destroyed = false;
+	thread_local BufferCache bufferCache;
+}
+
+NetworkMessage::~NetworkMessage() {
+	releaseBuffer();
+}
+
+NetworkMessage::NetworkMessage(const NetworkMessage &other) :
+	info(other.info) {
+	reserveBuffer(other.bufferSize);
+	memcpy(buffer, other.buffer, other.bufferSize);
+}
+
+NetworkMessage &NetworkMessage::operator=(const NetworkMessage &other) {
+	if (this != &other) {
+		info = other.info;
+		reserveBuffer(other.bufferSize);
+		memcpy(buffer, other.buffer, other.bufferSize);
+	}
+	return *this;
+}
+
+NetworkMessage::NetworkMessage(NetworkMessage &&other) noexcept :
+	info(other.info) {
+	takeBuffer(other);
+}
+
+NetworkMessage &NetworkMessage::operator=(NetworkMessage &&other) noexcept {
+	if (this != &other) {
+		releaseBuffer();
+		info = other.info;
+		takeBuffer(other);
+	}
+	return *this;
+}
+
+void NetworkMessage::takeBuffer(NetworkMessage &other) noexcept {
+	if (other.buffer != other.inlineBuffer) {
+		buffer = std::exchange(other.buffer, other.inlineBuffer);
+		bufferSize = std::exchange(other.bufferSize, INLINE_BUFFER_SIZE);
+	} else {
+		// nothing past the header and the body was written
+		const size_t used = std::max<size_t>(other.info.position, INITIAL_BUFFER_POSITION + other.info.length);
+		memcpy(buffer, other.buffer, std::min(used, INLINE_BUFFER_SIZE));
+	}
+	other.info = {};
+}
+
+void NetworkMessage::growBuffer() {
+	std::unique_ptr<uint8_t[]> fullBuffer;
+	if (auto &cached = bufferCache.buffers; !BufferCache::destroyed && !cached.empty()) {
+		fullBuffer = std::move(cached.back());
+		cached.pop_back();
+	} else {
+		fullBuffer = std::make_unique_for_overwrite<uint8_t[]>(NETWORKMESSAGE_MAXSIZE);
+	}
+
+	memcpy(fullBuffer.get(), buffer, bufferSize);
+	buffer = fullBuffer.release();
+	bufferSize = NETWORKMESSAGE_MAXSIZE;
+}
+
+void NetworkMessage::releaseBuffer() {
+	if (buffer == inlineBuffer) {
+		return;
+	}
+
+	std::unique_ptr<uint8_t[]> fullBuffer(std::exchange(buffer, inlineBuffer));
+	bufferSize = INLINE_BUFFER_SIZE;
+	if (!BufferCache::destroyed && bufferCache.buffers.size() < MAX_CACHED_BUFFERS) {
+		bufferCache.buffers.emplace_back(std::move(fullBuffer));
+	}
+}
+
 int32_t NetworkMessage::decodeHeader() {
 	int32_t newSize = buffer[0] | buffer[1] << 8;
 	info.length = newSize;
@@ -85,11 +174,11 @@ void NetworkMessage::addBytes(const char* bytes, size_t size) {
 }
 
 void NetworkMessage::addPaddingBytes(size_t n) {
-#define canAdd(size) ((size + info.position) < NETWORKMESSAGE_MAXSIZE)
-	if (!canAdd(n)) {
+	if ((n + info.position) >= NETWORKMESSAGE_MAXSIZE) {
 		return;
 	}
-#undef canAdd
+
+	reserveBuffer(n + info.position);
 
 	memset(buffer + info.position, 0x33, n);
 	info.length += n;
@@ -26,8 +26,18 @@ public:
 	// 4 bytes for checksum
 	// 2 bytes for encrypted message size
 	static constexpr MsgSize_t INITIAL_BUFFER_POSITION = 8;
+	// Most outgoing packets are small, so a message starts with this inline buffer and only
+	// moves to a full NETWORKMESSAGE_MAXSIZE one (reused per thread) when it outgrows it
+	static constexpr size_t INLINE_BUFFER_SIZE = 256;
 
 	NetworkMessage() = default;
+	~NetworkMessage();
+
+	NetworkMessage(const NetworkMessage &other);
+	NetworkMessage &operator=(const NetworkMessage &other);
+	// Takes the full size buffer of other, or copies what was written to its inline one
+	NetworkMessage(NetworkMessage &&other) noexcept;
+	NetworkMessage &operator=(NetworkMessage &&other) noexcept;
 
 	void reset() {
 		info = {};
@@ -123,7 +133,9 @@ public:
 		return info.overrun;
 	}
 
+	// raw access may write anywhere in the message, so it always gets the full size buffer
 	uint8_t* getBuffer() {
+		reserveBuffer(NETWORKMESSAGE_MAXSIZE);
 		return buffer;
 	}
 
@@ -132,23 +144,36 @@ public:
 	}
 
 	uint8_t* getBodyBuffer() {
+		reserveBuffer(NETWORKMESSAGE_MAXSIZE);
 		info.position = 2;
 		return buffer + HEADER_LENGTH;
 	}
 
 protected:
-	bool canAdd(size_t size) const {
-		return (size + info.position) < MAX_BODY_LENGTH;
+	bool canAdd(size_t size) {
+		const auto end = size + info.position;
+		if (end >= MAX_BODY_LENGTH) {
+			return false;
+		}
+
+		reserveBuffer(end);
+		return true;
 	}
 
 	bool canRead(int32_t size) {
-		if ((info.position + size) > (info.length + 8) || size >= (NETWORKMESSAGE_MAXSIZE - info.position)) {
+		if ((info.position + size) > (info.length + 8) || size >= (NETWORKMESSAGE_MAXSIZE - info.position) || static_cast<size_t>(info.position + size) > bufferSize) {
 			info.overrun = true;
 			return false;
 		}
 		return true;
 	}
 
+	void reserveBuffer(size_t size) {
+		if (size > bufferSize) {
+			growBuffer();
+		}
+	}
+
 	struct NetworkMessageInfo {
 		MsgSize_t length = 0;
 		MsgSize_t position = INITIAL_BUFFER_POSITION;
@@ -156,5 +181,14 @@ protected:
 	};
 
 	NetworkMessageInfo info;
-	uint8_t buffer[NETWORKMESSAGE_MAXSIZE];
+	uint8_t* buffer = inlineBuffer;
+
+private:
+	void growBuffer();
+	void releaseBuffer();
+	// The buffer of this message must be the inline one
+	void takeBuffer(NetworkMessage &other) noexcept;
+
+	size_t bufferSize = INLINE_BUFFER_SIZE;
+	uint8_t inlineBuffer[INLINE_BUFFER_SIZE];
 };
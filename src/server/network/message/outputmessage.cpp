@@ -51,6 +51,120 @@ void OutputMessagePool::removeProtocolFromAutosend(const Protocol_ptr &protocol)
 	}
 }
 
+namespace {
+	// lock-free stack of idle messages, only ever popped whole, so it is free of ABA
+	std::atomic<OutputMessage*> freeList = nullptr;
+
+	std::atomic_uint64_t retained = 0;
+	std::atomic_uint64_t inUse = 0;
+	std::atomic_uint64_t highWater = 0;
+	std::atomic_uint64_t hits = 0;
+	std::atomic_uint64_t misses = 0;
+}
+
+struct OutputMessagePool::LocalCache {
+	~LocalCache() {
+		// messages released later on this thread, by thread locals destroyed after it, go to the free list
+		destroyed = true;
+		retained.fetch_sub(messages.size(), std::memory_order_relaxed);
+		for (const auto* msg : messages) {
+			delete msg;
+		}
+	}
+
+	std::vector<OutputMessage*> messages;
+	static thread_local bool destroyed;
+};
+
+thread_local bool OutputMessagePool::LocalCache::destroyed = false;
+
+OutputMessagePool::LocalCache* OutputMessagePool::getLocalCache() {
+	if (LocalCache::destroyed) {
+		return nullptr;
+	}
+
+	thread_local LocalCache cache;
+	return &cache;
+}
+
+void OutputMessagePool::pushFreeList(OutputMessage* first, OutputMessage* last) {
+	last->poolNext = freeList.load(std::memory_order_relaxed);
+	while (!freeList.compare_exchange_weak(last->poolNext, first, std::memory_order_release, std::memory_order_relaxed)) { }
+}
+
 OutputMessage_ptr OutputMessagePool::getOutputMessage() {
-	return std::make_shared<OutputMessage>();
+	OutputMessage* msg = nullptr;
+	if (auto* cache = getLocalCache()) {
+		auto &messages = cache->messages;
+		if (messages.empty()) {
+			// a batch only, so one thread does not drain the messages every other thread gave back
+			auto* chain = freeList.exchange(nullptr, std::memory_order_acquire);
+			while (chain && messages.size() < LOCAL_CACHE_REFILL) {
+				messages.emplace_back(std::exchange(chain, chain->poolNext));
+			}
+
+			if (chain) {
+				auto* last = chain;
+				while (last->poolNext) {
+					last = last->poolNext;
+				}
+				pushFreeList(chain, last);
+			}
+		}
+
+		if (!messages.empty()) {
+			msg = messages.back();
+			messages.pop_back();
+		}
+	}
+
+	if (msg) {
+		retained.fetch_sub(1, std::memory_order_relaxed);
+		hits.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		msg = new OutputMessage();
+		misses.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const auto used = inUse.fetch_add(1, std::memory_order_relaxed) + 1;
+	auto peak = highWater.load(std::memory_order_relaxed);
+	while (peak < used && !highWater.compare_exchange_weak(peak, used, std::memory_order_relaxed)) { }
+
+	return { msg, &OutputMessagePool::releaseOutputMessage };
+}
+
+void OutputMessagePool::releaseOutputMessage(OutputMessage* msg) {
+	inUse.fetch_sub(1, std::memory_order_relaxed);
+
+	if (retained.fetch_add(1, std::memory_order_relaxed) >= MAX_RETAINED_MESSAGES) {
+		retained.fetch_sub(1, std::memory_order_relaxed);
+		delete msg;
+		return;
+	}
+
+	msg->recycle();
+
+	auto* cache = getLocalCache();
+	if (cache && cache->messages.size() < LOCAL_CACHE_SIZE) {
+		cache->messages.emplace_back(msg);
+		return;
+	}
+
+	pushFreeList(msg, msg);
+}
+
+OutputMessagePool::Stats OutputMessagePool::getStats() {
+	return {
+		inUse.load(std::memory_order_relaxed),
+		highWater.load(std::memory_order_relaxed),
+		hits.load(std::memory_order_relaxed),
+		misses.load(std::memory_order_relaxed),
+		retained.load(std::memory_order_relaxed),
+	};
+}
+
+void OutputMessagePool::resetStats() {
+	highWater.store(inUse.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	hits.store(0, std::memory_order_relaxed);
+	misses.store(0, std::memory_order_relaxed);
 }
@@ -17,7 +17,10 @@ class Protocol;
 
 class OutputMessage : public NetworkMessage {
 public:
-	OutputMessage() = default;
+	// headers are prepended and messages appended in place, so it is full size from the start
+	OutputMessage() {
+		reserveBuffer(NETWORKMESSAGE_MAXSIZE);
+	}
 
 	// non-copyable
 	OutputMessage(const OutputMessage &) = delete;
@@ -54,6 +57,14 @@ public:
 	}
 
 private:
+	friend class OutputMessagePool;
+
+	// back to the state of a freshly built message, for the pool to hand it out again
+	void recycle() {
+		reset();
+		outputBufferStart = INITIAL_BUFFER_POSITION;
+	}
+
 	template <typename T>
 	void add_header(T addHeader) {
 		assert(outputBufferStart >= sizeof(T));
@@ -64,6 +75,8 @@ private:
 	}
 
 	MsgSize_t outputBufferStart = INITIAL_BUFFER_POSITION;
+	// link in the pool free list while the message is idle
+	OutputMessage* poolNext = nullptr;
 };
 
 class OutputMessagePool {
@@ -81,12 +94,43 @@ public:
 	void sendAll();
 	void scheduleSendAll();
 
+	/**
+	 * Messages are recycled instead of freed: a released message goes to the cache of the
+	 * releasing thread and, once that is full, to a shared lock-free free list that the caches refill from.
+	 * At most MAX_RETAINED_MESSAGES idle messages are kept, the rest are freed.
+	 */
 	static OutputMessage_ptr getOutputMessage();
 
+	// each message holds a NETWORKMESSAGE_MAXSIZE buffer, so this keeps up to ~64 MB idle
+	static constexpr size_t MAX_RETAINED_MESSAGES = 1024;
+	static constexpr size_t LOCAL_CACHE_SIZE = 32;
+	// taken from the free list by an empty cache, half of it so releases on that thread still fit
+	static constexpr size_t LOCAL_CACHE_REFILL = LOCAL_CACHE_SIZE / 2;
+
+	struct Stats {
+		uint64_t inUse = 0;
+		uint64_t highWater = 0;
+		// served from the pool / allocated because the pool was empty
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		// idle messages kept for reuse
+		uint64_t retained = 0;
+	};
+
+	static Stats getStats();
+	static void resetStats();
+
 	void addProtocolToAutosend(Protocol_ptr protocol);
 	void removeProtocolFromAutosend(const Protocol_ptr &protocol);
 
 private:
+	struct LocalCache;
+
+	// nullptr once the cache of the thread is destroyed
+	static LocalCache* getLocalCache();
+	static void releaseOutputMessage(OutputMessage* msg);
+	static void pushFreeList(OutputMessage* first, OutputMessage* last);
+
 	// NOTE: A vector is used here because this container is mostly read
 	// and relatively rarely modified (only when a client connects/disconnects)
 	std::vector<Protocol_ptr> bufferedProtocols;
@@ -0,0 +1,110 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/protocol/known_creatures.hpp"
+
+namespace {
+	// Summed over all the clients
+	std::atomic_uint64_t added = 0;
+	std::atomic_uint64_t evictions = 0;
+	std::atomic_uint64_t evictionChecks = 0;
+	std::atomic_uint64_t forcedEvictions = 0;
+}
+
+KnownCreatures::KnownCreatures(size_t capacity) :
+	maxSize(std::max<size_t>(capacity, 1)) { }
+
+uint32_t KnownCreatures::evict(const std::function<bool(uint32_t)> &canEvict) {
+	uint64_t checks = 0;
+	uint32_t index = back;
+	while (index != NONE) {
+		++checks;
+		if (canEvict(nodes[index].id)) {
+			break;
+		}
+		index = nodes[index].previous;
+	}
+
+	if (index == NONE) {
+		forcedEvictions.fetch_add(1, std::memory_order_relaxed);
+		index = back;
+	}
+
+	evictions.fetch_add(1, std::memory_order_relaxed);
+	evictionChecks.fetch_add(checks, std::memory_order_relaxed);
+
+	const uint32_t id = nodes[index].id;
+	unlink(index);
+	indexes.erase(id);
+	freeNode = index;
+	return id;
+}
+
+void KnownCreatures::insert(uint32_t id) {
+	uint32_t index = freeNode;
+	if (index != NONE) {
+		freeNode = NONE;
+	} else {
+		index = static_cast<uint32_t>(nodes.size());
+		nodes.emplace_back();
+	}
+
+	nodes[index].id = id;
+	linkFront(index);
+	indexes.emplace(id, index);
+	added.fetch_add(1, std::memory_order_relaxed);
+}
+
+void KnownCreatures::unlink(uint32_t index) {
+	auto &node = nodes[index];
+	if (node.previous != NONE) {
+		nodes[node.previous].next = node.next;
+	} else {
+		front = node.next;
+	}
+
+	if (node.next != NONE) {
+		nodes[node.next].previous = node.previous;
+	} else {
+		back = node.previous;
+	}
+
+	node.previous = NONE;
+	node.next = NONE;
+}
+
+void KnownCreatures::linkFront(uint32_t index) {
+	auto &node = nodes[index];
+	node.previous = NONE;
+	node.next = front;
+	if (front != NONE) {
+		nodes[front].previous = index;
+	} else {
+		back = index;
+	}
+	front = index;
+}
+
+KnownCreatures::Stats KnownCreatures::getStats() {
+	return {
+		added.load(std::memory_order_relaxed),
+		evictions.load(std::memory_order_relaxed),
+		evictionChecks.load(std::memory_order_relaxed),
+		forcedEvictions.load(std::memory_order_relaxed),
+	};
+}
+
+void KnownCreatures::resetStats() {
+	added.store(0, std::memory_order_relaxed);
+	evictions.store(0, std::memory_order_relaxed);
+	evictionChecks.store(0, std::memory_order_relaxed);
+	forcedEvictions.store(0, std::memory_order_relaxed);
+}
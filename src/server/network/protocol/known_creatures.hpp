@@ -0,0 +1,91 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+/**
+ * The creatures a client knows, so they can be sent by id instead of in full.
+ * The client keeps at most CLIENT_CAPACITY of them and drops the one the server names when
+ * a new one does not fit, so both sides stay in sync.
+ * Creatures are kept in least recently used order: adding or re-sending one moves it to the
+ * front, and the eviction walks from the back, where creatures that are still around are rare.
+ */
+class KnownCreatures {
+public:
+	static constexpr size_t CLIENT_CAPACITY = 1300;
+
+	explicit KnownCreatures(size_t capacity = CLIENT_CAPACITY);
+
+	bool contains(uint32_t id) const {
+		return indexes.contains(id);
+	}
+
+	size_t size() const {
+		return indexes.size();
+	}
+
+	/**
+	 * Marks the creature as the most recently used one, adding it when it was not known.
+	 * Returns whether it was already known. If it was not and the list was full, removedKnown is
+	 * the evicted one: the least recently used that canEvict accepts, or the least recently used
+	 * at all when none is; otherwise it is 0.
+	 */
+	template <typename CanEvict>
+	bool add(uint32_t id, uint32_t &removedKnown, CanEvict &&canEvict) {
+		removedKnown = 0;
+		if (const auto it = indexes.find(id); it != indexes.end()) {
+			unlink(it->second);
+			linkFront(it->second);
+			return true;
+		}
+
+		if (indexes.size() >= maxSize) {
+			removedKnown = evict(canEvict);
+		}
+
+		insert(id);
+		return false;
+	}
+
+	struct Stats {
+		uint64_t added = 0;
+		uint64_t evictions = 0;
+		// candidates checked to find who to evict, the cost of the evictions
+		uint64_t evictionChecks = 0;
+		// evictions of a creature canEvict refused, since no one else could be
+		uint64_t forcedEvictions = 0;
+	};
+
+	static Stats getStats();
+	static void resetStats();
+
+private:
+	static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+	struct Node {
+		uint32_t id = 0;
+		uint32_t previous = NONE;
+		uint32_t next = NONE;
+	};
+
+	uint32_t evict(const std::function<bool(uint32_t)> &canEvict);
+	void insert(uint32_t id);
+	void unlink(uint32_t index);
+	void linkFront(uint32_t index);
+
+	// node index by creature id
+	phmap::flat_hash_map<uint32_t, uint32_t> indexes;
+	std::vector<Node> nodes;
+	// most and least recently used
+	uint32_t front = NONE;
+	uint32_t back = NONE;
+	// a node freed by an eviction, there is at most one since one is added right after
+	uint32_t freeNode = NONE;
+	size_t maxSize;
+};
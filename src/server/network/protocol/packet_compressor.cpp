@@ -0,0 +1,158 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/protocol/packet_compressor.hpp"
+#include "config/configmanager.hpp"
+
+#if defined(CANARY_COMPRESSION_LIBDEFLATE)
+	#include <libdeflate.h>
+#elif defined(CANARY_COMPRESSION_ZLIB_NG)
+	#include <zlib-ng.h>
+#endif
+
+#if defined(CANARY_COMPRESSION_LIBDEFLATE)
+struct PacketCompressor::Backend {
+	~Backend() {
+		if (compressor) {
+			libdeflate_free_compressor(compressor);
+		}
+	}
+
+	bool init(int32_t level) {
+		// it goes up to 12, the zlib levels keep about the same meaning
+		compressor = libdeflate_alloc_compressor(level);
+		if (!compressor) {
+			g_logger().error("[PacketCompressor] - libdeflate_alloc_compressor error for level {}", level);
+			return false;
+		}
+		return true;
+	}
+
+	// all at once with no state to reset, 0 when the output does not fit
+	size_t compress(const uint8_t* data, size_t length, uint8_t* out, size_t capacity) {
+		return libdeflate_deflate_compress(compressor, data, length, out, capacity);
+	}
+
+	libdeflate_compressor* compressor = nullptr;
+};
+#else
+namespace {
+	#if defined(CANARY_COMPRESSION_ZLIB_NG)
+	using DeflateStream = zng_stream;
+
+	int32_t initDeflate(DeflateStream* stream, int32_t level) {
+		return zng_deflateInit2(stream, level, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY);
+	}
+
+	int32_t finishDeflate(DeflateStream* stream) {
+		return zng_deflate(stream, Z_FINISH);
+	}
+
+	void resetDeflate(DeflateStream* stream) {
+		zng_deflateReset(stream);
+	}
+
+	void endDeflate(DeflateStream* stream) {
+		zng_deflateEnd(stream);
+	}
+	#else
+	using DeflateStream = z_stream;
+
+	int32_t initDeflate(DeflateStream* stream, int32_t level) {
+		return deflateInit2(stream, level, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY);
+	}
+
+	int32_t finishDeflate(DeflateStream* stream) {
+		return deflate(stream, Z_FINISH);
+	}
+
+	void resetDeflate(DeflateStream* stream) {
+		deflateReset(stream);
+	}
+
+	void endDeflate(DeflateStream* stream) {
+		deflateEnd(stream);
+	}
+	#endif
+}
+
+struct PacketCompressor::Backend {
+	~Backend() {
+		if (initialized) {
+			endDeflate(&stream);
+		}
+	}
+
+	bool init(int32_t level) {
+		initialized = initDeflate(&stream, level) == Z_OK;
+		if (!initialized) {
+			g_logger().error("[PacketCompressor] - deflateInit2 error: {}", (stream.msg ? stream.msg : " unknown error"));
+		}
+		return initialized;
+	}
+
+	// 0 when the output does not fit, deflate then stops short of the end of the stream
+	size_t compress(const uint8_t* data, size_t length, uint8_t* out, size_t capacity) {
+		stream.next_in = const_cast<uint8_t*>(data);
+		stream.avail_in = static_cast<uint32_t>(length);
+		stream.next_out = out;
+		stream.avail_out = static_cast<uint32_t>(capacity);
+
+		const int32_t ret = finishDeflate(&stream);
+		const size_t size = ret == Z_STREAM_END ? static_cast<size_t>(stream.total_out) : 0;
+		resetDeflate(&stream);
+		return size;
+	}
+
+	DeflateStream stream {};
+	bool initialized = false;
+};
+#endif
+
+PacketCompressor::PacketCompressor(int32_t level) :
+	level(level) {
+	if (level <= 0) {
+		return;
+	}
+
+	backend = std::make_unique<Backend>();
+	if (!backend->init(level)) {
+		backend.reset();
+	}
+}
+
+PacketCompressor::~PacketCompressor() = default;
+
+PacketCompressor &PacketCompressor::getThreadInstance() {
+	static thread_local PacketCompressor compressor(g_configManager().getNumber(COMPRESSION_LEVEL));
+	return compressor;
+}
+
+std::string_view PacketCompressor::getBackendName() {
+#if defined(CANARY_COMPRESSION_LIBDEFLATE)
+	return "libdeflate";
+#elif defined(CANARY_COMPRESSION_ZLIB_NG)
+	return "zlib-ng";
+#else
+	return "zlib";
+#endif
+}
+
+std::span<const uint8_t> PacketCompressor::compress(const uint8_t* data, size_t length) {
+	if (!backend || length <= 1) {
+		return {};
+	}
+
+	// one byte short of the input, so packets that do not compress give up as soon as they stop fitting
+	const auto capacity = std::min(length - 1, buffer.size());
+	const auto size = backend->compress(data, length, buffer.data(), capacity);
+	return { buffer.data(), size };
+}
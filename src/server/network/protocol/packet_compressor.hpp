@@ -0,0 +1,55 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include <span>
+
+/**
+ * Raw deflate (no zlib header or trailer) of outgoing packets.
+ * The library doing the work is chosen at build time with PACKET_COMPRESSION_BACKEND:
+ * zlib (default), zlib-ng (native api) or libdeflate, they all produce a stream the client inflates.
+ */
+class PacketCompressor {
+public:
+	// level <= 0 disables it
+	explicit PacketCompressor(int32_t level);
+	~PacketCompressor();
+
+	// non-copyable
+	PacketCompressor(const PacketCompressor &) = delete;
+	PacketCompressor &operator=(const PacketCompressor &) = delete;
+
+	// The one of the calling thread, with the configured level
+	static PacketCompressor &getThreadInstance();
+
+	static std::string_view getBackendName();
+
+	bool isEnabled() const {
+		return backend != nullptr;
+	}
+
+	int32_t getLevel() const {
+		return level;
+	}
+
+	/**
+	 * Compresses data into an internal buffer, valid until the next call.
+	 * Returns an empty span when it fails or the result would not be smaller than the input,
+	 * the packet is then better sent as it is.
+	 */
+	std::span<const uint8_t> compress(const uint8_t* data, size_t length);
+
+private:
+	struct Backend;
+
+	std::unique_ptr<Backend> backend;
+	std::array<uint8_t, NETWORKMESSAGE_MAXSIZE> buffer {};
+	int32_t level = 0;
+};
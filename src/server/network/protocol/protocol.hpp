@@ -11,6 +11,7 @@
 
 #include "server/network/connection/connection.hpp"
 #include "config/configmanager.hpp"
+#include "security/xtea.hpp"
 
 class Protocol : public std::enable_shared_from_this<Protocol> {
 public:
@@ -66,7 +67,10 @@ protected:
 		encryptionEnabled = true;
 	}
 	void setXTEAKey(const uint32_t* newKey) {
-		memcpy(this->key.data(), newKey, sizeof(*newKey) * 4);
+		xtea::Key key;
+		memcpy(key.data(), newKey, sizeof(*newKey) * 4);
+		encryptKeys = xtea::expandEncryptKey(key);
+		decryptKeys = xtea::expandDecryptKey(key);
 	}
 	void setChecksumMethod(ChecksumMethods_t method) {
 		checksumMethod = method;
@@ -81,32 +85,6 @@ protected:
 	virtual void release() { }
 
 private:
-	struct ZStream {
-		ZStream() noexcept {
-			const int32_t compressionLevel = g_configManager().getNumber(COMPRESSION_LEVEL);
-			if (compressionLevel <= 0) {
-				return;
-			}
-
-			stream = std::make_unique<z_stream>();
-			stream->zalloc = nullptr;
-			stream->zfree = nullptr;
-			stream->opaque = nullptr;
-
-			if (deflateInit2(stream.get(), compressionLevel, Z_DEFLATED, -15, 9, Z_DEFAULT_STRATEGY) != Z_OK) {
-				stream.reset();
-				g_logger().error("[Protocol::enableCompression()] - Zlib deflateInit2 error: {}", (stream->msg ? stream->msg : " unknown error"));
-			}
-		}
-
-		~ZStream() {
-			deflateEnd(stream.get());
-		}
-
-		std::unique_ptr<z_stream> stream;
-		std::array<char, NETWORKMESSAGE_MAXSIZE> buffer {};
-	};
-
 	void XTEA_encrypt(OutputMessage &msg) const;
 	bool XTEA_decrypt(NetworkMessage &msg) const;
 	bool compression(OutputMessage &msg) const;
@@ -114,7 +92,8 @@ private:
 	OutputMessage_ptr outputBuffer;
 
 	const ConnectionWeak_ptr connectionPtr;
-	std::array<uint32_t, 4> key = {};
+	xtea::RoundKeys encryptKeys = {};
+	xtea::RoundKeys decryptKeys = {};
 	uint32_t serverSequenceNumber = 0;
 	uint32_t clientSequenceNumber = 0;
 	std::underlying_type_t<ChecksumMethods_t> checksumMethod = CHECKSUM_METHOD_NONE;
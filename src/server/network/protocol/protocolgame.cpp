@@ -23,10 +23,12 @@
 #include "creatures/monsters/monster.hpp"
 #include "creatures/monsters/monsters.hpp"
 #include "server/network/message/outputmessage.hpp"
+#include "server/network/message/broadcastmessage.hpp"
 #include "creatures/players/player.hpp"
 #include "creatures/players/wheel/player_wheel.hpp"
 #include "creatures/players/grouping/familiars.hpp"
 #include "server/network/protocol/protocolgame.hpp"
+#include "server/network/protocol/tile_description_cache.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "creatures/combat/spells.hpp"
 #include "creatures/players/management/waitlist.hpp"
@@ -1329,25 +1331,39 @@ void ProtocolGame::GetTileDescription(std::shared_ptr<Tile> tile, NetworkMessage
 		msg.add<uint16_t>(0x00); // Env effects
 	}
 
+	const bool isPlayerTile = tile->getPosition() == player->getPosition();
+	const TileItemVector* items = tile->getItemList();
+	// the items are the same for every viewer, only the creatures have to be written for this one
+	const auto* description = g_tileDescriptionCache().get(tile, oldProtocol, [this](NetworkMessage &itemMsg, const std::shared_ptr<Item> &item) {
+		AddItem(itemMsg, item);
+	});
+
 	int32_t count;
-	std::shared_ptr<Item> ground = tile->getGround();
-	if (ground) {
-		AddItem(msg, ground);
-		count = 1;
+	if (description) {
+		// the player always fits in its own tile
+		count = static_cast<int32_t>(description->addTopItems(msg, isPlayerTile ? 9 : 10));
+		if (count == 10) {
+			return;
+		}
 	} else {
-		count = 0;
-	}
+		std::shared_ptr<Item> ground = tile->getGround();
+		if (ground) {
+			AddItem(msg, ground);
+			count = 1;
+		} else {
+			count = 0;
+		}
 
-	const TileItemVector* items = tile->getItemList();
-	if (items) {
-		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
-			AddItem(msg, *it);
+		if (items) {
+			for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end; ++it) {
+				AddItem(msg, *it);
 
-			count++;
-			if (count == 9 && tile->getPosition() == player->getPosition()) {
-				break;
-			} else if (count == 10) {
-				return;
+				count++;
+				if (count == 9 && isPlayerTile) {
+					break;
+				} else if (count == 10) {
+					return;
+				}
 			}
 		}
 	}
@@ -1361,7 +1377,7 @@ void ProtocolGame::GetTileDescription(std::shared_ptr<Tile> tile, NetworkMessage
 				continue;
 			}
 
-			if (tile->getPosition() == player->getPosition() && count == 9 && !playerAdded) {
+			if (isPlayerTile && count == 9 && !playerAdded) {
 				creature = player;
 			}
 
@@ -1380,7 +1396,9 @@ void ProtocolGame::GetTileDescription(std::shared_ptr<Tile> tile, NetworkMessage
 		}
 	}
 
-	if (items) {
+	if (description) {
+		description->addDownItems(msg, 10 - count);
+	} else if (items) {
 		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end; ++it) {
 			AddItem(msg, *it);
 
@@ -1439,45 +1457,15 @@ void ProtocolGame::GetFloorDescription(NetworkMessage &msg, int32_t x, int32_t y
 }
 
 void ProtocolGame::checkCreatureAsKnown(uint32_t id, bool &known, uint32_t &removedKnown) {
-	if (auto [creatureKnown, creatureInserted] = knownCreatureSet.insert(id);
-		!creatureInserted) {
-		known = true;
-		return;
-	}
-	known = false;
-	if (knownCreatureSet.size() > 1300) {
-		// Look for a creature to remove
-		for (auto it = knownCreatureSet.begin(), end = knownCreatureSet.end(); it != end; ++it) {
-			if (*it == id) {
-				continue;
-			}
-			// We need to protect party players from removing
-			std::shared_ptr<Creature> creature = g_game().getCreatureByID(*it);
-			if (std::shared_ptr<Player> checkPlayer;
-				creature && (checkPlayer = creature->getPlayer()) != nullptr) {
-				if (player->getParty() != checkPlayer->getParty() && !canSee(creature)) {
-					removedKnown = *it;
-					knownCreatureSet.erase(it);
-					return;
-				}
-			} else if (!canSee(creature)) {
-				removedKnown = *it;
-				knownCreatureSet.erase(it);
-				return;
-			}
+	known = knownCreatures.add(id, removedKnown, [this](uint32_t knownId) {
+		std::shared_ptr<Creature> creature = g_game().getCreatureByID(knownId);
+		// We need to protect party players from removing
+		if (std::shared_ptr<Player> checkPlayer;
+			creature && (checkPlayer = creature->getPlayer()) != nullptr) {
+			return player->getParty() != checkPlayer->getParty() && !canSee(creature);
 		}
-
-		// Bad situation. Let's just remove anyone.
-		auto it = knownCreatureSet.begin();
-		if (*it == id) {
-			++it;
-		}
-
-		removedKnown = *it;
-		knownCreatureSet.erase(it);
-	} else {
-		removedKnown = 0;
-	}
+		return !canSee(creature);
+	});
 }
 
 bool ProtocolGame::canSee(std::shared_ptr<Creature> c) const {
@@ -5537,6 +5525,11 @@ void ProtocolGame::sendCreatureTurn(std::shared_ptr<Creature> creature, uint32_t
 
 void ProtocolGame::sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos /* = nullptr*/) {
 	NetworkMessage msg;
+	AddCreatureSay(msg, creature, type, text, pos, oldProtocol);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::AddCreatureSay(NetworkMessage &msg, const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos, bool oldProtocol) {
 	msg.addByte(0xAA);
 
 	static uint32_t statementId = 0;
@@ -5568,7 +5561,6 @@ void ProtocolGame::sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClas
 	}
 
 	msg.addString(text);
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendToChannel(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, uint16_t channelId) {
@@ -5691,6 +5683,15 @@ void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, u
 		return;
 	}
 	NetworkMessage msg;
+	AddDistanceShoot(msg, from, to, type, oldProtocol);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::AddDistanceShoot(NetworkMessage &msg, const Position &from, const Position &to, uint16_t type, bool oldProtocol) {
+	if (oldProtocol && type > 0xFF) {
+		return;
+	}
+
 	if (oldProtocol) {
 		msg.addByte(0x85);
 		msg.addPosition(from);
@@ -5705,7 +5706,6 @@ void ProtocolGame::sendDistanceShoot(const Position &from, const Position &to, u
 		msg.addByte(static_cast<uint8_t>(static_cast<int8_t>(static_cast<int32_t>(to.y) - static_cast<int32_t>(from.y))));
 		msg.addByte(MAGIC_EFFECTS_END_LOOP);
 	}
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendRestingStatus(uint8_t protection) {
@@ -5753,6 +5753,15 @@ void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
 	}
 
 	NetworkMessage msg;
+	AddMagicEffect(msg, pos, type, oldProtocol);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::AddMagicEffect(NetworkMessage &msg, const Position &pos, uint16_t type, bool oldProtocol) {
+	if (oldProtocol && type > 0xFF) {
+		return;
+	}
+
 	if (oldProtocol) {
 		msg.addByte(0x83);
 		msg.addPosition(pos);
@@ -5764,7 +5773,6 @@ void ProtocolGame::sendMagicEffect(const Position &pos, uint16_t type) {
 		msg.add<uint16_t>(type);
 		msg.addByte(MAGIC_EFFECTS_END_LOOP);
 	}
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
@@ -5772,6 +5780,15 @@ void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
 		return;
 	}
 	NetworkMessage msg;
+	RemoveMagicEffect(msg, pos, type, oldProtocol);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::RemoveMagicEffect(NetworkMessage &msg, const Position &pos, uint16_t type, bool oldProtocol) {
+	if (oldProtocol && type > 0xFF) {
+		return;
+	}
+
 	msg.addByte(0x84);
 	msg.addPosition(pos);
 	if (oldProtocol) {
@@ -5779,7 +5796,6 @@ void ProtocolGame::removeMagicEffect(const Position &pos, uint16_t type) {
 	} else {
 		msg.add<uint16_t>(type);
 	}
-	writeToOutputBuffer(msg);
 }
 
 void ProtocolGame::sendCreatureHealth(std::shared_ptr<Creature> creature) {
@@ -5788,15 +5804,24 @@ void ProtocolGame::sendCreatureHealth(std::shared_ptr<Creature> creature) {
 	}
 
 	NetworkMessage msg;
-	msg.addByte(0x8C);
-	msg.add<uint32_t>(creature->getID());
+	AddCreatureHealth(msg, creature);
+	writeToOutputBuffer(msg);
+}
+
+void ProtocolGame::AddCreatureHealth(NetworkMessage &msg, const std::shared_ptr<Creature> &creature) {
 	if (creature->isHealthHidden()) {
-		msg.addByte(0x00);
-	} else {
-		msg.addByte(static_cast<uint8_t>(std::min<double>(100, std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100))));
+		return;
 	}
 
-	writeToOutputBuffer(msg);
+	msg.addByte(0x8C);
+	msg.add<uint32_t>(creature->getID());
+	msg.addByte(static_cast<uint8_t>(std::min<double>(100, std::ceil((static_cast<double>(creature->getHealth()) / std::max<int32_t>(creature->getMaxHealth(), 1)) * 100))));
+}
+
+void ProtocolGame::sendBroadcast(BroadcastMessage &message) {
+	if (const auto &msg = message.get(oldProtocol)) {
+		writeToOutputBuffer(*msg);
+	}
 }
 
 void ProtocolGame::sendPartyCreatureUpdate(std::shared_ptr<Creature> target) {
@@ -5819,7 +5844,7 @@ void ProtocolGame::sendPartyCreatureUpdate(std::shared_ptr<Creature> target) {
 
 void ProtocolGame::sendPartyCreatureShield(std::shared_ptr<Creature> target) {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -5837,7 +5862,7 @@ void ProtocolGame::sendPartyCreatureSkull(std::shared_ptr<Creature> target) {
 	}
 
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -5851,7 +5876,7 @@ void ProtocolGame::sendPartyCreatureSkull(std::shared_ptr<Creature> target) {
 
 void ProtocolGame::sendPartyCreatureHealth(std::shared_ptr<Creature> target, uint8_t healthPercent) {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -5865,7 +5890,7 @@ void ProtocolGame::sendPartyCreatureHealth(std::shared_ptr<Creature> target, uin
 
 void ProtocolGame::sendPartyPlayerMana(std::shared_ptr<Player> target, uint8_t manaPercent) {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 	}
 
@@ -5883,7 +5908,7 @@ void ProtocolGame::sendPartyPlayerMana(std::shared_ptr<Player> target, uint8_t m
 
 void ProtocolGame::sendPartyCreatureShowStatus(std::shared_ptr<Creature> target, bool showStatus) {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 	}
 
@@ -5901,7 +5926,7 @@ void ProtocolGame::sendPartyCreatureShowStatus(std::shared_ptr<Creature> target,
 
 void ProtocolGame::sendPartyPlayerVocation(std::shared_ptr<Player> target) {
 	uint32_t cid = target->getID();
-	if (knownCreatureSet.find(cid) == knownCreatureSet.end()) {
+	if (!knownCreatures.contains(cid)) {
 		sendPartyCreatureUpdate(target);
 		return;
 	}
@@ -7808,8 +7833,7 @@ void ProtocolGame::reloadCreature(std::shared_ptr<Creature> creature) {
 
 	NetworkMessage msg;
 
-	phmap::flat_hash_set<uint32_t>::iterator it = std::find(knownCreatureSet.begin(), knownCreatureSet.end(), creature->getID());
-	if (it != knownCreatureSet.end()) {
+	if (knownCreatures.contains(creature->getID())) {
 		msg.addByte(0x6B);
 		msg.addPosition(creature->getPosition());
 		msg.addByte(stackpos);
@@ -10,10 +10,12 @@
 #pragma once
 
 #include "server/network/protocol/protocol.hpp"
+#include "server/network/protocol/known_creatures.hpp"
 #include "creatures/interactions/chat.hpp"
 #include "creatures/creature.hpp"
 
 class NetworkMessage;
+class BroadcastMessage;
 class Player;
 class Game;
 class House;
@@ -67,6 +69,14 @@ public:
 		return version;
 	}
 
+	// Packets that are the same for every viewer of a protocol version, written once for all
+	// of them through a BroadcastMessage, they leave msg empty when the version has no such packet
+	static void AddMagicEffect(NetworkMessage &msg, const Position &pos, uint16_t type, bool oldProtocol);
+	static void RemoveMagicEffect(NetworkMessage &msg, const Position &pos, uint16_t type, bool oldProtocol);
+	static void AddDistanceShoot(NetworkMessage &msg, const Position &from, const Position &to, uint16_t type, bool oldProtocol);
+	static void AddCreatureHealth(NetworkMessage &msg, const std::shared_ptr<Creature> &creature);
+	static void AddCreatureSay(NetworkMessage &msg, const std::shared_ptr<Creature> &creature, SpeakClasses type, const std::string &text, const Position* pos, bool oldProtocol);
+
 private:
 	// Helpers so we don't need to bind every time
 	template <typename Callable, typename... Args>
@@ -290,6 +300,7 @@ private:
 	void sendPingBack();
 	void sendCreatureTurn(std::shared_ptr<Creature> creature, uint32_t stackpos);
 	void sendCreatureSay(std::shared_ptr<Creature> creature, SpeakClasses type, const std::string &text, const Position* pos = nullptr);
+	void sendBroadcast(BroadcastMessage &message);
 
 	// Unjust Panel
 	void sendUnjustifiedPoints(const uint8_t &dayProgress, const uint8_t &dayLeft, const uint8_t &weekProgress, const uint8_t &weekLeft, const uint8_t &monthProgress, const uint8_t &monthLeft, const uint8_t &skullDuration);
@@ -471,7 +482,7 @@ private:
 	friend class Player;
 	friend class PlayerWheel;
 
-	phmap::flat_hash_set<uint32_t> knownCreatureSet;
+	KnownCreatures knownCreatures;
 	std::shared_ptr<Player> player = nullptr;
 
 	uint32_t eventConnect = 0;
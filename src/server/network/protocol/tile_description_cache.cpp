@@ -0,0 +1,131 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#include "pch.hpp"
+
+#include "server/network/protocol/tile_description_cache.hpp"
+#include "server/network/message/networkmessage.hpp"
+#include "items/tile.hpp"
+#include "lib/di/container.hpp"
+
+size_t TileDescriptionCache::Description::addTopItems(NetworkMessage &msg, size_t limit) const {
+	const size_t count = std::min<size_t>(topItems, limit);
+	addEntries(msg, 0, count);
+	return count;
+}
+
+void TileDescriptionCache::Description::addDownItems(NetworkMessage &msg, size_t limit) const {
+	addEntries(msg, topItems, std::min<size_t>(entries - topItems, limit));
+}
+
+void TileDescriptionCache::Description::addEntries(NetworkMessage &msg, size_t first, size_t count) const {
+	if (count == 0) {
+		return;
+	}
+
+	const size_t begin = first == 0 ? 0 : entryEnds[first - 1];
+	const size_t end = entryEnds[first + count - 1];
+	msg.addBytes(reinterpret_cast<const char*>(bytes.data() + begin), end - begin);
+}
+
+TileDescriptionCache &TileDescriptionCache::getInstance() {
+	return inject<TileDescriptionCache>();
+}
+
+bool TileDescriptionCache::isCacheable(const std::shared_ptr<Item> &item) {
+	const ItemType &it = Item::items[item->getID()];
+	return !it.expire && !it.expireStop && !it.clockExpire && !it.wearOut && !it.isPodium && !it.isWrapKit && item->getClassification() == 0;
+}
+
+const TileDescriptionCache::Description* TileDescriptionCache::get(const std::shared_ptr<Tile> &tile, bool oldProtocol, const ItemSerializer &addItem) {
+	auto &versionDescriptions = descriptions[oldProtocol ? 1 : 0];
+	auto it = versionDescriptions.find(tile.get());
+	if (it == versionDescriptions.end()) {
+		if (versionDescriptions.size() >= MAX_DESCRIPTIONS) {
+			versionDescriptions.clear();
+		}
+		it = versionDescriptions.try_emplace(tile.get()).first;
+		build(it->second, tile, addItem);
+	} else if (it->second.version != tile->getItemsVersion()) {
+		build(it->second, tile, addItem);
+	} else if (it->second.cacheable) {
+		++hits;
+	}
+
+	const auto &description = it->second;
+	if (!description.cacheable) {
+		++uncacheable;
+		return nullptr;
+	}
+	return &description;
+}
+
+void TileDescriptionCache::build(Description &description, const std::shared_ptr<Tile> &tile, const ItemSerializer &addItem) {
+	++builds;
+	description.version = tile->getItemsVersion();
+	description.bytes.clear();
+	description.entries = 0;
+	description.topItems = 0;
+	description.cacheable = false;
+
+	// what the client can see of the tile, in stack order
+	std::vector<std::shared_ptr<Item>> topItems;
+	std::vector<std::shared_ptr<Item>> downItems;
+	if (const auto &ground = tile->getGround()) {
+		topItems.emplace_back(ground);
+	}
+	if (const TileItemVector* items = tile->getItemList()) {
+		for (auto it = items->getBeginTopItem(), end = items->getEndTopItem(); it != end && topItems.size() < MAX_TILE_ENTRIES; ++it) {
+			topItems.emplace_back(*it);
+		}
+		for (auto it = items->getBeginDownItem(), end = items->getEndDownItem(); it != end && downItems.size() < MAX_TILE_ENTRIES; ++it) {
+			downItems.emplace_back(*it);
+		}
+	}
+
+	if (!std::ranges::all_of(topItems, isCacheable) || !std::ranges::all_of(downItems, isCacheable)) {
+		return;
+	}
+
+	NetworkMessage msg;
+	const auto &serialized = static_cast<const NetworkMessage &>(msg);
+	const auto addEntry = [&](const std::shared_ptr<Item> &item) {
+		addItem(msg, item);
+		description.entryEnds[description.entries++] = static_cast<uint16_t>(msg.getLength());
+	};
+
+	std::ranges::for_each(topItems, addEntry);
+	description.topItems = description.entries;
+	std::ranges::for_each(downItems, addEntry);
+
+	const auto* begin = serialized.getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+	description.bytes.assign(begin, begin + msg.getLength());
+	description.cacheable = true;
+}
+
+void TileDescriptionCache::clear() {
+	for (auto &versionDescriptions : descriptions) {
+		versionDescriptions.clear();
+	}
+}
+
+TileDescriptionCache::Stats TileDescriptionCache::getStats() const {
+	return {
+		hits,
+		builds,
+		uncacheable,
+		descriptions[0].size() + descriptions[1].size(),
+	};
+}
+
+void TileDescriptionCache::resetStats() {
+	hits = 0;
+	builds = 0;
+	uncacheable = 0;
+}
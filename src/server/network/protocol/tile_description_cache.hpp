@@ -0,0 +1,103 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+class Item;
+class NetworkMessage;
+class Tile;
+
+/**
+ * Serialized items of map tiles, as written by ProtocolGame::GetTileDescription, shared by every
+ * viewer with the same client protocol version.
+ * An entry stays valid while the items version of its tile does not change, creatures are not
+ * part of it and are always written per viewer. Items changed without going through the tile
+ * (Item::setSubType, attributes set by scripts) change that version too.
+ * Tiles holding items whose bytes change on their own (timers, charges) or come from custom
+ * attributes (podiums, wrap kits, tiers) are not cached and keep the per viewer path.
+ * Dispatcher only.
+ */
+class TileDescriptionCache {
+public:
+	using ItemSerializer = std::function<void(NetworkMessage &msg, const std::shared_ptr<Item> &item)>;
+
+	// the client never reads more than this many things of a tile
+	static constexpr size_t MAX_TILE_ENTRIES = 10;
+	// per protocol version, the whole cache is dropped when it gets this big
+	static constexpr size_t MAX_DESCRIPTIONS = 1 << 18;
+
+	class Description {
+	public:
+		// Ground and top items, at most limit of them, returns how many were written
+		size_t addTopItems(NetworkMessage &msg, size_t limit) const;
+		// Down items, at most limit of them
+		void addDownItems(NetworkMessage &msg, size_t limit) const;
+
+		size_t getTopItemCount() const {
+			return topItems;
+		}
+		size_t getDownItemCount() const {
+			return entries - topItems;
+		}
+
+	private:
+		friend class TileDescriptionCache;
+
+		void addEntries(NetworkMessage &msg, size_t first, size_t count) const;
+
+		std::vector<uint8_t> bytes;
+		// where each entry ends in bytes, ground and top items first
+		std::array<uint16_t, MAX_TILE_ENTRIES * 2> entryEnds {};
+		uint32_t version = 0;
+		uint8_t entries = 0;
+		uint8_t topItems = 0;
+		bool cacheable = false;
+	};
+
+	TileDescriptionCache() = default;
+
+	// non-copyable
+	TileDescriptionCache(const TileDescriptionCache &) = delete;
+	TileDescriptionCache &operator=(const TileDescriptionCache &) = delete;
+
+	static TileDescriptionCache &getInstance();
+
+	/**
+	 * The description of the tile items for that protocol version, serializing them with
+	 * addItem when the tile changed since the last time.
+	 * nullptr when the tile cannot be cached, valid until the next call.
+	 */
+	const Description* get(const std::shared_ptr<Tile> &tile, bool oldProtocol, const ItemSerializer &addItem);
+
+	void clear();
+
+	struct Stats {
+		uint64_t hits = 0;
+		uint64_t builds = 0;
+		uint64_t uncacheable = 0;
+		size_t descriptions = 0;
+	};
+
+	Stats getStats() const;
+	void resetStats();
+
+private:
+	static bool isCacheable(const std::shared_ptr<Item> &item);
+
+	void build(Description &description, const std::shared_ptr<Tile> &tile, const ItemSerializer &addItem);
+
+	// by tile, one map per protocol version, tiles are never dereferenced from here
+	std::array<phmap::flat_hash_map<const Tile*, Description>, 2> descriptions;
+
+	uint64_t hits = 0;
+	uint64_t builds = 0;
+	uint64_t uncacheable = 0;
+};
+
+constexpr auto g_tileDescriptionCache = TileDescriptionCache::getInstance;
@@ -12,6 +12,7 @@
 #include "game/game.hpp"
 #include "game/scheduling/dispatcher.hpp"
 #include "game/scheduling/save_manager.hpp"
+#include "game/scheduling/task_metrics.hpp"
 #include "lib/thread/thread_pool.hpp"
 #include "lua/creature/events.hpp"
 #include "lua/scripts/lua_environment.hpp"
@@ -23,6 +24,7 @@ Signals::Signals(asio::io_service &service) :
 	set.add(SIGTERM);
 #ifndef _WIN32
 	set.add(SIGUSR1);
+	set.add(SIGUSR2);
 	set.add(SIGHUP);
 #else
 	// This must be a blocking call as Windows calls it in a new thread and terminates
@@ -65,6 +67,9 @@ void Signals::dispatchSignalHandler(int signal) {
 		case SIGUSR1: // Saves game state
 			g_dispatcher().addEvent(sigusr1Handler, "sigusr1Handler");
 			break;
+		case SIGUSR2: // Dumps and resets the dispatcher task metrics
+			g_dispatcher().addEvent(sigusr2Handler, "sigusr2Handler");
+			break;
 #else
 		case SIGBREAK: // Shuts the server down
 			g_dispatcher().addEvent(sigbreakHandler, "sigbreakHandler");
@@ -95,6 +100,13 @@ void Signals::sigusr1Handler() {
 	g_saveManager().scheduleAll();
 }
 
+void Signals::sigusr2Handler() {
+	// Dispatcher thread
+	g_logger().info("SIGUSR2 received, dumping the dispatcher task metrics...");
+	g_taskMetrics().dump();
+	g_taskMetrics().reset();
+}
+
 void Signals::sighupHandler() {
 	// Dispatcher thread
 	g_logger().info("SIGHUP received, reloading config files...");
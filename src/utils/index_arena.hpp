@@ -0,0 +1,99 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+// IndexArena is append only storage addressed by 32-bit indexes instead of pointers.
+// It grows by fixed size blocks, so it never moves or copies what it holds and costs no
+// allocation per element, and the elements allocated together stay contiguous.
+namespace stdext {
+	template <typename T, size_t BlockSize = 1 << 16>
+	class index_arena {
+	public:
+		index_arena() = default;
+
+		// Ensures that we don't accidentally copy it
+		index_arena(const index_arena &) = delete;
+		index_arena &operator=(const index_arena &) = delete;
+
+		// Index of the first of count new contiguous elements, count 0 allocates nothing
+		uint32_t allocate(size_t count = 1) {
+			if (count == 0) {
+				return 0;
+			}
+			if (count > BlockSize) {
+				throw std::length_error("index_arena allocation larger than a block");
+			}
+
+			// the rest of the block is left unused when the run does not fit in it
+			if (blocks.empty() || used + count > BlockSize) {
+				blocks.emplace_back(std::make_unique<T[]>(BlockSize));
+				used = 0;
+			}
+
+			const auto index = static_cast<uint32_t>((blocks.size() - 1) * BlockSize + used);
+			used += count;
+			elements += count;
+			return index;
+		}
+
+		uint32_t push_back(const T &value) {
+			const uint32_t index = allocate();
+			(*this)[index] = value;
+			return index;
+		}
+
+		T &operator[](uint32_t index) {
+			return blocks[index / BlockSize][index % BlockSize];
+		}
+
+		const T &operator[](uint32_t index) const {
+			return blocks[index / BlockSize][index % BlockSize];
+		}
+
+		// The count elements allocated together from first
+		std::span<const T> span(uint32_t first, size_t count) const {
+			if (count == 0) {
+				return {};
+			}
+			return { &(*this)[first], count };
+		}
+
+		// Elements allocated, not counting the unused block ends
+		size_t size() const {
+			return elements;
+		}
+
+		bool empty() const {
+			return elements == 0;
+		}
+
+		size_t memoryUsage() const {
+			return blocks.size() * BlockSize * sizeof(T) + blocks.capacity() * sizeof(std::unique_ptr<T[]>);
+		}
+
+		void clear() {
+			blocks.clear();
+			used = 0;
+			elements = 0;
+		}
+
+	private:
+		std::vector<std::unique_ptr<T[]>> blocks;
+		// of the last block
+		size_t used = 0;
+		size_t elements = 0;
+	};
+}
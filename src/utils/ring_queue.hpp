@@ -0,0 +1,94 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <vector>
+
+// RingQueue is a FIFO queue in a single ring buffer. It grows by doubling up to a bound,
+// and once full it refuses new values, so the caller decides what overflowing means.
+namespace stdext {
+	template <typename T>
+	class ring_queue {
+	public:
+		// maxSize is rounded up to a power of two, so the ring always wraps with a mask
+		explicit ring_queue(size_t maxSize) :
+			maxCapacity(std::bit_ceil(std::max<size_t>(maxSize, 1))) { }
+
+		// Ensures that we don't accidentally copy it
+		ring_queue(const ring_queue &) = delete;
+		ring_queue &operator=(const ring_queue &) = delete;
+
+		// Returns false, leaving the queue as it was, when it already holds its bound
+		bool push(T value) {
+			if (count == ring.size()) {
+				if (count >= maxCapacity) {
+					return false;
+				}
+				grow();
+			}
+
+			ring[(head + count) & (ring.size() - 1)] = std::move(value);
+			++count;
+			return true;
+		}
+
+		// Must not be called on an empty queue
+		T pop() {
+			T value = std::move(ring[head]);
+			head = (head + 1) & (ring.size() - 1);
+			--count;
+			return value;
+		}
+
+		// Drops every value and gives the ring back
+		void clear() {
+			ring.clear();
+			ring.shrink_to_fit();
+			head = 0;
+			count = 0;
+		}
+
+		size_t size() const noexcept {
+			return count;
+		}
+
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		size_t capacity() const noexcept {
+			return ring.size();
+		}
+
+		size_t max_size() const noexcept {
+			return maxCapacity;
+		}
+
+	private:
+		static constexpr size_t MIN_CAPACITY = 16;
+
+		void grow() {
+			std::vector<T> grown(std::min(std::max(ring.size() * 2, MIN_CAPACITY), maxCapacity));
+			for (size_t i = 0; i < count; ++i) {
+				grown[i] = std::move(ring[(head + i) & (ring.size() - 1)]);
+			}
+			ring = std::move(grown);
+			head = 0;
+		}
+
+		const size_t maxCapacity;
+		std::vector<T> ring;
+		size_t head = 0;
+		size_t count = 0;
+	};
+}
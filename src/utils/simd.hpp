@@ -64,3 +64,35 @@ __forceinline unsigned int _mm_ctz(unsigned int value) {
 #else
 	#define _mm_ctz __builtin_ctz
 #endif
+
+namespace simd {
+	// Runtime check for kernels built for a wider instruction set than the target one (with a target attribute)
+	inline bool hasAVX2() {
+#if defined(__DISABLE_VECTORIZATION__)
+		return false;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		static const bool supported = __builtin_cpu_supports("avx2");
+		return supported;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		static const bool supported = [] {
+			int info[4];
+			__cpuid(info, 0);
+			if (info[0] < 7) {
+				return false;
+			}
+
+			// AVX and OSXSAVE, and the OS saving the ymm registers
+			__cpuid(info, 1);
+			if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) {
+				return false;
+			}
+
+			__cpuidex(info, 7, 0);
+			return (info[1] & (1 << 5)) != 0;
+		}();
+		return supported;
+#else
+		return false;
+#endif
+	}
+}
@@ -0,0 +1,368 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+// TimingWheel is a hierarchical timer wheel (4 levels of 64 buckets) that stores its values
+// in pooled slots linked into intrusive bucket lists, so schedule and cancel are O(1).
+// Values whose bucket has been reached are moved to a small heap ordered by their exact
+// expiration, so they are never handed out before their time, nor out of order.
+namespace stdext {
+	template <typename T>
+	class timing_wheel {
+	public:
+		using handle_t = uint64_t;
+
+		static constexpr handle_t INVALID_HANDLE = 0;
+
+		explicit timing_wheel(int64_t granularity = 50) :
+			granularity(std::max<int64_t>(granularity, 1)) {
+			for (auto &level : levels) {
+				level.fill(NIL);
+			}
+		}
+
+		// Ensures that we don't accidentally copy it
+		timing_wheel(const timing_wheel &) = delete;
+		timing_wheel &operator=(const timing_wheel &) = delete;
+
+		// Sets the wheel clock, must be called before the first schedule.
+		void start(int64_t now) {
+			currentTick = now / granularity;
+			started = true;
+		}
+
+		handle_t schedule(T &&value, int64_t expiration) {
+			if (!started) {
+				start(expiration);
+			}
+
+			const auto index = allocate();
+			auto &slot = slots[index];
+			slot.value.emplace(std::move(value));
+			slot.canceled = false;
+			slot.expiration = expiration;
+			slot.sequence = ++lastSequence;
+			place(index);
+			++count;
+
+			return makeHandle(index, slot.generation);
+		}
+
+		// Removes the value from the wheel, returns false if the handle is stale.
+		bool cancel(handle_t handle) {
+			const auto index = static_cast<uint32_t>(handle & 0xFFFFFFFF);
+			if (handle == INVALID_HANDLE || index >= slots.size()) {
+				return false;
+			}
+
+			auto &slot = slots[index];
+			if (slot.generation != static_cast<uint32_t>(handle >> 32) || slot.level == FREE || slot.canceled) {
+				return false;
+			}
+
+			if (slot.level == DUE) {
+				// heap removal is lazy, the slot is released once it reaches the top
+				slot.canceled = true;
+			} else {
+				unlink(index);
+				release(index);
+			}
+
+			--count;
+			return true;
+		}
+
+		// Hands every value whose expiration is <= now to the callback, in expiration order.
+		template <typename F>
+		void advance(int64_t now, F &&callback) {
+			if (!started) {
+				start(now);
+			}
+
+			const auto targetTick = now / granularity;
+			while (currentTick <= targetTick) {
+				if (linked == 0) {
+					// nothing left in the buckets, jump straight to the target
+					currentTick = targetTick + 1;
+					break;
+				}
+
+				if ((currentTick & MASK) == 0) {
+					cascade();
+				}
+
+				auto &bucket = levels[0][currentTick & MASK];
+				while (bucket != NIL) {
+					const auto index = bucket;
+					unlink(index);
+					pushDue(index);
+				}
+
+				++currentTick;
+			}
+
+			while (!due.empty()) {
+				const auto index = due.front();
+				auto &slot = slots[index];
+				if (!slot.canceled && slot.expiration > now) {
+					break;
+				}
+
+				std::ranges::pop_heap(due, DueCompare { slots });
+				due.pop_back();
+
+				const bool canceled = slot.canceled;
+				T value = std::move(*slot.value);
+				release(index);
+
+				if (!canceled) {
+					--count;
+					callback(value);
+				}
+			}
+		}
+
+		// Lower bound of the next expiration, the caller may wake up earlier than needed but never later.
+		int64_t nextExpiration() const {
+			if (count == 0) {
+				return std::numeric_limits<int64_t>::max();
+			}
+
+			if (!due.empty()) {
+				return slots[due.front()].expiration;
+			}
+
+			auto nextTick = std::numeric_limits<int64_t>::max();
+			for (uint8_t level = 0; level < LEVELS; ++level) {
+				const auto shift = level * BITS;
+				const auto block = currentTick >> shift;
+				const auto bits = std::rotr(occupied[level], static_cast<int>(block & MASK));
+				if (bits == 0) {
+					continue;
+				}
+
+				if (level == 0) {
+					nextTick = std::min(nextTick, currentTick + std::countr_zero(bits));
+					continue;
+				}
+
+				// a higher level bucket has to be cascaded first, the one under the current block
+				// cascades when the current tick is processed, or only after a full turn
+				if ((bits & 1) != 0) {
+					const bool atBlockStart = (currentTick & ((int64_t(1) << shift) - 1)) == 0;
+					nextTick = std::min(nextTick, atBlockStart ? currentTick : (block + SIZE) << shift);
+				}
+
+				if (const auto others = bits & ~uint64_t(1); others != 0) {
+					nextTick = std::min(nextTick, (block + std::countr_zero(others)) << shift);
+				}
+			}
+
+			return nextTick == std::numeric_limits<int64_t>::max() ? nextTick : nextTick * granularity;
+		}
+
+		T* get(handle_t handle) {
+			const auto index = static_cast<uint32_t>(handle & 0xFFFFFFFF);
+			if (handle == INVALID_HANDLE || index >= slots.size()) {
+				return nullptr;
+			}
+
+			auto &slot = slots[index];
+			if (slot.generation != static_cast<uint32_t>(handle >> 32) || slot.level == FREE || slot.canceled) {
+				return nullptr;
+			}
+
+			return &*slot.value;
+		}
+
+		size_t size() const noexcept {
+			return count;
+		}
+
+		bool empty() const noexcept {
+			return count == 0;
+		}
+
+		size_t capacity() const noexcept {
+			return slots.size();
+		}
+
+		void reserve(size_t n) {
+			slots.reserve(n);
+			due.reserve(n / 8);
+		}
+
+	private:
+		static constexpr uint8_t BITS = 6;
+		static constexpr uint8_t LEVELS = 4;
+		static constexpr int64_t SIZE = 1 << BITS;
+		static constexpr int64_t MASK = SIZE - 1;
+		static constexpr int64_t HORIZON = int64_t(1) << (BITS * LEVELS);
+
+		static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+		static constexpr uint8_t DUE = LEVELS;
+		static constexpr uint8_t FREE = LEVELS + 1;
+
+		struct Slot {
+			std::optional<T> value;
+			int64_t expiration = 0;
+			uint64_t sequence = 0;
+			uint32_t prev = NIL;
+			uint32_t next = NIL;
+			uint32_t generation = 1;
+			uint8_t level = FREE;
+			uint8_t bucket = 0;
+			bool canceled = false;
+		};
+
+		struct DueCompare {
+			const std::vector<Slot> &slots;
+
+			bool operator()(uint32_t a, uint32_t b) const {
+				const auto &sa = slots[a];
+				const auto &sb = slots[b];
+				if (sa.expiration != sb.expiration) {
+					return sa.expiration > sb.expiration;
+				}
+				return sa.sequence > sb.sequence;
+			}
+		};
+
+		static handle_t makeHandle(uint32_t index, uint32_t generation) {
+			return (static_cast<handle_t>(generation) << 32) | index;
+		}
+
+		uint32_t allocate() {
+			if (!freeList.empty()) {
+				const auto index = freeList.back();
+				freeList.pop_back();
+				return index;
+			}
+
+			slots.emplace_back();
+			return static_cast<uint32_t>(slots.size() - 1);
+		}
+
+		void release(uint32_t index) {
+			auto &slot = slots[index];
+			slot.value.reset();
+			slot.level = FREE;
+			slot.canceled = false;
+			// generation 0 is reserved so INVALID_HANDLE never matches a live slot
+			if (++slot.generation == 0) {
+				slot.generation = 1;
+			}
+			freeList.emplace_back(index);
+		}
+
+		void place(uint32_t index) {
+			auto &slot = slots[index];
+			const auto tick = slot.expiration / granularity;
+			if (tick < currentTick) {
+				pushDue(index);
+				return;
+			}
+
+			const auto delta = std::min<int64_t>(tick - currentTick, HORIZON - 1);
+			const auto target = currentTick + delta;
+
+			uint8_t level = 0;
+			while (level < LEVELS - 1 && delta >= (int64_t(1) << (BITS * (level + 1)))) {
+				++level;
+			}
+
+			link(index, level, static_cast<uint8_t>((target >> (BITS * level)) & MASK));
+		}
+
+		void link(uint32_t index, uint8_t level, uint8_t bucket) {
+			auto &slot = slots[index];
+			auto &head = levels[level][bucket];
+
+			slot.level = level;
+			slot.bucket = bucket;
+			slot.prev = NIL;
+			slot.next = head;
+			if (head != NIL) {
+				slots[head].prev = index;
+			}
+			head = index;
+			occupied[level] |= uint64_t(1) << bucket;
+			++linked;
+		}
+
+		void unlink(uint32_t index) {
+			auto &slot = slots[index];
+			auto &head = levels[slot.level][slot.bucket];
+
+			if (slot.prev != NIL) {
+				slots[slot.prev].next = slot.next;
+			} else {
+				head = slot.next;
+			}
+
+			if (slot.next != NIL) {
+				slots[slot.next].prev = slot.prev;
+			}
+
+			if (head == NIL) {
+				occupied[slot.level] &= ~(uint64_t(1) << slot.bucket);
+			}
+
+			slot.prev = NIL;
+			slot.next = NIL;
+			--linked;
+		}
+
+		void pushDue(uint32_t index) {
+			slots[index].level = DUE;
+			due.emplace_back(index);
+			std::ranges::push_heap(due, DueCompare { slots });
+		}
+
+		// Re-distributes the higher level buckets that start at the current tick.
+		void cascade() {
+			for (uint8_t level = 1; level < LEVELS; ++level) {
+				const auto bucket = static_cast<uint8_t>((currentTick >> (BITS * level)) & MASK);
+				auto &head = levels[level][bucket];
+				while (head != NIL) {
+					const auto index = head;
+					unlink(index);
+					place(index);
+				}
+
+				if (bucket != 0) {
+					break;
+				}
+			}
+		}
+
+		const int64_t granularity;
+		int64_t currentTick = 0;
+		uint64_t lastSequence = 0;
+		size_t count = 0;
+		size_t linked = 0;
+		bool started = false;
+
+		std::array<std::array<uint32_t, SIZE>, LEVELS> levels {};
+		std::array<uint64_t, LEVELS> occupied {};
+
+		std::vector<Slot> slots;
+		std::vector<uint32_t> freeList;
+		std::vector<uint32_t> due;
+	};
+}
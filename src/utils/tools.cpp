@@ -13,6 +13,12 @@
 #include "items/item.hpp"
 #include "utils/tools.hpp"
 
+#ifdef _WIN32
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+#endif
+
 void printXMLError(const std::string &where, const std::string &fileName, const pugi::xml_parse_result &result) {
 	g_logger().error("[{}] Failed to load {}: {}", where, fileName, result.description());
 
@@ -1006,6 +1012,39 @@ uint32_t adlerChecksum(const uint8_t* data, size_t length) {
 
 	uint32_t a = 1, b = 0;
 
+#if defined(__SSE2__)
+	// 16 bytes per step: a gets their sum (psadbw) and b their sum weighted by the distance to the
+	// end of the step (pmaddwd), plus 16 times the a of the previous steps of the block.
+	// Blocks are kept under 5552 bytes so that nothing overflows before the modulo.
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i firstWeights = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+	const __m128i lastWeights = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+	const auto sumLanes = [](__m128i v) {
+		v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+		v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+		return static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+	};
+
+	while (length >= 16) {
+		const size_t blockLength = std::min<size_t>(length, 5536) & ~static_cast<size_t>(15);
+		__m128i sumA = zero, sumB = zero, previousA = zero;
+		for (size_t i = 0; i < blockLength; i += 16) {
+			const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+			previousA = _mm_add_epi32(previousA, sumA);
+			sumA = _mm_add_epi32(sumA, _mm_sad_epu8(bytes, zero));
+			sumB = _mm_add_epi32(sumB, _mm_madd_epi16(_mm_unpacklo_epi8(bytes, zero), firstWeights));
+			sumB = _mm_add_epi32(sumB, _mm_madd_epi16(_mm_unpackhi_epi8(bytes, zero), lastWeights));
+		}
+		sumB = _mm_add_epi32(sumB, _mm_slli_epi32(previousA, 4));
+
+		b = static_cast<uint32_t>((b + static_cast<uint64_t>(a) * blockLength + sumLanes(sumB)) % adler);
+		a = (a + sumLanes(sumA)) % adler;
+
+		data += blockLength;
+		length -= blockLength;
+	}
+#endif
+
 	while (length > 0) {
 		size_t tmp = length > 5552 ? 5552 : length;
 		length -= tmp;
@@ -1788,6 +1827,27 @@ void sleep_for(uint64_t ms) {
 	std::this_thread::sleep_for(std::chrono::milliseconds(ms));
 }
 
+uint64_t getPeakMemoryUsage() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	rusage usage {};
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return 0;
+	}
+	#ifdef __APPLE__
+	return static_cast<uint64_t>(usage.ru_maxrss);
+	#else
+	// in kilobytes
+	return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+	#endif
+#endif
+}
+
 /**
  * @brief Formats a string to be used as KV key (lowercase, spaces replaced with -, no whitespace)
  * @param str The string to format
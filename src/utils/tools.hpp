@@ -142,6 +142,9 @@ std::string formatPrice(std::string price, bool space /* = false*/);
 std::vector<std::string> split(const std::string &str);
 std::string getFormattedTimeRemaining(uint32_t time);
 
+// Peak resident memory of the process, in bytes
+uint64_t getPeakMemoryUsage();
+
 static inline unsigned int getNumberOfCores() {
 	return std::thread::hardware_concurrency();
 }
@@ -0,0 +1,139 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/monsters/monster.hpp"
+#include "creatures/monsters/monsters.hpp"
+#include "creatures/players/player.hpp"
+#include "game/game.hpp"
+#include "map/spectators.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// a hunting ground: dense enough that every monster sees dozens of creatures
+	constexpr uint16_t AREA_X = 3000;
+	constexpr uint16_t AREA_Y = 3000;
+	constexpr uint16_t AREA_SIZE = 64;
+	constexpr uint8_t AREA_Z = 8;
+	constexpr size_t MONSTERS = 500;
+	constexpr size_t PLAYERS = 50;
+	constexpr size_t ROUNDS = 20;
+
+	Position randomPosition(std::mt19937 &random) {
+		return Position(static_cast<uint16_t>(AREA_X + random() % AREA_SIZE), static_cast<uint16_t>(AREA_Y + random() % AREA_SIZE), AREA_Z);
+	}
+
+	void place(const std::shared_ptr<Creature> &creature, const Position &pos) {
+		g_game().map.getOrCreateTile(pos)->internalAddThing(creature);
+		g_game().map.getQTNode(pos.x, pos.y)->addCreature(creature);
+		creature->setID();
+	}
+
+	// What Map::moveCreature does to the tiles and the quadtree, without the notifications
+	void step(const std::shared_ptr<Creature> &creature, const Position &toPos) {
+		auto &map = g_game().map;
+		const Position fromPos = creature->getPosition();
+		map.getTile(fromPos)->removeThing(creature, 0);
+
+		const auto fromLeaf = map.getQTNode(fromPos.x, fromPos.y);
+		const auto toLeaf = map.getQTNode(toPos.x, toPos.y);
+		if (fromLeaf != toLeaf) {
+			fromLeaf->removeCreature(creature);
+			toLeaf->addCreature(creature);
+		}
+
+		map.getOrCreateTile(toPos)->internalAddThing(creature);
+		toLeaf->updateCreature(creature);
+	}
+
+	// What the game tells the other monsters about the step, the band relies on it for what moved into view by itself
+	void announce(const std::shared_ptr<Creature> &creature, const Position &oldPos) {
+		const Position &newPos = creature->getPosition();
+		const auto observers = Spectators().find<Creature>(newPos, true, MAP_MAX_VIEW_PORT_X + 1, MAP_MAX_VIEW_PORT_X + 1, MAP_MAX_VIEW_PORT_Y + 1, MAP_MAX_VIEW_PORT_Y + 1).filter<Monster>();
+		for (const auto &observer : observers) {
+			if (observer == creature) {
+				continue;
+			}
+
+			const bool canSeeNewPos = observer->canSee(newPos);
+			const bool canSeeOldPos = observer->canSee(oldPos);
+			if (canSeeNewPos && !canSeeOldPos) {
+				observer->onCreatureAppear(creature, false);
+			} else if (!canSeeNewPos && canSeeOldPos) {
+				observer->onRemoveCreature(creature, false);
+			}
+		}
+	}
+
+	Position randomStep(std::mt19937 &random, const Position &pos) {
+		const auto x = std::clamp<int32_t>(pos.x + static_cast<int32_t>(random() % 3) - 1, AREA_X, AREA_X + AREA_SIZE - 1);
+		const auto y = std::clamp<int32_t>(pos.y + static_cast<int32_t>(random() % 3) - 1, AREA_Y, AREA_Y + AREA_SIZE - 1);
+		return Position(static_cast<uint16_t>(x), static_cast<uint16_t>(y), pos.z);
+	}
+
+	template <typename Update>
+	void benchmarkSteps(const std::string &name, const std::vector<std::shared_ptr<Monster>> &monsters, Update &&update) {
+		std::mt19937 random { 7 };
+		double elapsed = 0;
+		size_t targets = 0;
+		for (size_t round = 0; round < ROUNDS; ++round) {
+			for (const auto &monster : monsters) {
+				const Position oldPos = monster->getPosition();
+				step(monster, randomStep(random, oldPos));
+				announce(monster, oldPos);
+
+				Benchmark bm;
+				update(monster, oldPos);
+				elapsed += bm.duration();
+			}
+		}
+
+		size_t friends = 0;
+		for (const auto &monster : monsters) {
+			targets += monster->getTargetList().size();
+			friends += monster->getFriendList().size();
+		}
+		fmt::print("[{}] {} monster steps: {:.2f} ms, {} targets and {} friends tracked\n", name, ROUNDS * monsters.size(), elapsed, targets, friends);
+	}
+}
+
+suite<"benchmark"> monsterTargetsBenchmark = [] {
+	static Group group;
+	std::mt19937 random { 42 };
+
+	const auto monsterType = std::make_shared<MonsterType>("benchmark");
+	std::vector<std::shared_ptr<Monster>> monsters;
+	monsters.reserve(MONSTERS);
+	for (size_t i = 0; i < MONSTERS; ++i) {
+		const auto monster = std::make_shared<Monster>(monsterType);
+		place(monster, randomPosition(random));
+		monsters.emplace_back(monster);
+	}
+
+	std::vector<std::shared_ptr<Player>> players;
+	players.reserve(PLAYERS);
+	for (size_t i = 0; i < PLAYERS; ++i) {
+		const auto player = std::make_shared<Player>(nullptr);
+		player->setGroup(&group);
+		player->setGUID(static_cast<uint32_t>(i + 1));
+		place(player, randomPosition(random));
+		players.emplace_back(player);
+	}
+
+	for (const auto &monster : monsters) {
+		monster->updateTargetList();
+	}
+
+	test("monster target list rescanned on every step") = [&monsters] {
+		benchmarkSteps("full rescan", monsters, [](const std::shared_ptr<Monster> &monster, const Position &) {
+			monster->updateTargetList();
+		});
+	};
+
+	test("monster target list updated with the uncovered band") = [&monsters] {
+		benchmarkSteps("uncovered band", monsters, [](const std::shared_ptr<Monster> &monster, const Position &oldPos) {
+			monster->updateTargetList(oldPos);
+		});
+	};
+};
@@ -0,0 +1,111 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/task.hpp"
+#include "utils/timing_wheel.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t EVENTS = 200000;
+	constexpr int64_t TICK = 50;
+
+	struct TaskCompare {
+		bool operator()(const std::shared_ptr<Task> &a, const std::shared_ptr<Task> &b) const {
+			return a->getTime() < b->getTime();
+		}
+	};
+
+	std::vector<uint32_t> makeDelays() {
+		// mostly short walk/condition delays with a tail of long decay/respawn timers
+		std::mt19937 random { 42 };
+		std::vector<uint32_t> delays(EVENTS);
+		for (auto &delay : delays) {
+			delay = random() % 10 == 0 ? 60000 + random() % 600000 : 50 + random() % 2000;
+		}
+		return delays;
+	}
+
+	int64_t toMs(const std::chrono::system_clock::time_point &time) {
+		return std::chrono::ceil<std::chrono::milliseconds>(time.time_since_epoch()).count();
+	}
+}
+
+suite<"benchmark"> schedulerBenchmark = [] {
+	Task::TIME_NOW = std::chrono::system_clock::now();
+	const auto delays = makeDelays();
+	const auto start = Task::TIME_NOW;
+
+	test("scheduler btree_multiset") = [&] {
+		phmap::btree_multiset<std::shared_ptr<Task>, TaskCompare> scheduled;
+		phmap::flat_hash_map<uint64_t, std::shared_ptr<Task>> ref;
+		Task::TIME_NOW = start;
+
+		Benchmark bm;
+		size_t executed = 0;
+		for (const auto delay : delays) {
+			auto task = std::make_shared<Task>([&executed] { ++executed; }, "Benchmark::btree", delay, false, false);
+			ref.emplace(task->getId(), task);
+			scheduled.emplace(std::move(task));
+		}
+		const auto scheduleTime = bm.duration();
+
+		bm.start();
+		// cancel one of every four events, as walks and conditions are often stopped early
+		size_t i = 0;
+		for (auto it = ref.begin(); it != ref.end(); ++it, ++i) {
+			if (i % 4 == 0) {
+				it->second->cancel();
+			}
+		}
+
+		while (!scheduled.empty()) {
+			Task::TIME_NOW += std::chrono::milliseconds(TICK);
+			auto it = scheduled.begin();
+			while (it != scheduled.end() && (*it)->getTime() <= Task::TIME_NOW) {
+				(*it)->execute();
+				ref.erase((*it)->getId());
+				++it;
+			}
+			scheduled.erase(scheduled.begin(), it);
+		}
+
+		fmt::print("[btree_multiset] schedule {} events: {:.2f} ms, cancel + execute {}: {:.2f} ms\n", EVENTS, scheduleTime, executed, bm.duration());
+	};
+
+	test("scheduler timing_wheel") = [&] {
+		stdext::timing_wheel<Task> scheduled { TICK };
+		phmap::flat_hash_map<uint64_t, stdext::timing_wheel<Task>::handle_t> ref;
+		Task::TIME_NOW = start;
+		scheduled.start(toMs(start));
+
+		Benchmark bm;
+		size_t executed = 0;
+		for (const auto delay : delays) {
+			Task task([&executed] { ++executed; }, "Benchmark::timing_wheel", delay, false, false);
+			const auto id = task.getId();
+			const auto expiration = toMs(task.getTime());
+			ref.emplace(id, scheduled.schedule(std::move(task), expiration));
+		}
+		const auto scheduleTime = bm.duration();
+
+		bm.start();
+		size_t i = 0;
+		for (auto it = ref.begin(); it != ref.end(); ++it, ++i) {
+			if (i % 4 == 0) {
+				scheduled.cancel(it->second);
+			}
+		}
+
+		while (!scheduled.empty()) {
+			Task::TIME_NOW += std::chrono::milliseconds(TICK);
+			scheduled.advance(toMs(Task::TIME_NOW), [&ref](Task &task) {
+				task.execute();
+				ref.erase(task.getId());
+			});
+		}
+
+		fmt::print("[timing_wheel] schedule {} events: {:.2f} ms, cancel + execute {}: {:.2f} ms\n", EVENTS, scheduleTime, executed, bm.duration());
+	};
+};
@@ -0,0 +1,153 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/monsters/monster.hpp"
+#include "creatures/monsters/monsters.hpp"
+#include "game/game.hpp"
+#include "items/scoped_item_types.hpp"
+#include "map/utils/pathfinder.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t REGION_SIZE = 96;
+	constexpr uint16_t REGION_X = 2000;
+	constexpr uint16_t REGION_Y = 2000;
+	constexpr uint8_t REGION_Z = 9;
+	constexpr uint16_t GROUND_ID = 4526;
+	constexpr size_t MONSTERS = 200;
+	constexpr size_t ROUNDS = 10;
+
+	// The same caves as the pathfinding benchmark, only the open cells get a ground
+	std::vector<bool> makeRegion(std::mt19937 &random) {
+		std::vector<bool> blocked(REGION_SIZE * REGION_SIZE);
+		for (int i = 0; i < REGION_SIZE * 6; ++i) {
+			int x = random() % REGION_SIZE;
+			int y = random() % REGION_SIZE;
+			for (int length = 0; length < 12; ++length) {
+				blocked[y * REGION_SIZE + x] = true;
+				x = std::clamp<int>(x + static_cast<int>(random() % 3) - 1, 0, REGION_SIZE - 1);
+				y = std::clamp<int>(y + static_cast<int>(random() % 3) - 1, 0, REGION_SIZE - 1);
+			}
+		}
+		return blocked;
+	}
+
+	Position randomOpenPosition(std::mt19937 &random, const std::vector<bool> &blocked) {
+		while (true) {
+			const uint16_t x = random() % REGION_SIZE;
+			const uint16_t y = random() % REGION_SIZE;
+			if (!blocked[y * REGION_SIZE + x]) {
+				return Position(REGION_X + x, REGION_Y + y, REGION_Z);
+			}
+		}
+	}
+
+	struct Chase {
+		std::shared_ptr<Monster> monster;
+		Position targetPos;
+	};
+
+	template <typename Search>
+	void benchmarkChases(std::string_view name, const std::vector<Chase> &chases, Search &&search) {
+		Benchmark bm;
+		size_t found = 0;
+		for (size_t round = 0; round < ROUNDS; ++round) {
+			for (const auto &chase : chases) {
+				found += search(chase) ? 1 : 0;
+			}
+		}
+
+		fmt::print("[{}] {} follow searches: {:.2f} ms, {} paths found\n", name, ROUNDS * chases.size(), bm.duration(), found);
+	}
+}
+
+suite<"benchmark"> followPathBenchmark = [] {
+	ScopedItemTypes itemTypes;
+	auto &ground = itemTypes.add(GROUND_ID);
+	ground.group = ITEM_GROUP_GROUND;
+	ground.name = "benchmark ground";
+
+	std::mt19937 random { 42 };
+	const auto blocked = makeRegion(random);
+
+	auto &map = g_game().map;
+	for (uint16_t y = 0; y < REGION_SIZE; ++y) {
+		for (uint16_t x = 0; x < REGION_SIZE; ++x) {
+			if (!blocked[y * REGION_SIZE + x]) {
+				map.getOrCreateTile(Position(REGION_X + x, REGION_Y + y, REGION_Z))->internalAddThing(Item::CreateItem(GROUND_ID));
+			}
+		}
+	}
+
+	// monsters chasing someone up to a screen away, each with the walk cache it keeps in game
+	const auto monsterType = std::make_shared<MonsterType>("benchmark");
+	std::vector<Chase> chases;
+	chases.reserve(MONSTERS);
+	while (chases.size() < MONSTERS) {
+		const Position pos = randomOpenPosition(random, blocked);
+		const auto tile = map.getTile(pos);
+		if (tile->getTopCreature()) {
+			continue;
+		}
+
+		const auto monster = std::make_shared<Monster>(monsterType);
+		tile->internalAddThing(monster);
+		map.getQTNode(pos.x, pos.y)->addCreature(monster);
+		monster->Creature::onCreatureAppear(monster, false);
+
+		Position targetPos = randomOpenPosition(random, blocked);
+		targetPos.x = std::clamp<int32_t>(targetPos.x, pos.x - 8, pos.x + 8);
+		targetPos.y = std::clamp<int32_t>(targetPos.y, pos.y - 6, pos.y + 6);
+		chases.push_back({ monster, targetPos });
+	}
+
+	FindPathParams fpp;
+	fpp.fullPathSearch = true;
+	fpp.clearSight = true;
+	fpp.maxSearchDist = 12;
+	fpp.minTargetDist = 1;
+	fpp.maxTargetDist = 1;
+
+	test("follow path searched on the dispatcher, against the snapshot taken for the thread pool") = [&chases, &fpp] {
+		// what a chase cost the dispatcher before the thread pool took the search
+		benchmarkChases("dispatcher search", chases, [&fpp](const Chase &chase) {
+			stdext::arraylist<Direction> listDir(128);
+			return g_game().map.getPathMatching(chase.monster, listDir, FrozenPathingConditionCall(chase.targetPos), fpp);
+		});
+
+		// what it costs the dispatcher now
+		PathfindingGrid grid;
+		benchmarkChases("dispatcher snapshot", chases, [&fpp, &grid](const Chase &chase) {
+			grid.capture(chase.monster, chase.monster->getPosition(), chase.targetPos, fpp.maxSearchDist);
+			return true;
+		});
+
+		// and what is left for the thread pool, not counted against the dispatcher
+		benchmarkChases("thread pool search", chases, [&fpp](const Chase &chase) {
+			PathfindingGrid grid;
+			grid.capture(chase.monster, chase.monster->getPosition(), chase.targetPos, fpp.maxSearchDist);
+			stdext::arraylist<Direction> listDir(128);
+			return Map::getPathMatching(grid, chase.monster->getPosition(), listDir, FrozenPathingConditionCall(chase.targetPos), fpp);
+		});
+	};
+
+	test("follow path snapshot finds the paths the dispatcher search finds") = [&chases, &fpp] {
+		size_t mismatches = 0;
+		for (const auto &chase : chases) {
+			stdext::arraylist<Direction> direct(128);
+			const bool foundDirect = g_game().map.getPathMatching(chase.monster, direct, FrozenPathingConditionCall(chase.targetPos), fpp);
+
+			PathfindingGrid grid;
+			grid.capture(chase.monster, chase.monster->getPosition(), chase.targetPos, fpp.maxSearchDist);
+			stdext::arraylist<Direction> snapshot(128);
+			const bool foundSnapshot = Map::getPathMatching(grid, chase.monster->getPosition(), snapshot, FrozenPathingConditionCall(chase.targetPos), fpp);
+
+			if (foundDirect != foundSnapshot || direct.size() != snapshot.size()) {
+				++mismatches;
+			}
+		}
+		expect(eq(mismatches, 0u));
+	};
+};
@@ -0,0 +1,68 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/mapcache.hpp"
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t TILES = 1000000;
+	constexpr size_t MEGABYTE = 1024 * 1024;
+
+	std::shared_ptr<BasicItem> makeItem(uint16_t id, uint16_t actionId, const std::string &text = "") {
+		const auto item = std::make_shared<BasicItem>();
+		item->id = id;
+		item->actionId = actionId;
+		item->text = text;
+		return item;
+	}
+
+	// A distinct tile, a ground and two items, one of them a container with a text now and then
+	std::shared_ptr<BasicTile> makeTile(size_t i) {
+		const auto tile = std::make_shared<BasicTile>();
+		tile->ground = makeItem(static_cast<uint16_t>(100 + i % 500), 0);
+		tile->items.emplace_back(makeItem(static_cast<uint16_t>(1000 + i % 3000), static_cast<uint16_t>(i / 3000)));
+		const auto container = makeItem(2000, static_cast<uint16_t>(i % 60000), i % 16 == 0 ? fmt::format("a note left on tile number {}", i) : "");
+		container->items.emplace_back(makeItem(3000, static_cast<uint16_t>(i / 60000)));
+		tile->items.emplace_back(container);
+		return tile;
+	}
+
+	uint64_t peakGrowth(uint64_t base) {
+		const auto peak = getPeakMemoryUsage();
+		return peak > base ? (peak - base) / MEGABYTE : 0;
+	}
+}
+
+suite<"benchmark"> mapCacheBenchmark = [] {
+	// Peak RSS only grows, both layouts are measured from the same base and the smaller one goes first
+	test("map cache peak memory, index arenas against shared objects") = [] {
+		const auto base = getPeakMemoryUsage();
+
+		{
+			Benchmark bm;
+			MapCache cache;
+			for (size_t i = 0; i < TILES; ++i) {
+				cache.cacheBasicTile(makeTile(i));
+			}
+			cache.flush();
+
+			const auto report = cache.getMemoryReport();
+			fmt::print("[index arenas] {} tiles, {} items: {:.2f} ms, {} MB reported, peak RSS +{} MB\n", report.tiles, report.items, bm.duration(), report.bytes / MEGABYTE, peakGrowth(base));
+		}
+
+		{
+			Benchmark bm;
+			// how the cache kept them before, each tile and item its own shared object
+			std::vector<std::shared_ptr<BasicTile>> tiles;
+			tiles.reserve(TILES);
+			for (size_t i = 0; i < TILES; ++i) {
+				tiles.emplace_back(makeTile(i));
+			}
+
+			fmt::print("[shared objects] {} tiles: {:.2f} ms, peak RSS +{} MB\n", tiles.size(), bm.duration(), peakGrowth(base));
+		}
+	};
+};
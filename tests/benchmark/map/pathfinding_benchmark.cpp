@@ -0,0 +1,171 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/utils/astarnodes.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t REGION_SIZE = 128;
+	constexpr uint16_t REGION_X = 1000;
+	constexpr uint16_t REGION_Y = 1000;
+	constexpr size_t SEARCHES = 2000;
+
+	// The open list as it was before the heap, a linear scan over every created node
+	class LinearNodes {
+	public:
+		LinearNodes(uint32_t x, uint32_t y, int32_t maxNodes) :
+			nodes(maxNodes), openNodes(maxNodes) {
+			createOpenNode(nullptr, x, y, 0);
+		}
+
+		AStarNode* createOpenNode(AStarNode* parent, uint32_t x, uint32_t y, int_fast32_t f) {
+			if (curNode >= nodes.size()) {
+				return nullptr;
+			}
+
+			const auto index = curNode++;
+			openNodes[index] = true;
+			AStarNode* node = &nodes[index];
+			nodeTable[(x << 16) | y] = node;
+			node->parent = parent;
+			node->x = x;
+			node->y = y;
+			node->f = f;
+			return node;
+		}
+
+		AStarNode* getBestNode() {
+			int_fast32_t bestF = std::numeric_limits<int_fast32_t>::max();
+			AStarNode* best = nullptr;
+			for (size_t i = 0; i < curNode; ++i) {
+				if (openNodes[i] && nodes[i].f < bestF) {
+					bestF = nodes[i].f;
+					best = &nodes[i];
+				}
+			}
+			return best;
+		}
+
+		void closeNode(AStarNode* node) {
+			openNodes[node - nodes.data()] = false;
+		}
+
+		void openNode(AStarNode* node) {
+			openNodes[node - nodes.data()] = true;
+		}
+
+		AStarNode* getNodeByPosition(uint32_t x, uint32_t y) {
+			const auto it = nodeTable.find((x << 16) | y);
+			return it == nodeTable.end() ? nullptr : it->second;
+		}
+
+	private:
+		std::vector<AStarNode> nodes;
+		std::vector<bool> openNodes;
+		phmap::flat_hash_map<uint32_t, AStarNode*> nodeTable;
+		size_t curNode = 0;
+	};
+
+	// A cave-like region, walls are grown from random seeds so there are corridors and dead ends to route around
+	std::vector<bool> makeRegion(std::mt19937 &random) {
+		std::vector<bool> blocked(REGION_SIZE * REGION_SIZE);
+		for (int i = 0; i < REGION_SIZE * 6; ++i) {
+			int x = random() % REGION_SIZE;
+			int y = random() % REGION_SIZE;
+			for (int length = 0; length < 12; ++length) {
+				blocked[y * REGION_SIZE + x] = true;
+				x = std::clamp<int>(x + static_cast<int>(random() % 3) - 1, 0, REGION_SIZE - 1);
+				y = std::clamp<int>(y + static_cast<int>(random() % 3) - 1, 0, REGION_SIZE - 1);
+			}
+		}
+		return blocked;
+	}
+
+	// The same expansion as Map::getPathMatching, without the tile and creature checks
+	template <typename Nodes>
+	size_t findPath(const std::vector<bool> &blocked, const Position &from, const Position &to, int32_t maxNodes) {
+		static constexpr int_fast32_t neighbors[8][2] = {
+			{ -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 }
+		};
+
+		Nodes nodes(from.x, from.y, maxNodes);
+		while (AStarNode* n = nodes.getBestNode()) {
+			if (n->x == to.x && n->y == to.y) {
+				size_t length = 0;
+				for (; n->parent; n = n->parent) {
+					++length;
+				}
+				return length;
+			}
+
+			for (const auto &[dx, dy] : neighbors) {
+				const Position pos(n->x + dx, n->y + dy, from.z);
+				if (pos.x < REGION_X || pos.y < REGION_Y || pos.x >= REGION_X + REGION_SIZE || pos.y >= REGION_Y + REGION_SIZE) {
+					continue;
+				}
+				if (blocked[(pos.y - REGION_Y) * REGION_SIZE + (pos.x - REGION_X)]) {
+					continue;
+				}
+
+				const int_fast32_t newf = n->f + AStarNodes::getMapWalkCost(n, pos);
+				AStarNode* neighborNode = nodes.getNodeByPosition(pos.x, pos.y);
+				if (neighborNode) {
+					if (neighborNode->f <= newf) {
+						continue;
+					}
+					neighborNode->f = newf;
+					neighborNode->parent = n;
+					nodes.openNode(neighborNode);
+				} else if (!nodes.createOpenNode(n, pos.x, pos.y, newf)) {
+					return 0;
+				}
+			}
+
+			nodes.closeNode(n);
+		}
+		return 0;
+	}
+
+	template <typename Nodes>
+	void benchmarkSearches(std::string_view name, const std::vector<bool> &blocked, const std::vector<std::pair<Position, Position>> &searches, int32_t maxNodes) {
+		Benchmark bm;
+		size_t found = 0;
+		size_t steps = 0;
+		for (const auto &[from, to] : searches) {
+			if (const auto length = findPath<Nodes>(blocked, from, to, maxNodes)) {
+				++found;
+				steps += length;
+			}
+		}
+
+		fmt::print("[{}] {} searches, {} nodes limit: {:.2f} ms, {} paths found ({} steps)\n", name, searches.size(), maxNodes, bm.duration(), found, steps);
+	}
+}
+
+suite<"benchmark"> pathfindingBenchmark = [] {
+	std::mt19937 random { 42 };
+	const auto blocked = makeRegion(random);
+
+	// monster chases are mostly short, with some targets around a wall or across the screen
+	std::vector<std::pair<Position, Position>> searches;
+	while (searches.size() < SEARCHES) {
+		const Position from(REGION_X + random() % REGION_SIZE, REGION_Y + random() % REGION_SIZE, 7);
+		const Position to(
+			std::clamp<int>(from.x + static_cast<int>(random() % 17) - 8, REGION_X, REGION_X + REGION_SIZE - 1),
+			std::clamp<int>(from.y + static_cast<int>(random() % 13) - 6, REGION_Y, REGION_Y + REGION_SIZE - 1),
+			7
+		);
+		if (!blocked[(from.y - REGION_Y) * REGION_SIZE + (from.x - REGION_X)] && !blocked[(to.y - REGION_Y) * REGION_SIZE + (to.x - REGION_X)]) {
+			searches.emplace_back(from, to);
+		}
+	}
+
+	for (const auto maxNodes : { AStarNodes::DEFAULT_MAX_NODES, 2048, 8192 }) {
+		test(fmt::format("pathfinding {} nodes", maxNodes)) = [&blocked, &searches, maxNodes] {
+			benchmarkSearches<LinearNodes>("linear scan", blocked, searches, maxNodes);
+			benchmarkSearches<AStarNodes>("binary heap", blocked, searches, maxNodes);
+		};
+	}
+};
@@ -0,0 +1,154 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/creature.hpp"
+#include "creatures/players/player.hpp"
+#include "game/game.hpp"
+#include "map/spectators.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t AREA_X = 1000;
+	constexpr uint16_t AREA_Y = 1000;
+	constexpr uint16_t AREA_SIZE = 256;
+	constexpr uint8_t AREA_MIN_Z = 6;
+	constexpr uint8_t AREA_MAX_Z = 8;
+	constexpr size_t CREATURES = 40000;
+	constexpr size_t PLAYERS = 4000;
+	constexpr size_t LOOKUPS = 20000;
+
+	class BenchmarkCreature final : public Creature {
+	public:
+		const std::string &getName() const override {
+			return name;
+		}
+		const std::string &getTypeName() const override {
+			return name;
+		}
+		const std::string &getNameDescription() const override {
+			return name;
+		}
+		std::string getDescription(int32_t) override {
+			return name;
+		}
+		CreatureType_t getType() const override {
+			return CREATURETYPE_MONSTER;
+		}
+		void setID() override { }
+		void removeList() override { }
+		void addList() override { }
+
+	private:
+		const std::string name = "benchmark";
+	};
+
+	Position randomPosition(std::mt19937 &random) {
+		return Position(
+			static_cast<uint16_t>(AREA_X + random() % AREA_SIZE),
+			static_cast<uint16_t>(AREA_Y + random() % AREA_SIZE),
+			static_cast<uint8_t>(AREA_MIN_Z + random() % (AREA_MAX_Z - AREA_MIN_Z + 1))
+		);
+	}
+
+	template <typename T>
+	void benchmarkFind(const std::vector<Position> &centers, bool multifloor) {
+		Benchmark bm;
+		size_t found = 0;
+		for (const auto &center : centers) {
+			// measure the quadtree walk, not the cache
+			Spectators::clearCache();
+			found += Spectators().find<T>(center, multifloor).size();
+		}
+
+		fmt::print("[find<{}>] {} lookups{}: {:.2f} ms, {} spectators found\n", std::is_same_v<T, Player> ? "Player" : "Creature", centers.size(), multifloor ? " (multifloor)" : "", bm.duration(), found);
+	}
+
+	// Runs the leaf range test of every lookup with the given kernel, over the leaves a find would walk
+	template <typename Kernel>
+	size_t benchmarkKernel(const std::string &name, const std::vector<Position> &centers, bool onlyPlayers, Kernel &&kernel) {
+		std::vector<std::shared_ptr<Creature>> out;
+		size_t found = 0;
+		double elapsed = 0;
+		for (const auto &center : centers) {
+			const int32_t minX = center.x - MAP_MAX_VIEW_PORT_X;
+			const int32_t maxX = center.x + MAP_MAX_VIEW_PORT_X;
+			const int32_t minY = center.y - MAP_MAX_VIEW_PORT_Y;
+			const int32_t maxY = center.y + MAP_MAX_VIEW_PORT_Y;
+			// the floor offset shifts the bounds by up to the floors in range
+			const int32_t margin = AREA_MAX_Z - AREA_MIN_Z;
+
+			out.clear();
+			Benchmark bm;
+			for (int32_t y = (minY - margin) & ~(FLOOR_SIZE - 1); y <= maxY + margin; y += FLOOR_SIZE) {
+				for (int32_t x = (minX - margin) & ~(FLOOR_SIZE - 1); x <= maxX + margin; x += FLOOR_SIZE) {
+					if (const auto leaf = g_game().map.getQTNode(static_cast<uint16_t>(x), static_cast<uint16_t>(y))) {
+						kernel(leaf, out, onlyPlayers, center.z, AREA_MIN_Z, AREA_MAX_Z, minX, maxX, minY, maxY);
+					}
+				}
+			}
+			elapsed += bm.duration();
+			found += out.size();
+		}
+
+		fmt::print("[{}] {} {} lookups: {:.2f} ms, {} spectators found\n", name, centers.size(), onlyPlayers ? "player" : "creature", elapsed, found);
+		return found;
+	}
+
+	size_t benchmarkScalar(const std::vector<Position> &centers, bool onlyPlayers) {
+		return benchmarkKernel("scalar range test", centers, onlyPlayers, [](const QTreeLeafNode* leaf, auto &&... args) {
+			leaf->findCreaturesScalar(args...);
+		});
+	}
+
+	size_t benchmarkVectorized(const std::vector<Position> &centers, bool onlyPlayers) {
+		return benchmarkKernel("vectorized range test", centers, onlyPlayers, [](const QTreeLeafNode* leaf, auto &&... args) {
+			leaf->findCreatures(args...);
+		});
+	}
+}
+
+suite<"benchmark"> spectatorsBenchmark = [] {
+	// a dense hunting area, every creature is a candidate of the leaves it is in
+	std::mt19937 random { 42 };
+	std::vector<std::shared_ptr<Creature>> creatures;
+	creatures.reserve(CREATURES);
+	for (size_t i = 0; i < CREATURES; ++i) {
+		const auto pos = randomPosition(random);
+		const auto &tile = g_game().map.getOrCreateTile(pos);
+		const auto creature = std::make_shared<BenchmarkCreature>();
+		tile->internalAddThing(creature);
+		g_game().map.getQTNode(pos.x, pos.y)->addCreature(creature);
+		creatures.emplace_back(creature);
+	}
+
+	// players go to the player lists as well, so find<Player> has something to filter
+	static Group group;
+	for (size_t i = 0; i < PLAYERS; ++i) {
+		const auto pos = randomPosition(random);
+		const auto player = std::make_shared<Player>(nullptr);
+		player->setGroup(&group);
+		g_game().map.getOrCreateTile(pos)->internalAddThing(player);
+		g_game().map.getQTNode(pos.x, pos.y)->addCreature(player);
+		creatures.emplace_back(player);
+	}
+
+	std::vector<Position> centers(LOOKUPS);
+	std::ranges::generate(centers, [&random] { return randomPosition(random); });
+
+	test("spectators find<Creature>") = [&centers] {
+		benchmarkFind<Creature>(centers, false);
+		benchmarkFind<Creature>(centers, true);
+	};
+
+	test("spectators find<Player>") = [&centers] {
+		benchmarkFind<Player>(centers, false);
+		benchmarkFind<Player>(centers, true);
+	};
+
+	test("spectators leaf range test, scalar against vectorized") = [&centers] {
+		expect(eq(benchmarkScalar(centers, false), benchmarkVectorized(centers, false)));
+		expect(eq(benchmarkScalar(centers, true), benchmarkVectorized(centers, true)));
+	};
+};
@@ -0,0 +1,40 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "security/xtea.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// a full packet and a typical small one, encrypted over and over
+	constexpr std::array<size_t, 2> SIZES = { 24592, 256 };
+	constexpr size_t TOTAL_BYTES = 256 * 1024 * 1024;
+}
+
+suite<"benchmark"> xteaBenchmark = [] {
+	const auto keys = xtea::expandEncryptKey({ 0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210 });
+
+	for (const auto implementation : { xtea::Implementation::Scalar, xtea::Implementation::SSE2, xtea::Implementation::AVX2 }) {
+		if (!xtea::isSupported(implementation)) {
+			fmt::print("[xtea {}] not supported\n", xtea::getImplementationName(implementation));
+			continue;
+		}
+
+		test(fmt::format("xtea {}", xtea::getImplementationName(implementation))) = [&keys, implementation] {
+			for (const auto size : SIZES) {
+				std::vector<uint8_t> data(size, 0x5A);
+				const size_t iterations = TOTAL_BYTES / size;
+
+				Benchmark bm;
+				for (size_t i = 0; i < iterations; ++i) {
+					xtea::encrypt(data.data(), data.size(), keys, implementation);
+				}
+				const auto elapsed = bm.duration();
+
+				const auto megabytes = static_cast<double>(iterations * size) / (1024. * 1024.);
+				fmt::print("[xtea {}] {} byte messages: {:.2f} ms, {:.1f} MB/s\n", xtea::getImplementationName(implementation), size, elapsed, megabytes * 1000. / elapsed);
+			}
+		};
+	}
+};
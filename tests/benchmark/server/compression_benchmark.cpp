@@ -0,0 +1,127 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/protocol/packet_compressor.hpp"
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr size_t ROUNDS = 20;
+
+	/**
+	 * Packets captured to a directory (one raw, unencrypted body per file) can be given in
+	 * CANARY_PACKET_CORPUS, otherwise a mix shaped like the usual game traffic is generated.
+	 */
+	std::vector<std::vector<uint8_t>> loadCorpus() {
+		std::vector<std::vector<uint8_t>> corpus;
+		if (const char* path = std::getenv("CANARY_PACKET_CORPUS")) {
+			for (const auto &entry : std::filesystem::directory_iterator(path)) {
+				std::ifstream file(entry.path(), std::ios::binary);
+				std::vector<uint8_t> packet { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+				if (!packet.empty() && packet.size() <= NETWORKMESSAGE_MAXSIZE) {
+					corpus.emplace_back(std::move(packet));
+				}
+			}
+			fmt::print("[compression] {} packets from {}\n", corpus.size(), path);
+			return corpus;
+		}
+
+		std::mt19937 random { 11 };
+		for (size_t i = 0; i < 2000; ++i) {
+			std::vector<uint8_t> packet;
+			switch (i % 10) {
+				case 0: {
+					// map description: a few ground and item ids with skips between them
+					packet.resize(4000 + random() % 12000);
+					for (size_t j = 0; j < packet.size(); j += 4) {
+						const uint16_t id = 100 + random() % 24;
+						memcpy(packet.data() + j, &id, std::min<size_t>(2, packet.size() - j));
+						for (size_t k = j + 2; k < std::min(j + 4, packet.size()); ++k) {
+							packet[k] = 0xFF;
+						}
+					}
+					break;
+				}
+				case 1:
+				case 2: {
+					// chat and text windows
+					static constexpr std::string_view text = "You see a brass armor (Arm:8). It weighs 80.00 oz. ";
+					packet.resize(200 + random() % 800);
+					for (size_t j = 0; j < packet.size(); ++j) {
+						packet[j] = static_cast<uint8_t>(text[(j + random() % 3) % text.size()]);
+					}
+					break;
+				}
+				case 3: {
+					// already dense data, as images or other compressed blobs
+					packet.resize(1000 + random() % 3000);
+					for (auto &byte : packet) {
+						byte = static_cast<uint8_t>(random());
+					}
+					break;
+				}
+				default: {
+					// creature moves, health and effects batched per cycle
+					packet.resize(128 + random() % 512);
+					for (size_t j = 0; j < packet.size(); ++j) {
+						packet[j] = j % 8 < 3 ? static_cast<uint8_t>(0x6D + j % 8) : static_cast<uint8_t>(random() % 16);
+					}
+					break;
+				}
+			}
+			corpus.emplace_back(std::move(packet));
+		}
+		return corpus;
+	}
+}
+
+suite<"benchmark"> compressionBenchmark = [] {
+	const auto corpus = loadCorpus();
+	size_t inputBytes = 0;
+	for (const auto &packet : corpus) {
+		inputBytes += packet.size();
+	}
+	const auto megabytes = static_cast<double>(inputBytes * ROUNDS) / (1024. * 1024.);
+
+	test(fmt::format("compression {}", PacketCompressor::getBackendName())) = [&corpus, inputBytes, megabytes] {
+		for (const int32_t level : { 1, 3, 6, 9 }) {
+			PacketCompressor compressor(level);
+			size_t outputBytes = 0;
+			size_t compressed = 0;
+
+			Benchmark bm;
+			for (size_t round = 0; round < ROUNDS; ++round) {
+				for (const auto &packet : corpus) {
+					// as Protocol::compression, packets that do not shrink are sent as they are
+					const auto result = compressor.compress(packet.data(), packet.size());
+					if (round == 0) {
+						outputBytes += result.empty() ? packet.size() : result.size();
+						compressed += result.empty() ? 0 : 1;
+					}
+				}
+			}
+			const auto elapsed = bm.duration();
+
+			fmt::print(
+				"[compression {} level {}] ratio {:.3f}, {}/{} packets compressed, {:.2f} ms, {:.1f} MB/s\n",
+				PacketCompressor::getBackendName(), level,
+				static_cast<double>(outputBytes) / static_cast<double>(inputBytes), compressed, corpus.size(),
+				elapsed, megabytes * 1000. / elapsed
+			);
+		}
+	};
+
+	test("compression adlerChecksum") = [&corpus, megabytes] {
+		uint32_t checksum = 0;
+		Benchmark bm;
+		for (size_t round = 0; round < ROUNDS; ++round) {
+			for (const auto &packet : corpus) {
+				checksum ^= adlerChecksum(packet.data(), packet.size());
+			}
+		}
+		const auto elapsed = bm.duration();
+		fmt::print("[adlerChecksum] {:.2f} ms, {:.1f} MB/s ({:08x})\n", elapsed, megabytes * 1000. / elapsed, checksum);
+	};
+};
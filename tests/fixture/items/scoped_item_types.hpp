@@ -0,0 +1,59 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2022 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#pragma once
+
+#include "items/item.hpp"
+#include "items/items.hpp"
+
+/**
+ * Registers item types in the process-wide table for as long as it lives, then puts the
+ * table back: the types it replaced are restored and a table that was empty is emptied again,
+ * so the types of one suite do not leak into the next.
+ */
+class ScopedItemTypes {
+public:
+	ScopedItemTypes() :
+		initialSize(Item::items.size()) { }
+
+	~ScopedItemTypes() {
+		for (auto &[id, previous] : replaced) {
+			Item::items.getItemType(id) = std::move(previous);
+		}
+
+		if (initialSize == 0) {
+			Item::items.clear();
+		}
+	}
+
+	// non-copyable
+	ScopedItemTypes(const ScopedItemTypes &) = delete;
+	ScopedItemTypes &operator=(const ScopedItemTypes &) = delete;
+
+	// Makes every id up to maxId safe to look up, unregistered ones are default types
+	void reserve(uint16_t maxId) {
+		if (maxId >= Item::items.size()) {
+			// a node without attributes only grows the table
+			Item::items.parseItemNode(pugi::xml_node(), maxId);
+		}
+	}
+
+	// A fresh type at id, for the test to fill in
+	ItemType &add(uint16_t id) {
+		reserve(id);
+		auto &type = Item::items.getItemType(id);
+		replaced.try_emplace(id, std::move(type));
+		type = ItemType {};
+		type.id = id;
+		return type;
+	}
+
+private:
+	size_t initialSize;
+	std::map<uint16_t, ItemType> replaced;
+};
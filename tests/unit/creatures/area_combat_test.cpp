@@ -0,0 +1,54 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/combat/combat.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	const Position caster { 100, 100, 7 };
+
+	std::vector<std::pair<int, int>> offsetsTowards(const AreaCombat &area, int dx, int dy) {
+		const Position target(static_cast<uint16_t>(caster.x + dx), static_cast<uint16_t>(caster.y + dy), caster.z);
+		std::vector<std::pair<int, int>> offsets;
+		for (const auto &offset : area.getOffsets(caster, target)) {
+			offsets.emplace_back(offset.x, offset.y);
+		}
+		std::ranges::sort(offsets);
+		return offsets;
+	}
+}
+
+suite<"creatures"> areaCombatTest = [] {
+	test("AreaCombat compiles a beam for every direction") = [] {
+		AreaCombat area;
+		area.setupArea(3, 0);
+
+		expect(eq(offsetsTowards(area, 0, -1), std::vector<std::pair<int, int>> { { 0, -2 }, { 0, -1 }, { 0, 0 } }));
+		expect(eq(offsetsTowards(area, 0, 1), std::vector<std::pair<int, int>> { { 0, 0 }, { 0, 1 }, { 0, 2 } }));
+		expect(eq(offsetsTowards(area, 1, 0), std::vector<std::pair<int, int>> { { 0, 0 }, { 1, 0 }, { 2, 0 } }));
+		expect(eq(offsetsTowards(area, -1, 0), std::vector<std::pair<int, int>> { { -2, 0 }, { -1, 0 }, { 0, 0 } }));
+	};
+
+	test("AreaCombat compiles a circle around the target") = [] {
+		AreaCombat area;
+		area.setupArea(2);
+
+		const std::vector<std::pair<int, int>> cross { { -1, 0 }, { 0, -1 }, { 0, 0 }, { 0, 1 }, { 1, 0 } };
+		expect(eq(offsetsTowards(area, 0, -1), cross));
+		expect(eq(offsetsTowards(area, -1, 0), cross));
+	};
+
+	test("AreaCombat keeps its offsets when cloned and drops them when cleared") = [] {
+		AreaCombat area;
+		area.setupArea(3, 0);
+
+		const auto clone = area.clone();
+		expect(eq(offsetsTowards(*clone, 0, 1), offsetsTowards(area, 0, 1)));
+
+		area.clear();
+		expect(offsetsTowards(area, 0, 1).empty());
+		expect(eq(offsetsTowards(*clone, 0, 1).size(), 3u));
+	};
+};
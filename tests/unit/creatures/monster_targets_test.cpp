@@ -0,0 +1,211 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "creatures/monsters/monster.hpp"
+#include "creatures/monsters/monsters.hpp"
+#include "creatures/players/player.hpp"
+#include "game/game.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// a quiet corner of the map, every test places its own creatures
+	constexpr uint16_t AREA_X = 5000;
+	constexpr uint16_t AREA_Y = 5000;
+	constexpr uint8_t AREA_Z = 11;
+
+	Group &group() {
+		static Group group;
+		return group;
+	}
+
+	void place(const std::shared_ptr<Creature> &creature, const Position &pos) {
+		g_game().map.getOrCreateTile(pos)->internalAddThing(creature);
+		g_game().map.getQTNode(pos.x, pos.y)->addCreature(creature);
+		creature->setID();
+	}
+
+	void remove(const std::shared_ptr<Creature> &creature) {
+		const Position pos = creature->getPosition();
+		g_game().map.getQTNode(pos.x, pos.y)->removeCreature(creature);
+		g_game().map.getTile(pos)->removeThing(creature, 0);
+	}
+
+	// What Map::moveCreature does to the tiles and the quadtree, the others stand still so nobody needs to be told
+	void step(const std::shared_ptr<Creature> &creature, const Position &toPos) {
+		auto &map = g_game().map;
+		const Position fromPos = creature->getPosition();
+		map.getTile(fromPos)->removeThing(creature, 0);
+
+		const auto fromLeaf = map.getQTNode(fromPos.x, fromPos.y);
+		const auto toLeaf = map.getQTNode(toPos.x, toPos.y);
+		if (fromLeaf != toLeaf) {
+			fromLeaf->removeCreature(creature);
+			toLeaf->addCreature(creature);
+		}
+
+		map.getOrCreateTile(toPos)->internalAddThing(creature);
+		toLeaf->updateCreature(creature);
+	}
+
+	struct Lists {
+		std::set<uint32_t> targets;
+		std::set<uint32_t> friends;
+
+		bool operator==(const Lists &) const = default;
+	};
+
+	Lists lists(const std::shared_ptr<Monster> &monster) {
+		Lists result;
+		for (const auto &target : monster->getTargetList()) {
+			result.targets.insert(target->getID());
+		}
+		for (const auto &creature : monster->getFriendList()) {
+			result.friends.insert(creature->getID());
+		}
+		return result;
+	}
+
+	struct Crowd {
+		std::vector<std::shared_ptr<Monster>> monsters;
+		std::vector<std::shared_ptr<Player>> players;
+
+		~Crowd() {
+			for (const auto &monster : monsters) {
+				// out of the creature checks a woken monster joined
+				monster->setIdle(true);
+				remove(monster);
+			}
+			for (const auto &player : players) {
+				remove(player);
+			}
+		}
+	};
+
+	// monsters and players spread over a few screens, with one player in the middle that never leaves the view of the subject
+	void populate(Crowd &crowd, std::mt19937 &random) {
+		const auto monsterType = std::make_shared<MonsterType>("target list test");
+		const auto randomPosition = [&random] {
+			return Position(static_cast<uint16_t>(AREA_X + random() % 64), static_cast<uint16_t>(AREA_Y + random() % 64), AREA_Z);
+		};
+
+		for (size_t i = 0; i < 120; ++i) {
+			const auto monster = std::make_shared<Monster>(monsterType);
+			place(monster, randomPosition());
+			crowd.monsters.emplace_back(monster);
+		}
+
+		for (uint32_t i = 0; i < 20; ++i) {
+			const auto player = std::make_shared<Player>(nullptr);
+			player->setGroup(&group());
+			player->setGUID(i + 1);
+			place(player, i == 0 ? Position(AREA_X + 32, AREA_Y + 32, AREA_Z) : randomPosition());
+			crowd.players.emplace_back(player);
+		}
+	}
+}
+
+suite<"creatures"> monsterTargetsTest = [] {
+	test("Monster::updateTargetList after a step finds what a full rescan finds") = [] {
+		std::mt19937 random { 42 };
+		Crowd crowd;
+		populate(crowd, random);
+
+		const auto &subject = crowd.monsters.front();
+		subject->rebuildTargetList();
+
+		size_t mismatches = 0;
+		for (int i = 0; i < 200; ++i) {
+			const Position oldPos = subject->getPosition();
+			// kept within a screen of the middle player, so it always has a target and never goes idle
+			const Position next(
+				static_cast<uint16_t>(std::clamp<int32_t>(oldPos.x + static_cast<int32_t>(random() % 3) - 1, AREA_X + 32 - 6, AREA_X + 32 + 6)),
+				static_cast<uint16_t>(std::clamp<int32_t>(oldPos.y + static_cast<int32_t>(random() % 3) - 1, AREA_Y + 32 - 4, AREA_Y + 32 + 4)),
+				AREA_Z
+			);
+			step(subject, next);
+
+			subject->updateTargetList(oldPos);
+			const auto band = lists(subject);
+			subject->rebuildTargetList();
+			if (band != lists(subject)) {
+				++mismatches;
+			}
+		}
+
+		expect(eq(mismatches, 0u));
+		expect(!lists(subject).targets.empty());
+	};
+
+	test("Monster finds what is in view again when it wakes up") = [] {
+		std::mt19937 random { 7 };
+		Crowd crowd;
+		populate(crowd, random);
+
+		const auto &subject = crowd.monsters.front();
+		step(subject, Position(AREA_X + 33, AREA_Y + 32, AREA_Z));
+		subject->rebuildTargetList();
+		const auto awake = lists(subject);
+		expect(!awake.targets.empty());
+
+		subject->setIdle(true);
+		expect(lists(subject).targets.empty());
+		expect(lists(subject).friends.empty());
+
+		// nobody moves, so nothing comes into view to tell it
+		subject->setIdle(false);
+		expect(lists(subject) == awake);
+	};
+
+	test("Monster takes the side of its new master") = [] {
+		std::mt19937 random { 11 };
+		Crowd crowd;
+		populate(crowd, random);
+
+		const auto &master = crowd.players.front();
+		const auto &subject = crowd.monsters.front();
+		step(subject, Position(AREA_X + 33, AREA_Y + 32, AREA_Z));
+		subject->rebuildTargetList();
+		expect(lists(subject).targets.contains(master->getID()));
+
+		// a summon of a player fights everyone in view but its master
+		subject->setMaster(master);
+		const auto summoned = lists(subject);
+		expect(!summoned.targets.contains(master->getID()));
+		expect(summoned.friends.contains(master->getID()));
+
+		subject->rebuildTargetList();
+		expect(lists(subject) == summoned);
+
+		subject->setMaster(nullptr);
+		expect(lists(subject).targets.contains(master->getID()));
+	};
+
+	test("Monster sorts a neighbour again when its master changes") = [] {
+		std::mt19937 random { 13 };
+		Crowd crowd;
+		populate(crowd, random);
+
+		const auto &master = crowd.players.front();
+		const auto &subject = crowd.monsters[0];
+		const auto &watcher = crowd.monsters[1];
+		step(subject, Position(AREA_X + 33, AREA_Y + 32, AREA_Z));
+		step(watcher, Position(AREA_X + 34, AREA_Y + 33, AREA_Z));
+		watcher->rebuildTargetList();
+		expect(lists(watcher).friends.contains(subject->getID()));
+
+		// convinced by a player, it is an opponent of the wild monsters that watch it without stepping
+		subject->setMaster(master);
+		const auto convinced = lists(watcher);
+		expect(convinced.targets.contains(subject->getID()));
+		expect(!convinced.friends.contains(subject->getID()));
+
+		watcher->rebuildTargetList();
+		expect(lists(watcher) == convinced);
+
+		subject->setMaster(nullptr);
+		expect(lists(watcher).friends.contains(subject->getID()));
+		expect(!lists(watcher).targets.contains(subject->getID()));
+	};
+};
@@ -0,0 +1,158 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "game/scheduling/think_scheduler.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// Advanced by the thinks, so the measured costs are exact
+	struct FakeClock {
+		using duration = std::chrono::nanoseconds;
+		using rep = duration::rep;
+		using period = duration::period;
+		using time_point = std::chrono::time_point<FakeClock>;
+		static constexpr bool is_steady = true;
+
+		static inline time_point current {};
+
+		static time_point now() {
+			return current;
+		}
+	};
+
+	using Scheduler = ThinkScheduler<int, FakeClock>;
+
+	std::vector<int> runRound(Scheduler &scheduler, const std::function<void(int)> &think = nullptr) {
+		std::vector<int> visited;
+		for (size_t i = 0; i < scheduler.bucketCount(); ++i) {
+			scheduler.runNext([&](int value, uint32_t) {
+				visited.emplace_back(value);
+				if (think) {
+					think(value);
+				}
+			});
+		}
+		std::ranges::sort(visited);
+		return visited;
+	}
+}
+
+suite<"game"> thinkSchedulerTest = [] {
+	test("ThinkScheduler visits every entry once per round") = [] {
+		Scheduler scheduler { 4 };
+		for (int i = 1; i <= 10; ++i) {
+			scheduler.add(i);
+		}
+
+		expect(eq(runRound(scheduler), std::vector { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }));
+		expect(eq(runRound(scheduler).size(), 10));
+		expect(eq(scheduler.getStats().rounds, 2));
+	};
+
+	test("ThinkScheduler never visits removed entries") = [] {
+		Scheduler scheduler { 2 };
+		std::vector<uint32_t> handles;
+		for (int i = 1; i <= 6; ++i) {
+			handles.emplace_back(scheduler.add(i));
+		}
+
+		scheduler.remove(handles[1]);
+		scheduler.remove(handles[1]);
+		expect(!scheduler.contains(handles[1]));
+		expect(eq(scheduler.size(), 5));
+
+		// removing while running, the rest of the bucket and the other bucket
+		const auto visited = runRound(scheduler, [&](int value) {
+			if (value == 1) {
+				scheduler.remove(handles[2]);
+				scheduler.remove(handles[3]);
+			}
+		});
+		expect(std::ranges::find(visited, 2) == visited.end());
+		expect(eq(scheduler.size(), 3));
+		expect(eq(runRound(scheduler).size(), 3));
+	};
+
+	test("ThinkScheduler leaves entries added while running for the next round") = [] {
+		Scheduler scheduler { 1 };
+		scheduler.add(1);
+
+		expect(eq(runRound(scheduler, [&](int value) { scheduler.add(value + 1); }), std::vector { 1 }));
+		expect(eq(runRound(scheduler), std::vector { 1, 2 }));
+	};
+
+	test("ThinkScheduler balances the buckets by measured cost") = [] {
+		Scheduler scheduler { 2 };
+		// the first ones cost nothing when added, so the expensive ones can share a bucket
+		for (int i = 0; i < 8; ++i) {
+			scheduler.add(i);
+		}
+
+		const auto think = [](int value) {
+			FakeClock::current += std::chrono::microseconds(value % 2 == 0 ? 1000 : 10);
+		};
+		for (int round = 0; round < 20; ++round) {
+			runRound(scheduler, think);
+		}
+
+		const auto stats = scheduler.getStats();
+		expect(gt(stats.moves, 0));
+		const auto heaviest = std::max(stats.buckets[0].cost, stats.buckets[1].cost);
+		const auto lightest = std::min(stats.buckets[0].cost, stats.buckets[1].cost);
+		// within the cost of one expensive entry
+		expect(le(heaviest - lightest, 1000000u));
+		expect(eq(stats.buckets[0].entries + stats.buckets[1].entries, 8u));
+	};
+
+	test("ThinkScheduler places new entries in the lightest bucket") = [] {
+		Scheduler scheduler { 2 };
+		scheduler.add(1);
+		scheduler.add(2);
+		runRound(scheduler, [](int value) {
+			FakeClock::current += std::chrono::microseconds(value == 1 ? 800 : 8);
+		});
+
+		const auto before = scheduler.getStats();
+		const size_t light = before.buckets[0].cost < before.buckets[1].cost ? 0 : 1;
+		scheduler.add(3);
+		expect(eq(scheduler.getStats().buckets[light].entries, 2u));
+	};
+
+	test("ThinkScheduler tells moved entries how long they waited") = [] {
+		Scheduler scheduler { 4 };
+		for (int i = 0; i < 12; ++i) {
+			scheduler.add(i);
+		}
+
+		// per entry, the checks it was told summed and the runs of its first and last think
+		struct Waited {
+			uint64_t told = 0;
+			uint64_t first = 0;
+			uint64_t last = 0;
+		};
+		std::map<int, Waited> waited;
+		uint64_t check = 0;
+		for (int run = 0; run < 200; ++run, ++check) {
+			scheduler.runNext([&](int value, uint32_t checks) {
+				FakeClock::current += std::chrono::microseconds(value % 4 == 0 ? 900 : 20);
+				auto &entry = waited[value];
+				if (entry.told == 0) {
+					entry.first = check;
+				}
+				entry.told += checks;
+				entry.last = check;
+			});
+		}
+
+		expect(gt(scheduler.getStats().moves, 0));
+		size_t mismatches = 0;
+		for (const auto &[value, entry] : waited) {
+			// the first think is told a whole round, every later one the runs since the one before
+			mismatches += entry.told != entry.last - entry.first + scheduler.bucketCount();
+		}
+		expect(eq(waited.size(), 12u));
+		expect(eq(mismatches, 0u));
+	};
+};
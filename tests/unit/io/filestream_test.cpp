@@ -0,0 +1,35 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "io/filestream.hpp"
+#include "io/fileloader.hpp"
+
+using namespace boost::ut;
+
+suite<"io"> fileStreamTest = [] {
+	test("FileStream reads escaped values inside nodes") = [] {
+		// a node of type 1 with a u32 whose bytes 0xFD and 0xFE are escaped, then a u16
+		const std::vector<char> data = {
+			char(0xFE), char(0x01),
+			char(0xFD), char(0xFD), 0x01, char(0xFD), char(0xFE), 0x02,
+			0x34, 0x12,
+			char(0xFF)
+		};
+		FileStream stream { data.data(), data.data() + data.size() };
+
+		expect(stream.startNode(1));
+		expect(eq(stream.getU32(), 0x02FE01FDu));
+		expect(eq(stream.getU16(), 0x1234));
+		expect(stream.endNode());
+		expect(eq(stream.tell(), static_cast<uint32_t>(data.size())));
+	};
+
+	test("FileStream does not read past the end of an escaped value") = [] {
+		const std::vector<char> data = { char(0xFE), char(0x01), 0x01, char(0xFD) };
+		FileStream stream { data.data(), data.data() + data.size() };
+
+		expect(stream.startNode(1));
+		expect(throws([&stream] { stream.getU16(); }));
+	};
+};
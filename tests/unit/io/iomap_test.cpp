@@ -0,0 +1,277 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "io/filestream.hpp"
+#include "io/iomap.hpp"
+#include "items/scoped_item_types.hpp"
+#include "map/map.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	class OtbmWriter {
+	public:
+		void startNode(uint8_t type) {
+			data.push_back(static_cast<char>(OTB::Node::START));
+			data.push_back(static_cast<char>(type));
+		}
+
+		void endNode() {
+			data.push_back(static_cast<char>(OTB::Node::END));
+		}
+
+		template <typename T>
+		void add(T value) {
+			for (size_t i = 0; i < sizeof(T); ++i) {
+				const auto byte = static_cast<uint8_t>(value >> (i * 8));
+				if (byte >= OTB::Node::ESCAPE) {
+					data.push_back(static_cast<char>(OTB::Node::ESCAPE));
+				}
+				data.push_back(static_cast<char>(byte));
+			}
+		}
+
+		void addString(const std::string &value) {
+			add<uint16_t>(static_cast<uint16_t>(value.size()));
+			data.insert(data.end(), value.begin(), value.end());
+		}
+
+		std::vector<char> data;
+	};
+
+	void writeItem(OtbmWriter &writer, std::mt19937 &random, int depth) {
+		writer.startNode(OTBM_ITEM);
+		writer.add<uint16_t>(static_cast<uint16_t>(100 + random() % 100));
+		if (random() % 2 == 0) {
+			// values with bytes that have to be escaped
+			writer.add<uint8_t>(OTBM_ATTR_ACTION_ID);
+			writer.add<uint16_t>(static_cast<uint16_t>(0xFD00 + random() % 0x300));
+		}
+		if (random() % 4 == 0) {
+			writer.add<uint8_t>(OTBM_ATTR_TEXT);
+			writer.addString(fmt::format("text {}", random() % 8));
+		}
+		if (depth < 2 && random() % 4 == 0) {
+			writeItem(writer, random, depth + 1);
+		}
+		writer.endNode();
+	}
+
+	std::vector<char> generateMap() {
+		std::mt19937 random { 7 };
+		OtbmWriter writer;
+		writer.startNode(OTBM_MAP_DATA);
+		for (uint16_t area = 0; area < 64; ++area) {
+			writer.startNode(OTBM_TILE_AREA);
+			writer.add<uint16_t>(static_cast<uint16_t>(1000 + (area % 8) * 256));
+			writer.add<uint16_t>(static_cast<uint16_t>(1000 + (area / 8) * 256));
+			writer.add<uint8_t>(7);
+
+			for (uint16_t i = 0; i < 256; i += 1 + random() % 3) {
+				const bool house = random() % 16 == 0;
+				writer.startNode(house ? OTBM_HOUSETILE : OTBM_TILE);
+				writer.add<uint8_t>(static_cast<uint8_t>(i % 16));
+				writer.add<uint8_t>(static_cast<uint8_t>(i / 16));
+				if (house) {
+					writer.add<uint32_t>(1 + random() % 4);
+				}
+				if (random() % 3 == 0) {
+					writer.add<uint8_t>(OTBM_ATTR_TILE_FLAGS);
+					writer.add<uint32_t>(random() % 32);
+				}
+				if (random() % 2 == 0) {
+					writer.add<uint8_t>(OTBM_ATTR_ITEM);
+					writer.add<uint16_t>(static_cast<uint16_t>(100 + random() % 100));
+				}
+				for (uint32_t items = random() % 4; items > 0; --items) {
+					writeItem(writer, random, 0);
+				}
+				if (random() % 8 == 0) {
+					writer.startNode(OTBM_TILE_ZONE);
+					writer.add<uint16_t>(1);
+					writer.add<uint16_t>(static_cast<uint16_t>(1 + random() % 3));
+					writer.endNode();
+				}
+				writer.endNode();
+			}
+			writer.endNode();
+		}
+		writer.endNode();
+		return writer.data;
+	}
+
+	std::vector<IOMap::TileAreaChunk> decode(const std::vector<char> &data, size_t chunkSize, bool parallel) {
+		FileStream stream { data.data(), data.data() + data.size() };
+		expect(stream.startNode(OTBM_MAP_DATA));
+		auto chunks = IOMap::splitTileAreas(stream, chunkSize);
+		expect(stream.endNode());
+
+		std::vector<std::jthread> threads;
+		for (auto &chunk : chunks) {
+			if (parallel) {
+				threads.emplace_back([&stream, &chunk] { IOMap::decodeTileAreas(stream, Position(), chunk); });
+			} else {
+				IOMap::decodeTileAreas(stream, Position(), chunk);
+			}
+		}
+		threads.clear();
+		return chunks;
+	}
+
+	size_t countItems(const std::shared_ptr<BasicItem> &item) {
+		if (!item) {
+			return 0;
+		}
+
+		size_t count = 1;
+		for (const auto &child : item->items) {
+			count += countItems(child);
+		}
+		return count;
+	}
+
+	struct LoadedMap {
+		std::unique_ptr<Map> map = std::make_unique<Map>();
+		std::vector<Position> positions;
+		size_t items = 0;
+	};
+
+	// What the loader does with the decoded runs, applied one at a time in file order
+	LoadedMap load(const std::vector<char> &data, size_t chunkSize, bool parallel) {
+		LoadedMap loaded;
+		for (auto &chunk : decode(data, chunkSize, parallel)) {
+			for (const auto &[position, tile] : chunk.tiles) {
+				loaded.positions.emplace_back(position);
+				loaded.items += countItems(tile->ground);
+				for (const auto &item : tile->items) {
+					loaded.items += countItems(item);
+				}
+			}
+			IOMap::applyTileAreas(*loaded.map, chunk);
+		}
+		return loaded;
+	}
+
+	uint32_t cachedTileAt(Map &map, const Position &pos) {
+		const auto leaf = map.getQTNode(pos.x, pos.y);
+		if (!leaf || !leaf->getFloor(pos.z)) {
+			return 0;
+		}
+		return leaf->getFloor(pos.z)->getTileCache(pos.x, pos.y);
+	}
+
+	// The cached contents by value, with the items inside in brackets
+	std::string describeItem(const MapCache &cache, uint32_t index) {
+		if (index == 0) {
+			return "none";
+		}
+
+		const auto &item = cache.getCachedItem(index);
+		auto description = fmt::format("{} x{} aid {} '{}'", item.id, item.charges, item.actionId, cache.getCachedText(item.text));
+		for (const auto child : cache.getCachedItemList(item.firstChild, item.childCount)) {
+			description += fmt::format(" [{}]", describeItem(cache, child));
+		}
+		return description;
+	}
+
+	std::string describeTile(const MapCache &cache, uint32_t index) {
+		if (index == 0) {
+			return "none";
+		}
+
+		const auto &tile = cache.getCachedTile(index);
+		auto description = fmt::format("flags {} house {} ground {}", tile.flags, tile.houseId, describeItem(cache, tile.ground));
+		for (const auto item : cache.getCachedItemList(tile.firstItem, tile.itemCount)) {
+			description += fmt::format(", {}", describeItem(cache, item));
+		}
+		return description;
+	}
+}
+
+suite<"io"> ioMapTest = [] {
+	test("IOMap decodes the same tiles from parallel chunks as from the whole map") = [] {
+		// the loader looks item types up, make sure there is a table to look into
+		ScopedItemTypes itemTypes;
+		itemTypes.reserve(200);
+
+		const auto data = generateMap();
+		const auto serial = decode(data, std::numeric_limits<size_t>::max(), false);
+		const auto parallel = decode(data, 4096, true);
+		expect(eq(serial.size(), 1u));
+		expect(gt(parallel.size(), 8u));
+
+		std::vector<std::pair<Position, size_t>> serialTiles;
+		std::vector<std::pair<Position, uint16_t>> serialZones;
+		for (const auto &chunk : serial) {
+			for (const auto &[position, tile] : chunk.tiles) {
+				serialTiles.emplace_back(position, tile->hash());
+			}
+			serialZones.insert(serialZones.end(), chunk.zones.begin(), chunk.zones.end());
+		}
+
+		std::vector<std::pair<Position, size_t>> parallelTiles;
+		std::vector<std::pair<Position, uint16_t>> parallelZones;
+		for (const auto &chunk : parallel) {
+			expect(not chunk.error);
+			for (const auto &[position, tile] : chunk.tiles) {
+				parallelTiles.emplace_back(position, tile->hash());
+			}
+			parallelZones.insert(parallelZones.end(), chunk.zones.begin(), chunk.zones.end());
+		}
+
+		expect(gt(serialTiles.size(), 1000u));
+		expect(serialTiles == parallelTiles);
+		expect(serialZones == parallelZones);
+	};
+
+	test("IOMap builds the same map cache with parallel runs as with the serial loader") = [] {
+		ScopedItemTypes itemTypes;
+		itemTypes.reserve(200);
+
+		const auto data = generateMap();
+		// the whole map in one run, each tile applied right after the previous one on this thread
+		auto serial = load(data, std::numeric_limits<size_t>::max(), false);
+		auto parallel = load(data, 4096, true);
+		expect(serial.positions == parallel.positions);
+
+		const auto &serialCache = serial.map->getCache();
+		const auto &parallelCache = parallel.map->getCache();
+
+		size_t cached = 0;
+		size_t houseTiles = 0;
+		size_t mismatches = 0;
+		for (const auto &pos : serial.positions) {
+			const auto serialTile = cachedTileAt(*serial.map, pos);
+			const auto parallelTile = cachedTileAt(*parallel.map, pos);
+			if (serialTile != parallelTile || describeTile(serialCache, serialTile) != describeTile(parallelCache, parallelTile)) {
+				++mismatches;
+			}
+
+			cached += serialTile != 0;
+			houseTiles += serialTile != 0 && serialCache.getCachedTile(serialTile).isHouse();
+		}
+		expect(eq(mismatches, 0u));
+		expect(gt(cached, 1000u));
+		expect(gt(houseTiles, 0u));
+
+		std::set<uint32_t> serialHouses;
+		for (const auto &[id, house] : serial.map->houses.getHouses()) {
+			serialHouses.insert(id);
+		}
+		std::set<uint32_t> parallelHouses;
+		for (const auto &[id, house] : parallel.map->houses.getHouses()) {
+			parallelHouses.insert(id);
+		}
+		expect(!serialHouses.empty());
+		expect(serialHouses == parallelHouses);
+
+		// equal tiles and items are shared the same way, so both hold as many records
+		const auto serialReport = serialCache.getMemoryReport();
+		const auto parallelReport = parallelCache.getMemoryReport();
+		expect(eq(serialReport.tiles, parallelReport.tiles));
+		expect(eq(serialReport.items, parallelReport.items));
+		expect(eq(serialReport.texts, parallelReport.texts));
+		expect(lt(serialReport.items, serial.items));
+	};
+};
@@ -0,0 +1,140 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "io/iomapsnapshot.hpp"
+#include "map/mapcache.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	std::shared_ptr<BasicItem> makeItem(uint16_t id, const std::string &text = "") {
+		const auto item = std::make_shared<BasicItem>();
+		item->id = id;
+		item->text = text;
+		return item;
+	}
+
+	IOMapSnapshot::Contents makeContents(MapCache &cache) {
+		const auto shared = makeItem(100);
+		const auto container = makeItem(200, "a letter");
+		container->charges = 3;
+		container->items = { shared, makeItem(101) };
+		const auto teleport = makeItem(300);
+		teleport->destX = 1000;
+		teleport->destY = 1001;
+		teleport->destZ = 7;
+
+		const auto tile = std::make_shared<BasicTile>();
+		tile->ground = shared;
+		tile->items = { container, teleport };
+		tile->flags = 4;
+
+		const auto house = std::make_shared<BasicTile>();
+		house->houseId = 42;
+
+		IOMapSnapshot::Contents contents;
+		contents.width = 2048;
+		contents.height = 1024;
+		contents.monsterFile = "world-monster.xml";
+		contents.houseFile = "world-house.xml";
+		contents.tiles = { { Position(100, 100, 7), cache.cacheBasicTile(tile) }, { Position(101, 100, 7), cache.cacheBasicTile(tile) }, { Position(102, 100, 7), cache.cacheBasicTile(house) } };
+		contents.zones = { { Position(100, 100, 7), 5 } };
+		contents.towns = { { 1, "Thais", Position(32369, 32241, 7) } };
+		contents.waypoints = { { "temple", Position(32369, 32241, 7) } };
+		return contents;
+	}
+
+	std::filesystem::path snapshotPath(const std::string &name) {
+		return std::filesystem::temp_directory_path() / fmt::format("canary_{}_{}.snapshot", name, std::random_device {}());
+	}
+}
+
+suite<"io"> iomapSnapshotTest = [] {
+	const std::vector<uint8_t> map = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+	const auto key = IOMapSnapshot::makeKey(map.data(), map.size(), Position());
+
+	test("IOMapSnapshot keeps what was saved") = [&key] {
+		const auto path = snapshotPath("roundtrip");
+		MapCache cache;
+		const auto saved = makeContents(cache);
+		expect(IOMapSnapshot::save(path, key, cache, saved));
+
+		MapCache loadedCache;
+		IOMapSnapshot::Contents loaded;
+		expect(IOMapSnapshot::load(path, key, loadedCache, loaded));
+		std::filesystem::remove(path);
+
+		expect(eq(loaded.width, saved.width));
+		expect(eq(loaded.height, saved.height));
+		expect(eq(loaded.monsterFile, saved.monsterFile));
+		expect(loaded.npcFile.empty());
+		expect(eq(loaded.houseFile, saved.houseFile));
+
+		expect(eq(loaded.tiles.size(), saved.tiles.size()));
+		for (size_t i = 0; i < saved.tiles.size(); ++i) {
+			expect(loaded.tiles[i].first == saved.tiles[i].first);
+		}
+
+		// shared as they were when saved
+		expect(eq(loaded.tiles[0].second, loaded.tiles[1].second));
+		expect(eq(loadedCache.getMemoryReport().tiles, 2u));
+		expect(eq(loadedCache.getMemoryReport().items, 4u));
+
+		const CachedTile &tile = loadedCache.getCachedTile(loaded.tiles[0].second);
+		expect(eq(tile.flags, 4u));
+		expect(eq(loadedCache.getCachedItem(tile.ground).id, 100));
+		const auto items = loadedCache.getCachedItemList(tile.firstItem, tile.itemCount);
+		expect(eq(items.size(), 2u));
+
+		const CachedItem &container = loadedCache.getCachedItem(items[0]);
+		expect(eq(container.charges, 3));
+		expect(eq(loadedCache.getCachedText(container.text), std::string("a letter")));
+		expect(eq(loadedCache.getCachedItemList(container.firstChild, container.childCount)[0], tile.ground));
+		expect(eq(loadedCache.getCachedItem(items[1]).destX, 1000));
+
+		const CachedTile &house = loadedCache.getCachedTile(loaded.tiles[2].second);
+		expect(eq(house.houseId, 42u));
+		expect(house.isEmpty());
+
+		expect(eq(loaded.zones.size(), 1u));
+		expect(eq(loaded.zones[0].second, 5));
+		expect(eq(loaded.towns.size(), 1u));
+		expect(eq(loaded.towns[0].name, std::string("Thais")));
+		expect(loaded.towns[0].templePosition == Position(32369, 32241, 7));
+		expect(eq(loaded.waypoints.size(), 1u));
+		expect(eq(loaded.waypoints[0].first, std::string("temple")));
+	};
+
+	test("IOMapSnapshot ignores images of another map") = [&key, &map] {
+		const auto path = snapshotPath("stale");
+		MapCache cache;
+		expect(IOMapSnapshot::save(path, key, cache, makeContents(cache)));
+
+		auto changed = map;
+		changed[9] ^= 1;
+		MapCache loadedCache;
+		IOMapSnapshot::Contents loaded;
+		expect(!IOMapSnapshot::load(path, IOMapSnapshot::makeKey(changed.data(), changed.size(), Position()), loadedCache, loaded));
+		expect(!IOMapSnapshot::load(path, IOMapSnapshot::makeKey(map.data(), map.size(), Position(0, 0, 1)), loadedCache, loaded));
+		expect(loaded.tiles.empty());
+		expect(eq(loadedCache.getMemoryReport().tiles, 0u));
+		std::filesystem::remove(path);
+
+		expect(!IOMapSnapshot::load(path, key, loadedCache, loaded));
+	};
+
+	test("IOMapSnapshot ignores truncated images") = [&key] {
+		const auto path = snapshotPath("truncated");
+		MapCache cache;
+		expect(IOMapSnapshot::save(path, key, cache, makeContents(cache)));
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+
+		MapCache loadedCache;
+		IOMapSnapshot::Contents loaded;
+		expect(!IOMapSnapshot::load(path, key, loadedCache, loaded));
+		expect(loaded.tiles.empty());
+		expect(eq(loadedCache.getMemoryReport().items, 0u));
+		std::filesystem::remove(path);
+	};
+};
@@ -0,0 +1,74 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "lib/thread/segmented_queue.hpp"
+
+using namespace boost::ut;
+
+suite<"lib"> segmentedQueueTest = [] {
+	test("SegmentedQueue consumes in push order across segments") = [] {
+		SegmentedQueue<int, 4> queue;
+		for (int i = 0; i < 10; ++i) {
+			queue.emplace(i);
+		}
+
+		std::vector<int> consumed;
+		expect(eq(queue.consume([&consumed](int &&value) { consumed.emplace_back(value); }), 10));
+		expect(eq(consumed, std::vector { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }));
+		expect(queue.empty());
+
+		queue.emplace(10);
+		expect(eq(queue.consume([&consumed](int &&value) { consumed.emplace_back(value); }), 1));
+		expect(eq(consumed.back(), 10));
+	};
+
+	test("SegmentedQueue keeps the order of every producer under contention") = [] {
+		constexpr size_t producers = 8;
+		constexpr uint32_t itemsPerProducer = 200000;
+
+		struct Item {
+			uint32_t producer;
+			uint32_t sequence;
+		};
+
+		// one queue per producer thread, as the dispatcher does, drained by a single consumer
+		std::array<SegmentedQueue<Item, 64>, producers> queues;
+		std::array<uint32_t, producers> expected {};
+		std::atomic_size_t finished = 0;
+		bool ordered = true;
+		size_t total = 0;
+
+		{
+			std::vector<std::jthread> threads;
+			for (uint32_t producer = 0; producer < producers; ++producer) {
+				threads.emplace_back([&queues, &finished, producer] {
+					for (uint32_t sequence = 0; sequence < itemsPerProducer; ++sequence) {
+						queues[producer].emplace(producer, sequence);
+					}
+					finished.fetch_add(1);
+				});
+			}
+
+			auto drain = [&] {
+				for (auto &queue : queues) {
+					total += queue.consume([&](Item &&item) {
+						ordered = ordered && item.sequence == expected[item.producer];
+						++expected[item.producer];
+					});
+				}
+			};
+
+			while (finished.load() != producers) {
+				drain();
+			}
+			drain();
+		}
+
+		expect(ordered);
+		expect(eq(total, producers * itemsPerProducer));
+		for (const auto count : expected) {
+			expect(eq(count, itemsPerProducer));
+		}
+	};
+};
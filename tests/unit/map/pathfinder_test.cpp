@@ -0,0 +1,84 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/utils/pathfinder.hpp"
+
+using namespace boost::ut;
+
+suite<"map"> pathfinderTest = [] {
+	using Request = FollowPathRequests::Request;
+	using Result = FollowPathRequests::Result;
+
+	const auto makeRequest = [](uint16_t targetX) {
+		Request request;
+		request.startPos = Position(1000, 1000, 7);
+		request.targetPos = Position(targetX, 1005, 7);
+		request.targetId = 0x40000001;
+		request.fpp.maxSearchDist = 12;
+		return request;
+	};
+
+	test("FollowPathRequests coalesces the same request into the running search") = [&] {
+		FollowPathRequests requests;
+		expect(requests.add(1, makeRequest(1005), nullptr) == Result::Submit);
+		expect(requests.add(1, makeRequest(1005), nullptr) == Result::Coalesced);
+		expect(requests.contains(1));
+		expect(eq(requests.size(), 1u));
+
+		const auto finished = requests.finish(1);
+		expect(!finished.rerun);
+		expect(!finished.onComplete);
+		expect(!requests.contains(1));
+	};
+
+	test("FollowPathRequests reruns a search superseded while running") = [&] {
+		FollowPathRequests requests;
+		expect(requests.add(1, makeRequest(1005), nullptr) == Result::Submit);
+		expect(requests.add(1, makeRequest(1006), nullptr) == Result::Superseded);
+		// the rerun is owed whatever arrives after
+		expect(requests.add(1, makeRequest(1005), nullptr) == Result::Superseded);
+		expect(requests.finish(1).rerun);
+
+		expect(requests.add(1, makeRequest(1006), nullptr) == Result::Submit);
+		expect(!requests.finish(1).rerun);
+	};
+
+	test("FollowPathRequests keeps the searches of creatures apart") = [&] {
+		FollowPathRequests requests;
+		expect(requests.add(1, makeRequest(1005), nullptr) == Result::Submit);
+		expect(requests.add(2, makeRequest(1006), nullptr) == Result::Submit);
+		expect(eq(requests.size(), 2u));
+
+		expect(!requests.finish(2).rerun);
+		expect(requests.contains(1));
+		expect(eq(requests.size(), 1u));
+	};
+
+	test("FollowPathRequests runs every waiting callback once") = [&] {
+		FollowPathRequests requests;
+		int calls = 0;
+		const auto callback = [&calls] { ++calls; };
+		expect(requests.add(1, makeRequest(1005), callback) == Result::Submit);
+		expect(requests.add(1, makeRequest(1005), callback) == Result::Coalesced);
+		expect(requests.add(1, makeRequest(1006), callback) == Result::Superseded);
+
+		auto finished = requests.finish(1);
+		expect(eq(calls, 0));
+		expect(static_cast<bool>(finished.onComplete));
+		finished.onComplete();
+		expect(eq(calls, 3));
+
+		// nothing is left to run for the next search
+		expect(requests.add(1, makeRequest(1005), nullptr) == Result::Submit);
+		expect(!requests.finish(1).onComplete);
+	};
+
+	test("FollowPathRequests finishes nothing without a search") = [] {
+		FollowPathRequests requests;
+		const auto finished = requests.finish(1);
+		expect(!finished.rerun);
+		expect(!finished.onComplete);
+		expect(eq(requests.size(), 0u));
+	};
+};
@@ -0,0 +1,147 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "map/utils/sector_activity.hpp"
+#include "game/movement/position.hpp"
+
+using namespace boost::ut;
+
+suite<"map"> sectorActivityTest = [] {
+	// as far as a player keeps sectors awake, from the start of its own sector
+	constexpr int32_t range = (SectorActivity::WAKE_RANGE + 1) * FLOOR_SIZE;
+
+	test("SectorActivity keeps the sectors around players awake") = [] {
+		SectorActivity activity;
+		int first = 0;
+		int second = 0;
+		const Position pos(1000, 1000, 7);
+		expect(activity.isDormant(pos));
+
+		activity.addPlayer(&first, pos);
+		expect(!activity.isDormant(pos));
+		expect(!activity.isDormant(Position(1000 + MAP_MAX_VIEW_PORT_X, 1000 - MAP_MAX_VIEW_PORT_Y, 5)));
+		expect(activity.isDormant(Position(1000 + range, 1000, 7)));
+
+		activity.addPlayer(&second, pos);
+		activity.removePlayer(&first);
+		expect(!activity.isDormant(pos));
+		activity.removePlayer(&second);
+		expect(activity.isDormant(pos));
+		expect(eq(activity.getStats().awakeSectors, 0u));
+	};
+
+	test("SectorActivity removes a player once") = [] {
+		SectorActivity activity;
+		int first = 0;
+		int second = 0;
+		const Position pos(1000, 1000, 7);
+		activity.addPlayer(&first, pos);
+		activity.addPlayer(&second, pos);
+
+		// a dead player leaves the map on despawn and again when it is removed from the game
+		activity.removePlayer(&first);
+		activity.removePlayer(&first);
+		expect(!activity.isDormant(pos));
+
+		activity.removePlayer(&second);
+		expect(activity.isDormant(pos));
+		expect(eq(activity.getStats().awakeSectors, 0u));
+
+		// placed again somewhere else without having been removed
+		activity.addPlayer(&first, pos);
+		activity.addPlayer(&first, Position(1000 + 4 * range, 1000, 7));
+		expect(activity.isDormant(pos));
+		activity.removePlayer(&first);
+		expect(eq(activity.getStats().awakeSectors, 0u));
+	};
+
+	test("SectorActivity follows moving players") = [] {
+		SectorActivity activity;
+		int player = 0;
+		Position pos(1000, 1000, 7);
+		activity.addPlayer(&player, pos);
+		const auto awake = activity.getStats().awakeSectors;
+
+		for (int i = 0; i < 100; ++i) {
+			const Position next(pos.x + 1, pos.y, pos.z);
+			activity.movePlayer(&player, next);
+			pos = next;
+		}
+		expect(eq(activity.getStats().awakeSectors, awake));
+		expect(!activity.isDormant(pos));
+		expect(activity.isDormant(Position(1000 - range + FLOOR_SIZE, 1000, 7)));
+	};
+
+	test("SectorActivity wakes sleepers once a player comes close") = [] {
+		SectorActivity activity;
+		const Position spawn(2000, 2000, 7);
+		int woken = 0;
+		activity.sleep(spawn, 0, &woken, [&woken] { ++woken; });
+		// sleeping again replaces the callback
+		activity.sleep(spawn, 0, &woken, [&woken] { ++woken; });
+		expect(eq(activity.getStats().sleepers, 1u));
+
+		int player = 0;
+		Position pos(2000 + 4 * range, 2000, 7);
+		activity.addPlayer(&player, pos);
+		expect(eq(woken, 0));
+
+		while (pos.x > spawn.x) {
+			const Position next(pos.x - 1, pos.y, pos.z);
+			activity.movePlayer(&player, next);
+			pos = next;
+		}
+		expect(eq(woken, 1));
+		expect(eq(activity.getStats().sleepers, 0u));
+
+		// already awake, woken right away
+		activity.sleep(spawn, 0, &woken, [&woken] { ++woken; });
+		expect(eq(woken, 2));
+	};
+
+	test("SectorActivity cancel forgets the sleeper") = [] {
+		SectorActivity activity;
+		const Position spawn(3000, 3000, 7);
+		bool woken = false;
+		activity.sleep(spawn, 0, &woken, [&woken] { woken = true; });
+		activity.cancel(&woken);
+
+		int player = 0;
+		activity.addPlayer(&player, spawn);
+		expect(!woken);
+		expect(eq(activity.getStats().sleepers, 0u));
+	};
+
+	test("SectorActivity wakes a large area as soon as a player comes close to its edge") = [] {
+		SectorActivity activity;
+		const Position spawn(5000, 5000, 7);
+		constexpr int32_t radius = 40;
+		int woken = 0;
+		activity.sleep(spawn, radius, &woken, [&woken] { ++woken; });
+		expect(activity.isDormant(spawn, radius));
+
+		int player = 0;
+		Position pos(spawn.x + radius + 4 * range, spawn.y, spawn.z);
+		activity.addPlayer(&player, pos);
+		while (woken == 0 && pos.x > spawn.x) {
+			const Position next(pos.x - 1, pos.y, pos.z);
+			activity.movePlayer(&player, next);
+			pos = next;
+		}
+
+		// woken by the edge of the area, while its center is still out of range
+		expect(eq(woken, 1));
+		expect(!activity.isDormant(spawn, radius));
+		expect(activity.isDormant(spawn));
+		expect(eq(activity.getStats().sleepers, 0u));
+
+		// and woken only once, from whichever sector woke first
+		while (pos.x > spawn.x) {
+			const Position next(pos.x - 1, pos.y, pos.z);
+			activity.movePlayer(&player, next);
+			pos = next;
+		}
+		expect(eq(woken, 1));
+	};
+};
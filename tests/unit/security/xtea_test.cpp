@@ -0,0 +1,84 @@
+/**
+ * Canary - A free and open-source MMORPG server emulator
+ * Copyright (©) 2019-2023 OpenTibiaBR <opentibiabr@outlook.com>
+ * Repository: https://github.com/opentibiabr/canary
+ * License: https://github.com/opentibiabr/canary/blob/main/LICENSE
+ * Contributors: https://github.com/opentibiabr/canary/graphs/contributors
+ * Website: https://docs.opentibiabr.com/
+ */
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "security/xtea.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr xtea::Key testKey = { 0x01234567, 0x89ABCDEF, 0xFEDCBA98, 0x76543210 };
+
+	constexpr std::array<xtea::Implementation, 3> implementations = {
+		xtea::Implementation::Scalar,
+		xtea::Implementation::SSE2,
+		xtea::Implementation::AVX2,
+	};
+
+	std::vector<uint8_t> makeData(size_t length) {
+		std::mt19937 random { static_cast<uint32_t>(length) };
+		std::vector<uint8_t> data(length);
+		for (auto &byte : data) {
+			byte = static_cast<uint8_t>(random());
+		}
+		return data;
+	}
+}
+
+suite<"security"> xteaTest = [] {
+	test("xtea encrypts a block as the reference implementation") = [] {
+		// reference XTEA with the same key schedule and little-endian words
+		std::array<uint32_t, 2> expected = { 0x03020100, 0x07060504 };
+		uint32_t sum = 0;
+		for (int i = 0; i < 32; ++i) {
+			expected[0] += ((expected[1] << 4 ^ expected[1] >> 5) + expected[1]) ^ (sum + testKey[sum & 3]);
+			sum += 0x9E3779B9;
+			expected[1] += ((expected[0] << 4 ^ expected[0] >> 5) + expected[0]) ^ (sum + testKey[(sum >> 11) & 3]);
+		}
+
+		std::array<uint8_t, 8> block = { 0, 1, 2, 3, 4, 5, 6, 7 };
+		xtea::encrypt(block.data(), block.size(), xtea::expandEncryptKey(testKey), xtea::Implementation::Scalar);
+
+		std::array<uint32_t, 2> result;
+		memcpy(result.data(), block.data(), block.size());
+		expect(eq(expected[0], result[0]) and eq(expected[1], result[1]));
+	};
+
+	test("xtea implementations are bit-exact with the scalar one") = [] {
+		const auto encryptKeys = xtea::expandEncryptKey(testKey);
+		const auto decryptKeys = xtea::expandDecryptKey(testKey);
+
+		// every tail size of the 8 and 16 block kernels, and a full packet
+		for (const size_t length : { 0, 8, 24, 32, 56, 64, 72, 120, 128, 136, 248, 1024, 24592 }) {
+			const auto plain = makeData(length);
+			auto expected = plain;
+			xtea::encrypt(expected.data(), expected.size(), encryptKeys, xtea::Implementation::Scalar);
+
+			for (const auto implementation : implementations) {
+				if (!xtea::isSupported(implementation)) {
+					continue;
+				}
+
+				auto data = plain;
+				xtea::encrypt(data.data(), data.size(), encryptKeys, implementation);
+				expect(data == expected) << xtea::getImplementationName(implementation) << "encrypt" << length;
+
+				xtea::decrypt(data.data(), data.size(), decryptKeys, implementation);
+				expect(data == plain) << xtea::getImplementationName(implementation) << "decrypt" << length;
+			}
+		}
+	};
+
+	test("xtea picks a supported implementation") = [] {
+		expect(xtea::isSupported(xtea::Implementation::Scalar));
+		expect(xtea::isSupported(xtea::getImplementation()));
+	};
+};
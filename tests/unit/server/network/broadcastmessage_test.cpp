@@ -0,0 +1,49 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/message/broadcastmessage.hpp"
+
+using namespace boost::ut;
+
+suite<"server"> broadcastMessageTest = [] {
+	test("BroadcastMessage serializes once per protocol version and shares the result") = [] {
+		BroadcastMessage::resetStats();
+		size_t calls = 0;
+		BroadcastMessage message([&calls](NetworkMessage &msg, bool oldProtocol) {
+			++calls;
+			msg.addByte(0x83);
+			msg.addByte(oldProtocol ? 0x01 : 0x02);
+		});
+
+		const auto first = message.get(false);
+		const auto second = message.get(false);
+		const auto old = message.get(true);
+
+		expect(eq(calls, 2u));
+		expect(first != nullptr and first == second);
+		expect(old != nullptr and old != first);
+		expect(eq(first->getLength(), 2));
+		expect(eq(first->getBuffer()[NetworkMessage::INITIAL_BUFFER_POSITION + 1], 0x02));
+		expect(eq(old->getBuffer()[NetworkMessage::INITIAL_BUFFER_POSITION + 1], 0x01));
+
+		const auto stats = BroadcastMessage::getStats();
+		expect(eq(stats.serialized, 2u));
+		expect(eq(stats.sent, 3u));
+	};
+
+	test("BroadcastMessage has nothing to send for a version without the packet") = [] {
+		size_t calls = 0;
+		BroadcastMessage message([&calls](NetworkMessage &msg, bool oldProtocol) {
+			++calls;
+			if (!oldProtocol) {
+				msg.addByte(0x84);
+			}
+		});
+
+		expect(message.get(true) == nullptr);
+		expect(message.get(true) == nullptr);
+		expect(message.get(false) != nullptr);
+		expect(eq(calls, 2u));
+	};
+};
@@ -0,0 +1,85 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/protocol/known_creatures.hpp"
+
+using namespace boost::ut;
+
+suite<"server"> knownCreaturesTest = [] {
+	test("KnownCreatures evicts the least recently used creature") = [] {
+		KnownCreatures known(3);
+		uint32_t removed = 0;
+		const auto anyone = [](uint32_t) { return true; };
+
+		expect(not known.add(1, removed, anyone));
+		expect(not known.add(2, removed, anyone));
+		expect(not known.add(3, removed, anyone));
+		expect(eq(removed, 0u));
+
+		// sending 1 again makes 2 the oldest one
+		expect(known.add(1, removed, anyone));
+		expect(not known.add(4, removed, anyone));
+		expect(eq(removed, 2u));
+		expect(eq(known.size(), 3u));
+		expect(not known.contains(2));
+		expect(known.contains(1) and known.contains(3) and known.contains(4));
+	};
+
+	test("KnownCreatures skips the creatures that cannot be evicted") = [] {
+		KnownCreatures::resetStats();
+		KnownCreatures known(3);
+		uint32_t removed = 0;
+		const auto anyone = [](uint32_t) { return true; };
+		known.add(1, removed, anyone);
+		known.add(2, removed, anyone);
+		known.add(3, removed, anyone);
+
+		expect(not known.add(4, removed, [](uint32_t id) { return id != 1; }));
+		expect(eq(removed, 2u));
+
+		// nobody can be evicted, the oldest one goes anyway so the client stays in sync
+		expect(not known.add(5, removed, [](uint32_t) { return false; }));
+		expect(eq(removed, 1u));
+		expect(eq(known.size(), 3u));
+
+		const auto stats = KnownCreatures::getStats();
+		expect(eq(stats.added, 5u));
+		expect(eq(stats.evictions, 2u));
+		expect(eq(stats.evictionChecks, 5u));
+		expect(eq(stats.forcedEvictions, 1u));
+	};
+
+	test("KnownCreatures keeps the client list in sync") = [] {
+		// replays what the client does with each creature sent: it adds the unknown ones and
+		// drops the one the server says was removed, the lists must never differ
+		KnownCreatures known;
+		std::set<uint32_t> client;
+		std::mt19937 random { 42 };
+		for (size_t i = 0; i < 100000; ++i) {
+			const uint32_t id = 0x10000000 + random() % 4000;
+			const bool wasKnown = client.contains(id);
+
+			uint32_t removed = 0;
+			const bool isKnown = known.add(id, removed, [](uint32_t knownId) { return knownId % 3 != 0; });
+			expect(eq(isKnown, wasKnown));
+			if (isKnown) {
+				expect(eq(removed, 0u));
+				continue;
+			}
+
+			client.insert(id);
+			if (removed != 0) {
+				expect(neq(removed, id));
+				expect(eq(client.erase(removed), 1u));
+			}
+
+			expect(le(client.size(), KnownCreatures::CLIENT_CAPACITY));
+			expect(eq(known.size(), client.size()));
+		}
+
+		for (const auto id : client) {
+			expect(known.contains(id));
+		}
+	};
+};
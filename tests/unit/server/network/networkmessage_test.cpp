@@ -0,0 +1,67 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/message/networkmessage.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// without growing it, as the non const getBuffer would
+	const uint8_t* bufferOf(const NetworkMessage &msg) {
+		return msg.getBuffer();
+	}
+
+	std::string readBack(NetworkMessage &msg) {
+		msg.setBufferPosition(NetworkMessage::INITIAL_BUFFER_POSITION);
+		return msg.getString();
+	}
+}
+
+suite<"server"> networkMessageTest = [] {
+	test("NetworkMessage moves a message that fits its inline buffer") = [] {
+		NetworkMessage msg;
+		msg.addString("inline");
+		const auto length = msg.getLength();
+
+		NetworkMessage moved(std::move(msg));
+		expect(eq(moved.getLength(), length));
+		expect(eq(readBack(moved), std::string("inline")));
+		expect(eq(msg.getLength(), 0));
+		expect(eq(msg.getBufferPosition(), NetworkMessage::INITIAL_BUFFER_POSITION));
+	};
+
+	test("NetworkMessage moves the full size buffer instead of copying it") = [] {
+		const std::string text(NetworkMessage::INLINE_BUFFER_SIZE * 2, 'x');
+		NetworkMessage msg;
+		msg.addString(text);
+		const auto* buffer = bufferOf(msg);
+
+		NetworkMessage moved(std::move(msg));
+		expect(bufferOf(moved) == buffer);
+		expect(eq(readBack(moved), text));
+
+		// the message moved from is empty and usable again
+		expect(bufferOf(msg) != buffer);
+		msg.addString("again");
+		expect(eq(readBack(msg), std::string("again")));
+	};
+
+	test("NetworkMessage move assignment gives its own buffer up") = [] {
+		const std::string text(NetworkMessage::INLINE_BUFFER_SIZE * 2, 'y');
+		NetworkMessage large;
+		large.addString(text);
+		NetworkMessage small;
+		small.addString("small");
+
+		large = std::move(small);
+		expect(eq(readBack(large), std::string("small")));
+
+		NetworkMessage other;
+		other.addString(text);
+		const auto* buffer = bufferOf(other);
+		small = std::move(other);
+		expect(bufferOf(small) == buffer);
+		expect(eq(readBack(small), text));
+	};
+};
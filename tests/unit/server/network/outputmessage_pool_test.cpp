@@ -0,0 +1,77 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/message/outputmessage.hpp"
+
+using namespace boost::ut;
+
+suite<"server"> outputMessagePoolTest = [] {
+	test("OutputMessagePool hands a released message back, reset") = [] {
+		auto msg = OutputMessagePool::getOutputMessage();
+		msg->addByte(0x64);
+		msg->addCryptoHeader(true, 0x12345678);
+		const auto* released = msg.get();
+		msg.reset();
+
+		const auto before = OutputMessagePool::getStats();
+		auto reused = OutputMessagePool::getOutputMessage();
+		const auto after = OutputMessagePool::getStats();
+
+		expect(reused.get() == released);
+		expect(eq(reused->getLength(), 0));
+		expect(eq(reused->getBufferPosition(), NetworkMessage::INITIAL_BUFFER_POSITION));
+		expect(reused->getOutputBuffer() == reused->getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION);
+		expect(eq(after.hits, before.hits + 1));
+		expect(eq(after.misses, before.misses));
+	};
+
+	test("OutputMessagePool tracks the messages in use and keeps at most its cap idle") = [] {
+		OutputMessagePool::resetStats();
+		const auto initial = OutputMessagePool::getStats();
+
+		std::vector<OutputMessage_ptr> messages;
+		for (size_t i = 0; i < OutputMessagePool::MAX_RETAINED_MESSAGES + 64; ++i) {
+			messages.emplace_back(OutputMessagePool::getOutputMessage());
+		}
+
+		const auto busy = OutputMessagePool::getStats();
+		expect(eq(busy.inUse, initial.inUse + messages.size()));
+		expect(busy.highWater >= busy.inUse);
+		expect(eq(busy.retained, 0));
+
+		messages.clear();
+		const auto idle = OutputMessagePool::getStats();
+		expect(eq(idle.inUse, initial.inUse));
+		expect(eq(idle.retained, OutputMessagePool::MAX_RETAINED_MESSAGES));
+	};
+
+	test("OutputMessagePool leaves the free list to the other threads") = [] {
+		std::vector<OutputMessage_ptr> messages;
+		for (size_t i = 0; i < OutputMessagePool::MAX_RETAINED_MESSAGES; ++i) {
+			messages.emplace_back(OutputMessagePool::getOutputMessage());
+		}
+		// past the cache of this thread, the rest goes to the free list
+		messages.clear();
+
+		// each thread takes a batch and frees it on exit, the next one still finds messages
+		for (int i = 0; i < 2; ++i) {
+			std::thread([] {
+				const auto before = OutputMessagePool::getStats();
+				const auto msg = OutputMessagePool::getOutputMessage();
+				expect(eq(OutputMessagePool::getStats().hits, before.hits + 1));
+			}).join();
+		}
+	};
+
+	test("OutputMessagePool takes back a message released after the cache of its thread") = [] {
+		const auto before = OutputMessagePool::getStats();
+		std::thread([] {
+			// constructed before the cache of the thread, so it is destroyed after it
+			thread_local OutputMessage_ptr late;
+			late = OutputMessagePool::getOutputMessage();
+		}).join();
+
+		expect(eq(OutputMessagePool::getStats().inUse, before.inUse));
+	};
+};
@@ -0,0 +1,75 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "server/network/protocol/packet_compressor.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	// what the client does: raw inflate of the whole packet
+	std::vector<uint8_t> inflateRaw(std::span<const uint8_t> compressed, size_t expectedSize) {
+		std::vector<uint8_t> out(expectedSize + 1);
+		z_stream stream {};
+		if (inflateInit2(&stream, -15) != Z_OK) {
+			return {};
+		}
+
+		stream.next_in = const_cast<uint8_t*>(compressed.data());
+		stream.avail_in = static_cast<uInt>(compressed.size());
+		stream.next_out = out.data();
+		stream.avail_out = static_cast<uInt>(out.size());
+		const auto ret = inflate(&stream, Z_FINISH);
+		out.resize(stream.total_out);
+		inflateEnd(&stream);
+		return ret == Z_STREAM_END ? out : std::vector<uint8_t> {};
+	}
+
+	std::vector<uint8_t> makePacket(size_t size) {
+		// repeated tile descriptions, as in a map packet
+		std::vector<uint8_t> packet(size);
+		for (size_t i = 0; i < size; ++i) {
+			packet[i] = static_cast<uint8_t>((i % 12) * 7 + (i / 480));
+		}
+		return packet;
+	}
+}
+
+suite<"server"> packetCompressorTest = [] {
+	test("PacketCompressor output inflates back to the packet") = [] {
+		for (const int32_t level : { 1, 6, 9 }) {
+			PacketCompressor compressor(level);
+			expect(compressor.isEnabled() >> fatal);
+
+			for (const size_t size : { 128, 1024, 24590 }) {
+				const auto packet = makePacket(size);
+				const auto compressed = compressor.compress(packet.data(), packet.size());
+				expect(!compressed.empty() and compressed.size() < packet.size()) << level << size;
+				expect(inflateRaw(compressed, packet.size()) == packet) << level << size;
+			}
+		}
+	};
+
+	test("PacketCompressor gives up on data that does not get smaller") = [] {
+		PacketCompressor compressor(6);
+		std::mt19937 random { 3 };
+		std::vector<uint8_t> packet(4096);
+		for (auto &byte : packet) {
+			byte = static_cast<uint8_t>(random());
+		}
+
+		expect(compressor.compress(packet.data(), packet.size()).empty());
+
+		// and is still usable after that
+		const auto compressible = makePacket(4096);
+		const auto compressed = compressor.compress(compressible.data(), compressible.size());
+		expect(inflateRaw(compressed, compressible.size()) == compressible);
+	};
+
+	test("PacketCompressor is disabled at level 0") = [] {
+		PacketCompressor compressor(0);
+		const auto packet = makePacket(1024);
+		expect(!compressor.isEnabled());
+		expect(compressor.compress(packet.data(), packet.size()).empty());
+	};
+};
@@ -0,0 +1,193 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "items/scoped_item_types.hpp"
+#include "items/tile.hpp"
+#include "server/network/message/networkmessage.hpp"
+#include "server/network/protocol/tile_description_cache.hpp"
+
+using namespace boost::ut;
+
+namespace {
+	constexpr uint16_t GROUND_ID = 101;
+	constexpr uint16_t STACKABLE_ID = 102;
+	constexpr uint16_t FLUID_ID = 103;
+	constexpr uint16_t TIMER_ID = 104;
+
+	// what the description holds of an item, enough to tell its id and subtype apart
+	void addItem(NetworkMessage &msg, const std::shared_ptr<Item> &item) {
+		msg.add<uint16_t>(item->getID());
+		msg.addByte(static_cast<uint8_t>(item->getSubType()));
+	}
+
+	struct ItemTypes {
+		ItemTypes() {
+			auto &ground = types.add(GROUND_ID);
+			ground.name = "ground";
+			ground.group = ITEM_GROUP_GROUND;
+
+			auto &stackable = types.add(STACKABLE_ID);
+			stackable.name = "coins";
+			stackable.stackable = true;
+
+			auto &fluid = types.add(FLUID_ID);
+			fluid.name = "vial";
+			fluid.group = ITEM_GROUP_FLUID;
+
+			auto &timer = types.add(TIMER_ID);
+			timer.name = "timer";
+			timer.wearOut = true;
+		}
+
+		ScopedItemTypes types;
+	};
+
+	std::vector<uint8_t> written(const TileDescriptionCache::Description &description) {
+		NetworkMessage msg;
+		description.addTopItems(msg, TileDescriptionCache::MAX_TILE_ENTRIES);
+		description.addDownItems(msg, TileDescriptionCache::MAX_TILE_ENTRIES);
+		const auto* begin = static_cast<const NetworkMessage &>(msg).getBuffer() + NetworkMessage::INITIAL_BUFFER_POSITION;
+		return { begin, begin + msg.getLength() };
+	}
+}
+
+suite<"server"> tileDescriptionCacheTest = [] {
+	test("Tile items version changes with the items and is unique among tiles") = [] {
+		const auto tile = std::make_shared<StaticTile>(100, 100, 7);
+		const auto otherTile = std::make_shared<StaticTile>(101, 100, 7);
+		expect(eq(tile->getItemsVersion(), 0u));
+
+		tile->setGround(nullptr);
+		const auto version = tile->getItemsVersion();
+		otherTile->setGround(nullptr);
+
+		expect(neq(version, 0u));
+		expect(neq(otherTile->getItemsVersion(), version));
+		tile->setGround(nullptr);
+		expect(neq(tile->getItemsVersion(), version));
+	};
+
+	test("TileDescriptionCache reuses a description until the tile items change") = [] {
+		TileDescriptionCache cache;
+		const auto tile = std::make_shared<StaticTile>(100, 100, 7);
+		size_t calls = 0;
+		const TileDescriptionCache::ItemSerializer addItem = [&calls](NetworkMessage &msg, const std::shared_ptr<Item> &) {
+			++calls;
+			msg.addByte(0x01);
+		};
+
+		const auto* first = cache.get(tile, false, addItem);
+		expect(first != nullptr);
+		expect(cache.get(tile, false, addItem) == first);
+
+		auto stats = cache.getStats();
+		expect(eq(stats.builds, 1u));
+		expect(eq(stats.hits, 1u));
+
+		tile->setGround(nullptr);
+		expect(cache.get(tile, false, addItem) != nullptr);
+		expect(cache.get(tile, true, addItem) != nullptr);
+
+		stats = cache.getStats();
+		expect(eq(stats.builds, 3u));
+		expect(eq(stats.hits, 1u));
+		expect(eq(stats.descriptions, 2u));
+
+		// an empty tile has nothing to serialize or write
+		const auto* description = cache.get(tile, false, addItem);
+		NetworkMessage msg;
+		expect(eq(description->addTopItems(msg, 10), 0u));
+		description->addDownItems(msg, 10);
+		expect(eq(msg.getLength(), 0));
+		expect(eq(calls, 0u));
+
+		cache.clear();
+		cache.resetStats();
+		stats = cache.getStats();
+		expect(eq(stats.descriptions, 0u));
+		expect(eq(stats.hits, 0u));
+	};
+
+	test("TileDescriptionCache keeps no more items than the client reads") = [] {
+		ItemTypes itemTypes;
+		TileDescriptionCache cache;
+		const auto tile = std::make_shared<StaticTile>(100, 100, 7);
+		tile->internalAddThing(Item::CreateItem(GROUND_ID));
+		for (uint16_t count = 1; count <= TileDescriptionCache::MAX_TILE_ENTRIES + 2; ++count) {
+			tile->internalAddThing(Item::CreateItem(STACKABLE_ID, count));
+		}
+
+		const auto* description = cache.get(tile, false, addItem);
+		expect(description != nullptr);
+		expect(eq(description->getTopItemCount(), 1u));
+		expect(eq(description->getDownItemCount(), TileDescriptionCache::MAX_TILE_ENTRIES));
+
+		// 3 bytes an item, and the limits of the viewer still apply
+		expect(eq(written(*description).size(), (1 + TileDescriptionCache::MAX_TILE_ENTRIES) * 3));
+		NetworkMessage msg;
+		expect(eq(description->addTopItems(msg, 0), 0u));
+		description->addDownItems(msg, 2);
+		expect(eq(msg.getLength(), 6));
+	};
+
+	test("TileDescriptionCache writes the items as the serializer did") = [] {
+		ItemTypes itemTypes;
+		TileDescriptionCache cache;
+		const auto tile = std::make_shared<StaticTile>(100, 100, 7);
+		tile->internalAddThing(Item::CreateItem(GROUND_ID));
+		tile->internalAddThing(Item::CreateItem(STACKABLE_ID, 25));
+
+		const auto* description = cache.get(tile, false, addItem);
+		expect(eq(written(*description), std::vector<uint8_t> { GROUND_ID & 0xFF, GROUND_ID >> 8, 1, STACKABLE_ID & 0xFF, STACKABLE_ID >> 8, 25 }));
+
+		// a new item changes the version of the tile
+		tile->internalAddThing(Item::CreateItem(STACKABLE_ID, 5));
+		description = cache.get(tile, false, addItem);
+		expect(eq(description->getDownItemCount(), 2u));
+		expect(eq(cache.getStats().builds, 2u));
+	};
+
+	test("TileDescriptionCache rebuilds after an item changed without the tile") = [] {
+		ItemTypes itemTypes;
+		TileDescriptionCache cache;
+		const auto tile = std::make_shared<StaticTile>(100, 100, 7);
+		const auto vial = Item::CreateItem(FLUID_ID, FLUID_WATER);
+		const auto coins = Item::CreateItem(STACKABLE_ID, 10);
+		tile->internalAddThing(vial);
+		tile->internalAddThing(coins);
+
+		const auto before = written(*cache.get(tile, false, addItem));
+
+		// as a script or a split stack changes them
+		vial->setSubType(FLUID_BLOOD);
+		auto after = written(*cache.get(tile, false, addItem));
+		expect(before != after);
+		expect(eq(cache.getStats().builds, 2u));
+
+		coins->setSubType(3);
+		after = written(*cache.get(tile, false, addItem));
+		expect(eq(cache.getStats().builds, 3u));
+
+		// what item:setAttribute does
+		vial->setAttribute(ItemAttribute_t::FLUIDTYPE, FLUID_WATER);
+		vial->updateTileFlags();
+		expect(written(*cache.get(tile, false, addItem)) != after);
+		expect(eq(cache.getStats().builds, 4u));
+		expect(eq(cache.getStats().hits, 0u));
+	};
+
+	test("TileDescriptionCache does not cache tiles with items that change on their own") = [] {
+		ItemTypes itemTypes;
+		TileDescriptionCache cache;
+		const auto tile = std::make_shared<StaticTile>(100, 100, 7);
+		tile->internalAddThing(Item::CreateItem(GROUND_ID));
+		tile->internalAddThing(Item::CreateItem(TIMER_ID));
+
+		expect(cache.get(tile, false, addItem) == nullptr);
+		expect(cache.get(tile, false, addItem) == nullptr);
+		const auto stats = cache.getStats();
+		expect(eq(stats.uncacheable, 2u));
+		expect(eq(stats.hits, 0u));
+	};
+};
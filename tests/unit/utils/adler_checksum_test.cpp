@@ -0,0 +1,35 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/tools.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> adlerChecksumTest = [] {
+	test("adlerChecksum matches zlib adler32 for every length and tail") = [] {
+		std::mt19937 random { 7 };
+		std::vector<uint8_t> data(NETWORKMESSAGE_MAXSIZE);
+		for (auto &byte : data) {
+			byte = static_cast<uint8_t>(random());
+		}
+
+		// short lengths cover every vector tail, the long ones cross several modulo blocks
+		for (size_t length = 0; length <= 300; ++length) {
+			expect(eq(adlerChecksum(data.data(), length), static_cast<uint32_t>(adler32(1, data.data(), length)))) << length;
+		}
+		for (const size_t length : { 5535, 5536, 5537, 5552, 11072, 24590, 65500 }) {
+			expect(eq(adlerChecksum(data.data(), length), static_cast<uint32_t>(adler32(1, data.data(), length)))) << length;
+		}
+	};
+
+	test("adlerChecksum does not overflow on a full block of 0xFF") = [] {
+		const std::vector<uint8_t> data(NETWORKMESSAGE_MAXSIZE, 0xFF);
+		expect(eq(adlerChecksum(data.data(), data.size()), static_cast<uint32_t>(adler32(1, data.data(), data.size()))));
+	};
+
+	test("adlerChecksum rejects data bigger than a network message") = [] {
+		const std::vector<uint8_t> data(NETWORKMESSAGE_MAXSIZE + 1);
+		expect(eq(adlerChecksum(data.data(), data.size()), 0u));
+	};
+};
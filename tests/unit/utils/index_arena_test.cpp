@@ -0,0 +1,52 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/index_arena.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> indexArenaTest = [] {
+	test("index_arena hands out consecutive indexes") = [] {
+		stdext::index_arena<int, 4> arena;
+		expect(eq(arena.push_back(10), 0u));
+		expect(eq(arena.push_back(11), 1u));
+		expect(eq(arena[0], 10));
+		expect(eq(arena[1], 11));
+		expect(eq(arena.size(), 2u));
+	};
+
+	test("index_arena keeps runs contiguous") = [] {
+		stdext::index_arena<int, 4> arena;
+		arena.allocate(3);
+		// does not fit in what is left of the first block
+		const uint32_t first = arena.allocate(2);
+		expect(eq(first, 4u));
+		arena[first] = 1;
+		arena[first + 1] = 2;
+		const auto run = arena.span(first, 2);
+		expect(eq(run.size(), 2u));
+		expect(eq(run[0], 1));
+		expect(eq(run[1], 2));
+		expect(eq(arena.size(), 5u));
+		expect(arena.span(first, 0).empty());
+	};
+
+	test("index_arena never moves what it holds") = [] {
+		stdext::index_arena<int, 4> arena;
+		const uint32_t index = arena.push_back(7);
+		const int* address = &arena[index];
+		for (int i = 0; i < 100; ++i) {
+			arena.push_back(i);
+		}
+		expect(address == &arena[index]);
+		expect(eq(*address, 7));
+	};
+
+	test("index_arena rejects runs larger than a block") = [] {
+		stdext::index_arena<int, 4> arena;
+		expect(throws([&arena] { arena.allocate(5); }));
+		expect(eq(arena.allocate(0), 0u));
+		expect(arena.empty());
+	};
+};
@@ -0,0 +1,87 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/ring_queue.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> ringQueueTest = [] {
+	test("ring_queue keeps the order across the end of the ring") = [] {
+		stdext::ring_queue<int> queue { 16 };
+		int next = 0;
+		int expected = 0;
+		size_t mismatches = 0;
+
+		// never more than 10 waiting, so the ring stays at its first size and wraps around
+		for (int round = 0; round < 20; ++round) {
+			for (int i = 0; i < 7; ++i) {
+				expect(queue.push(next++));
+			}
+			while (queue.size() > 3) {
+				mismatches += queue.pop() != expected++;
+			}
+		}
+		expect(eq(queue.capacity(), 16u));
+		expect(eq(mismatches, 0u));
+	};
+
+	test("ring_queue grows from a head past the start of the ring") = [] {
+		stdext::ring_queue<int> queue { 64 };
+		for (int i = 0; i < 12; ++i) {
+			queue.push(i);
+		}
+		for (int i = 0; i < 10; ++i) {
+			queue.pop();
+		}
+
+		// the head is at 10, the values wrap and then do not fit anymore
+		for (int i = 12; i < 40; ++i) {
+			queue.push(i);
+		}
+		expect(eq(queue.capacity(), 32u));
+		expect(eq(queue.size(), 30u));
+
+		size_t mismatches = 0;
+		for (int expected = 10; expected < 40; ++expected) {
+			mismatches += queue.pop() != expected;
+		}
+		expect(eq(mismatches, 0u));
+		expect(queue.empty());
+	};
+
+	test("ring_queue refuses values past its bound") = [] {
+		stdext::ring_queue<int> queue { 20 };
+		expect(eq(queue.max_size(), 32u));
+
+		size_t pushed = 0;
+		while (queue.push(static_cast<int>(pushed))) {
+			++pushed;
+		}
+		expect(eq(pushed, 32u));
+		expect(eq(queue.size(), 32u));
+
+		// what it holds is left as it was
+		expect(eq(queue.pop(), 0));
+		expect(queue.push(32));
+		expect(!queue.push(33));
+	};
+
+	test("ring_queue clear releases what it holds") = [] {
+		stdext::ring_queue<std::shared_ptr<int>> queue { 16 };
+		const auto value = std::make_shared<int>(1);
+		queue.push(value);
+		queue.push(value);
+		queue.pop();
+		expect(eq(value.use_count(), 2));
+
+		queue.clear();
+		expect(eq(value.use_count(), 1));
+		expect(queue.empty());
+		expect(eq(queue.capacity(), 0u));
+
+		// and can be used again
+		expect(queue.push(value));
+		expect(eq(*queue.pop(), 1));
+	};
+};
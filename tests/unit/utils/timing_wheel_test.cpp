@@ -0,0 +1,161 @@
+#include "pch.hpp"
+
+#include <boost/ut.hpp>
+
+#include "utils/timing_wheel.hpp"
+
+using namespace boost::ut;
+
+suite<"utils"> timingWheelTest = [] {
+	test("timing_wheel hands out values in expiration order") = [] {
+		stdext::timing_wheel<int> wheel { 50 };
+		wheel.start(1000);
+
+		wheel.schedule(3, 1180);
+		wheel.schedule(1, 1020);
+		wheel.schedule(2, 1020);
+		wheel.schedule(4, 1000 + 50 * 64 * 64 + 7);
+
+		std::vector<int> fired;
+		wheel.advance(1100, [&fired](int value) { fired.emplace_back(value); });
+		expect(eq(fired, std::vector { 1, 2 }));
+
+		wheel.advance(1179, [&fired](int value) { fired.emplace_back(value); });
+		expect(eq(fired.size(), 2));
+
+		wheel.advance(1000 + 50 * 64 * 64 + 7, [&fired](int value) { fired.emplace_back(value); });
+		expect(eq(fired, std::vector { 1, 2, 3, 4 }));
+		expect(wheel.empty());
+	};
+
+	test("timing_wheel cancel releases the slot and rejects stale handles") = [] {
+		stdext::timing_wheel<int> wheel { 50 };
+		wheel.start(0);
+
+		const auto handle = wheel.schedule(1, 500);
+		expect(wheel.cancel(handle));
+		expect(!wheel.cancel(handle));
+
+		const auto reused = wheel.schedule(2, 500);
+		expect(eq(wheel.capacity(), 1));
+		expect(!wheel.cancel(handle));
+		expect(eq(*wheel.get(reused), 2));
+
+		std::vector<int> fired;
+		wheel.advance(500, [&fired](int value) { fired.emplace_back(value); });
+		expect(eq(fired, std::vector { 2 }));
+	};
+
+	test("timing_wheel nextExpiration never passes the earliest value") = [] {
+		stdext::timing_wheel<int> wheel { 50 };
+		wheel.start(0);
+
+		std::mt19937 random { 1337 };
+		std::multiset<int64_t> expected;
+		int64_t now = 0;
+		for (int i = 0; i < 5000; ++i) {
+			const auto expiration = now + static_cast<int64_t>(random() % 500000);
+			wheel.schedule(0, expiration);
+			expected.emplace(expiration);
+
+			if (i % 10 == 0) {
+				expect(le(wheel.nextExpiration(), *expected.begin()));
+				now += random() % 2000;
+				size_t fired = 0;
+				wheel.advance(now, [&fired](int) { ++fired; });
+				const auto end = expected.upper_bound(now);
+				expect(eq(fired, static_cast<size_t>(std::distance(expected.begin(), end))));
+				expected.erase(expected.begin(), end);
+			}
+		}
+	};
+
+	test("timing_wheel restarting a value never trusts its old handle") = [] {
+		// the same protocol as Decay, a handle is only trusted while its slot holds the same item
+		stdext::timing_wheel<std::shared_ptr<int>> wheel { 50 };
+		wheel.start(0);
+
+		const auto first = std::make_shared<int>(1);
+		const auto second = std::make_shared<int>(2);
+
+		const auto started = wheel.schedule(std::shared_ptr<int>(first), 500);
+		expect(wheel.cancel(started));
+
+		// the released slot goes to the next value with a new generation
+		const auto other = wheel.schedule(std::shared_ptr<int>(second), 500);
+		expect(eq(other & 0xFFFFFFFF, started & 0xFFFFFFFF));
+		expect(neq(other, started));
+		expect(wheel.get(started) == nullptr);
+		expect(!wheel.cancel(started));
+
+		const auto restarted = wheel.schedule(std::shared_ptr<int>(first), 800);
+		expect(*wheel.get(restarted) == first);
+		expect(*wheel.get(other) == second);
+		expect(eq(wheel.size(), 2));
+
+		std::vector<int> fired;
+		wheel.advance(800, [&fired](const std::shared_ptr<int> &value) { fired.emplace_back(*value); });
+		expect(eq(fired, std::vector { 2, 1 }));
+		expect(wheel.get(restarted) == nullptr);
+		expect(wheel.empty());
+	};
+
+	test("timing_wheel keeps values due past its horizon") = [] {
+		constexpr int64_t granularity = 50;
+		constexpr int64_t horizon = granularity * 64 * 64 * 64 * 64;
+
+		stdext::timing_wheel<int> wheel { granularity };
+		wheel.start(0);
+
+		// clamped to the last bucket, it waits in the due heap once the wheel reaches it
+		const auto far = horizon + 1234;
+		wheel.schedule(1, far);
+		expect(le(wheel.nextExpiration(), far));
+
+		std::vector<int> fired;
+		wheel.advance(horizon, [&fired](int value) { fired.emplace_back(value); });
+		expect(fired.empty());
+		expect(eq(wheel.size(), 1));
+
+		// a later value due before it still comes first
+		wheel.schedule(2, horizon + 100);
+		wheel.advance(far - 1, [&fired](int value) { fired.emplace_back(value); });
+		expect(eq(fired, std::vector { 2 }));
+		expect(eq(wheel.nextExpiration(), far));
+
+		wheel.advance(far, [&fired](int value) { fired.emplace_back(value); });
+		expect(eq(fired, std::vector { 2, 1 }));
+		expect(wheel.empty());
+	};
+
+	test("timing_wheel drops values canceled before they expire") = [] {
+		stdext::timing_wheel<int> wheel { 50 };
+		wheel.start(1000);
+
+		// one in a level 0 bucket, one in a higher level and one already in the due heap
+		const auto near = wheel.schedule(1, 1200);
+		const auto later = wheel.schedule(2, 1000 + 50 * 64 * 10);
+		const auto due = wheel.schedule(3, 1049);
+
+		std::vector<int> fired;
+		wheel.advance(1020, [&fired](int value) { fired.emplace_back(value); });
+		expect(fired.empty());
+
+		expect(wheel.cancel(near));
+		expect(wheel.cancel(later));
+		expect(wheel.cancel(due));
+		expect(!wheel.cancel(due));
+		expect(wheel.get(due) == nullptr);
+		expect(wheel.empty());
+		expect(eq(wheel.nextExpiration(), std::numeric_limits<int64_t>::max()));
+
+		wheel.advance(1000 + 50 * 64 * 10, [&fired](int value) { fired.emplace_back(value); });
+		expect(fired.empty());
+
+		// the slot left in the due heap is released once it is popped, so nothing grows
+		wheel.schedule(4, 1000 + 50 * 64 * 11);
+		wheel.schedule(5, 1000 + 50 * 64 * 11);
+		wheel.schedule(6, 1000 + 50 * 64 * 11);
+		expect(eq(wheel.capacity(), 3));
+	};
+};